@@ -0,0 +1,151 @@
+﻿using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates the managed counterpart of the native <c>dnne_arena</c>.
+/// </summary>
+/// <remarks>
+/// The generated type calls through an unmanaged function pointer, so it is only
+/// generated when unsafe code is allowed in the consuming project.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class ArenaGenerator : IIncrementalGenerator
+{
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValueProvider<bool> allowUnsafe = context.CompilationProvider
+            .Select(static (compilation, _) => compilation.Options is CSharpCompilationOptions { AllowUnsafe: true });
+
+        context.RegisterSourceOutput(allowUnsafe, static (context, allowUnsafe) =>
+        {
+            if (!allowUnsafe)
+            {
+                return;
+            }
+
+            context.AddSource("DnneArena.g.cs", """
+                // <auto-generated/>
+                #pragma warning disable
+                #if NET5_0_OR_GREATER
+
+                namespace DNNE
+                {
+                    /// <summary>
+                    /// Managed view of a native <c>dnne_arena</c> supplied by the caller of an export.
+                    /// </summary>
+                    /// <remarks>
+                    /// Exports can allocate variable-sized results from the arena instead of requiring a paired free export.
+                    /// The caller releases all results at once with <c>dnne_arena_reset()</c> or <c>dnne_arena_destroy()</c>.
+                    /// The type has the same layout as a pointer so it can be used directly in the signature of an export
+                    /// declared in a non-public type, with <c>[DNNE.C99Type("dnne_arena*")]</c> or
+                    /// <c>[DNNE.RustType("*mut crate::platform::Arena")]</c>. Exports in public types can accept a
+                    /// <c>void*</c> and construct an <see cref="Arena"/> from it.
+                    /// </remarks>
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal readonly unsafe struct Arena
+                    {
+                        private readonly void* _handle;
+
+                        /// <summary>
+                        /// Creates a new <see cref="Arena"/> instance for the supplied native arena.
+                        /// </summary>
+                        /// <param name="handle">The native <c>dnne_arena*</c>.</param>
+                        public Arena(void* handle)
+                        {
+                            _handle = handle;
+                        }
+
+                        /// <summary>
+                        /// Gets the native <c>dnne_arena*</c>.
+                        /// </summary>
+                        public void* Handle => _handle;
+
+                        /// <summary>
+                        /// Allocates memory from the arena.
+                        /// </summary>
+                        /// <param name="size">The number of bytes to allocate.</param>
+                        /// <param name="alignment">The alignment of the allocation. Must be a power of two, 0 selects pointer alignment.</param>
+                        /// <returns>The allocated memory.</returns>
+                        public void* Allocate(nuint size, nuint alignment = 0)
+                        {
+                            if (_handle == null)
+                            {
+                                throw new global::System.InvalidOperationException("The arena is not valid.");
+                            }
+
+                            // The native allocation function is the first field of the arena.
+                            var alloc = *(delegate* unmanaged[Cdecl]<void*, nuint, nuint, void*>*)_handle;
+                            void* mem = alloc(_handle, size, alignment);
+                            if (mem == null)
+                            {
+                                throw new global::System.OutOfMemoryException();
+                            }
+
+                            return mem;
+                        }
+
+                        /// <summary>
+                        /// Allocates an array of <typeparamref name="T"/> from the arena.
+                        /// </summary>
+                        /// <typeparam name="T">The element type.</typeparam>
+                        /// <param name="count">The number of elements.</param>
+                        /// <returns>A pointer to the first element.</returns>
+                        public T* Allocate<T>(int count = 1) where T : unmanaged
+                        {
+                            if (count < 0)
+                            {
+                                throw new global::System.ArgumentOutOfRangeException(nameof(count));
+                            }
+
+                            // Natural alignment isn't observable, so align to the largest
+                            // power of two that divides the size, up to 16 bytes.
+                            nuint size = (nuint)sizeof(T);
+                            nuint alignment = 16;
+                            while (alignment > 1 && (size % alignment) != 0)
+                            {
+                                alignment >>= 1;
+                            }
+
+                            return (T*)Allocate(size * (nuint)count, alignment);
+                        }
+
+                        /// <summary>
+                        /// Allocates a span of <typeparamref name="T"/> from the arena.
+                        /// </summary>
+                        /// <typeparam name="T">The element type.</typeparam>
+                        /// <param name="length">The number of elements.</param>
+                        /// <returns>A span over the allocated memory.</returns>
+                        public global::System.Span<T> AllocateSpan<T>(int length) where T : unmanaged
+                        {
+                            return new global::System.Span<T>(Allocate<T>(length), length);
+                        }
+
+                        /// <summary>
+                        /// Copies a string into the arena as null-terminated UTF-8.
+                        /// </summary>
+                        /// <param name="value">The string to copy.</param>
+                        /// <returns>The null-terminated UTF-8 string, or null if <paramref name="value"/> is null.</returns>
+                        public byte* AllocateUtf8(string value)
+                        {
+                            if (value == null)
+                            {
+                                return null;
+                            }
+
+                            int length = global::System.Text.Encoding.UTF8.GetByteCount(value);
+                            byte* str = (byte*)Allocate((nuint)length + 1, 1);
+                            global::System.Text.Encoding.UTF8.GetBytes(value, new global::System.Span<byte>(str, length));
+                            str[length] = 0;
+                            return str;
+                        }
+                    }
+                }
+
+                #endif
+                """);
+        });
+    }
+}
@@ -0,0 +1,460 @@
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates a pair of exports for each method marked with <c>DNNE.AsyncExportAttribute</c>.
+/// </summary>
+/// <remarks>
+/// A method returning a task can't be exported directly without blocking the calling thread until the task
+/// completes. Instead, a <c>{EntryPoint}_begin</c> export starts the operation and signals the caller supplied
+/// <c>dnne_completion</c> when the task completes, and a <c>{EntryPoint}_end</c> export collects the result.
+/// The exports are placed in a type named after the declaring type with an <c>AsyncExports</c> suffix.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class AsyncExportGenerator : IIncrementalGenerator
+{
+    private const string AsyncExportAttributeName = "DNNE.AsyncExportAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+    private const string CompletionParameterName = "__dnne_completion";
+    private const string ResultParameterName = "__dnne_result";
+    private const string CompletionAttributes = "[global::DNNE.C99Type(\"struct dnne_completion*\")] [global::DNNE.RustType(\"*mut crate::platform::Completion\")]";
+
+    private static readonly HashSet<string> s_taskTypes = new()
+    {
+        "System.Threading.Tasks.Task",
+        "System.Threading.Tasks.Task<TResult>",
+        "System.Threading.Tasks.ValueTask",
+        "System.Threading.Tasks.ValueTask<TResult>",
+    };
+
+    private static readonly DiagnosticDescriptor s_invalidAsyncExport = new(
+        id: "DNNE1003",
+        title: "Invalid async export",
+        messageFormat: "Method '{0}' can't be exported as an asynchronous operation: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<AsyncExport> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetAsyncExport(context, token))
+            .Where(static e => e is not null);
+
+        context.RegisterSourceOutput(methods.Collect(), static (context, exports) =>
+        {
+            var hintNames = new HashSet<string>();
+            var entryPoints = new Dictionary<string, string>();
+            foreach (AsyncExport export in exports)
+            {
+                if (export.Diagnostic is not null)
+                {
+                    context.ReportDiagnostic(export.Diagnostic);
+                    continue;
+                }
+
+                // Overloads default to the same entry point, which would export duplicate symbols.
+                if (entryPoints.TryGetValue(export.EntryPoint, out string existing))
+                {
+                    context.ReportDiagnostic(Diagnostic.Create(s_invalidAsyncExport, export.Location, export.MethodDisplayName,
+                        $"the export name '{export.EntryPoint}' is already used by '{existing}', set a unique EntryPoint"));
+                    continue;
+                }
+
+                entryPoints.Add(export.EntryPoint, export.MethodDisplayName);
+
+                // Overloads are generated into separate files.
+                string hintName = $"{export.ContainingTypeName}.{export.MethodName}";
+                for (int i = 1; !hintNames.Add(hintName); ++i)
+                {
+                    hintName = $"{export.ContainingTypeName}.{export.MethodName}{i}";
+                }
+
+                context.AddSource($"{hintName}.g.cs", Emit(export));
+            }
+
+            // The completion helper is only needed by the generated exports.
+            if (hintNames.Count > 0)
+            {
+                context.AddSource("DnneAsyncCompletion.g.cs", AsyncCompletionSource);
+            }
+        });
+    }
+
+    private static AsyncExport GetAsyncExport(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == AsyncExportAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        string @namespace = containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString();
+        string containingTypeName = GetAsyncExportsTypeName(containingType);
+        string methodDisplayName = method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat);
+        Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+
+        string entryPoint = attribute.NamedArguments
+            .Where(static a => a.Key == "EntryPoint")
+            .Select(static a => a.Value.Value as string)
+            .FirstOrDefault()
+            ?? method.Name;
+
+        string error = Validate(method, context.SemanticModel.Compilation);
+        if (error is null && !InstantiationGenerator.IsValidEntryPoint(entryPoint))
+        {
+            error = $"'{entryPoint}' is not a valid native export name";
+        }
+
+        if (error is not null)
+        {
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidAsyncExport, location, methodDisplayName, error);
+            return new AsyncExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, null, diagnostic);
+        }
+
+        return new AsyncExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, EmitExports(method, entryPoint), null);
+    }
+
+    private static string Validate(IMethodSymbol method, Compilation compilation)
+    {
+        if (compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null)
+        {
+            return "UnmanagedCallersOnlyAttribute is not available in the target framework";
+        }
+
+        if (compilation.Options is not CSharpCompilationOptions { AllowUnsafe: true })
+        {
+            return "unsafe code must be allowed in the project";
+        }
+
+        if (!method.IsStatic || method.IsGenericMethod)
+        {
+            return "the method must be static and non-generic";
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the method and its containing types must be accessible within the assembly";
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return "the containing types must not be generic";
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None))
+        {
+            return "by-reference parameters are not supported";
+        }
+
+        if (method.ReturnType is not INamedTypeSymbol returnType || !s_taskTypes.Contains(returnType.OriginalDefinition.ToDisplayString()))
+        {
+            return "the method must return Task, Task<T>, ValueTask or ValueTask<T>";
+        }
+
+        if (GetResultType(method) is { IsUnmanagedType: false })
+        {
+            return "the result type must be an unmanaged type";
+        }
+
+        return null;
+    }
+
+    private static string EmitExports(IMethodSymbol method, string entryPoint)
+    {
+        string exportName = entryPoint;
+        string methodName = $"{InstantiationGenerator.EscapeXml(method.ContainingType.Name)}.{InstantiationGenerator.EscapeXml(method.Name)}";
+        ITypeSymbol resultType = GetResultType(method);
+        string result = resultType?.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        string task = result is null ? "global::System.Threading.Tasks.Task" : $"global::System.Threading.Tasks.Task<{result}>";
+        bool isValueTask = method.ReturnType.Name == "ValueTask";
+
+        var builder = new StringBuilder();
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Starts <c>{methodName}</c> and signals the completion when it completes.");
+        builder.AppendLine($"        /// </summary>");
+
+        IEnumerable<string> copiedAttributes = InstantiationGenerator.GetCopiedAttributes(method.GetAttributes());
+        foreach (string attribute in copiedAttributes)
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint + "_begin", quote: true)})]");
+
+        var parameters = new List<string>();
+        foreach (IParameterSymbol parameter in method.Parameters)
+        {
+            string attributes = string.Concat(InstantiationGenerator.GetCopiedAttributes(parameter.GetAttributes()).Select(static a => $"{a} "));
+            parameters.Add($"{attributes}{parameter.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)} {InstantiationGenerator.EscapeIdentifier(parameter.Name)}");
+        }
+
+        parameters.Add($"{CompletionAttributes} void* {CompletionParameterName}");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}({string.Join(", ", method.Parameters.Select(static p => InstantiationGenerator.EscapeIdentifier(p.Name)))})";
+        builder.AppendLine($"        public static int {exportName}_begin({string.Join(", ", parameters)})");
+        builder.AppendLine($"        {{");
+        builder.AppendLine($"            // The method isn't called if the completion can't be signaled.");
+        builder.AppendLine($"            int hr = global::DNNE.AsyncCompletion.Validate({CompletionParameterName});");
+        builder.AppendLine($"            if (hr != 0)");
+        builder.AppendLine($"            {{");
+        builder.AppendLine($"                return hr;");
+        builder.AppendLine($"            }}");
+        builder.AppendLine();
+        builder.AppendLine($"            {task} task;");
+        builder.AppendLine($"            try");
+        builder.AppendLine($"            {{");
+        builder.AppendLine($"                task = {call}{(isValueTask ? ".AsTask()" : "")};");
+        builder.AppendLine($"            }}");
+        builder.AppendLine($"            catch (global::System.Exception e)");
+        builder.AppendLine($"            {{");
+        builder.AppendLine($"                // Reported when the result is collected, like an exception thrown after the first await.");
+        builder.AppendLine($"                task = global::System.Threading.Tasks.Task.FromException{(result is null ? "" : $"<{result}>")}(e);");
+        builder.AppendLine($"            }}");
+        builder.AppendLine();
+        builder.AppendLine($"            return global::DNNE.AsyncCompletion.Begin(task, {CompletionParameterName});");
+        builder.AppendLine($"        }}");
+        builder.AppendLine();
+
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Collects the result of <c>{methodName}</c> started with <c>{InstantiationGenerator.EscapeXml(exportName)}_begin</c>.");
+        builder.AppendLine($"        /// </summary>");
+        foreach (string attribute in copiedAttributes)
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint + "_end", quote: true)})]");
+        if (result is null)
+        {
+            builder.AppendLine($"        public static int {exportName}_end({CompletionAttributes} void* {CompletionParameterName})");
+            builder.AppendLine($"        {{");
+            builder.AppendLine($"            return global::DNNE.AsyncCompletion.End({CompletionParameterName});");
+        }
+        else
+        {
+            builder.AppendLine($"        public static int {exportName}_end({CompletionAttributes} void* {CompletionParameterName}, {result}* {ResultParameterName})");
+            builder.AppendLine($"        {{");
+            builder.AppendLine($"            return global::DNNE.AsyncCompletion.End({CompletionParameterName}, {ResultParameterName});");
+        }
+
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    private static string Emit(AsyncExport export)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine($"namespace {export.Namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static unsafe partial class {export.ContainingTypeName}");
+        builder.AppendLine("    {");
+        builder.Append(export.Code);
+        builder.AppendLine("    }");
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    // The T of Task<T> or ValueTask<T>, otherwise null.
+    private static ITypeSymbol GetResultType(IMethodSymbol method)
+    {
+        return method.ReturnType is INamedTypeSymbol { IsGenericType: true } named ? named.TypeArguments[0] : null;
+    }
+
+    private static string GetAsyncExportsTypeName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return $"{string.Join("_", names)}AsyncExports";
+    }
+
+    private const string AsyncCompletionSource = """
+        // <auto-generated/>
+        #pragma warning disable
+
+        namespace DNNE
+        {
+            /// <summary>
+            /// Connects the task of an asynchronous export to the native <c>dnne_completion</c> supplied by the caller.
+            /// </summary>
+            /// <remarks>
+            /// The task is kept alive by a handle stored in the completion until the result is collected. The completion
+            /// is signaled on the thread that completes the task, or before the begin export returns if it has already
+            /// completed, so no thread is blocked while the operation is in progress.
+            /// </remarks>
+            [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+            internal static unsafe class AsyncCompletion
+            {
+                // Matches struct dnne_completion.
+                [global::System.Runtime.InteropServices.StructLayout(global::System.Runtime.InteropServices.LayoutKind.Sequential)]
+                private struct Completion
+                {
+                    public delegate* unmanaged[Cdecl]<Completion*, void> Signal;
+                    public global::System.IntPtr Callback;
+                    public global::System.IntPtr User;
+                    public global::System.IntPtr Event;
+                    public global::System.IntPtr State;
+                }
+
+                // Checked before the method is called, so an invalid completion doesn't start an operation.
+                public static int Validate(void* completion)
+                {
+                    var c = (Completion*)completion;
+                    if (c == null || c->Signal == null)
+                    {
+                        return new global::System.ArgumentException(null, nameof(completion)).HResult;
+                    }
+
+                    return 0;
+                }
+
+                public static int Begin(global::System.Threading.Tasks.Task task, void* completion)
+                {
+                    var c = (Completion*)completion;
+
+                    // A method that isn't async can return a null task. There is no operation to complete.
+                    if (task == null)
+                    {
+                        return new global::System.InvalidOperationException().HResult;
+                    }
+
+                    // The handle must be stored before the completion can be signaled.
+                    c->State = global::System.Runtime.InteropServices.GCHandle.ToIntPtr(global::System.Runtime.InteropServices.GCHandle.Alloc(task));
+                    if (task.IsCompleted)
+                    {
+                        c->Signal(c);
+                    }
+                    else
+                    {
+                        global::System.IntPtr address = (global::System.IntPtr)c;
+                        task.ConfigureAwait(false).GetAwaiter().UnsafeOnCompleted(() => Signal(address));
+                    }
+
+                    return 0;
+                }
+
+                public static int End(void* completion)
+                {
+                    try
+                    {
+                        Take(completion).GetAwaiter().GetResult();
+                        return 0;
+                    }
+                    catch (global::System.Exception e)
+                    {
+                        return e.HResult;
+                    }
+                }
+
+                public static int End<T>(void* completion, T* result) where T : unmanaged
+                {
+                    try
+                    {
+                        T value = ((global::System.Threading.Tasks.Task<T>)Take(completion)).GetAwaiter().GetResult();
+                        if (result != null)
+                        {
+                            *result = value;
+                        }
+
+                        return 0;
+                    }
+                    catch (global::System.Exception e)
+                    {
+                        return e.HResult;
+                    }
+                }
+
+                private static void Signal(global::System.IntPtr address)
+                {
+                    var c = (Completion*)address;
+                    c->Signal(c);
+                }
+
+                // Releases the task of the completion, the caller only collects the result once it has been signaled.
+                private static global::System.Threading.Tasks.Task Take(void* completion)
+                {
+                    var c = (Completion*)completion;
+                    if (c == null || c->State == global::System.IntPtr.Zero)
+                    {
+                        throw new global::System.InvalidOperationException("The completion has no operation in progress.");
+                    }
+
+                    var handle = global::System.Runtime.InteropServices.GCHandle.FromIntPtr(c->State);
+                    var task = (global::System.Threading.Tasks.Task)handle.Target;
+                    c->State = global::System.IntPtr.Zero;
+                    handle.Free();
+                    return task;
+                }
+            }
+        }
+        """;
+
+    private sealed class AsyncExport
+    {
+        public AsyncExport(string @namespace, string containingTypeName, string methodName, string methodDisplayName, string entryPoint, Location location, string code, Diagnostic diagnostic)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            MethodName = methodName;
+            MethodDisplayName = methodDisplayName;
+            EntryPoint = entryPoint;
+            Location = location;
+            Code = code;
+            Diagnostic = diagnostic;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string MethodName { get; }
+
+        public string MethodDisplayName { get; }
+
+        public string EntryPoint { get; }
+
+        public Location Location { get; }
+
+        public string Code { get; }
+
+        public Diagnostic Diagnostic { get; }
+    }
+}
@@ -22,6 +22,10 @@ public sealed class AttributesGenerator : IIncrementalGenerator
                     /// <summary>
                     /// Defines a C export. Can be used when updating to use <c>UnmanagedCallersOnlyAttribute</c> would take more time.
                     /// </summary>
+                    /// <remarks>
+                    /// When targeting .NET 5 or later, the export is bound through a generated <c>UnmanagedCallersOnlyAttribute</c>
+                    /// trampoline unless the signature needs marshalling, for example a <c>bool</c> or <c>char</c> argument.
+                    /// </remarks>
                     [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
                     [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
                     internal sealed class ExportAttribute : global::System.Attribute
@@ -39,6 +43,314 @@ public sealed class AttributesGenerator : IIncrementalGenerator
                         public string EntryPoint { get; set; }
                     }
 
+                    /// <summary>
+                    /// Indicates the <see cref="ExportAttribute"/> method a trampoline calls.
+                    /// </summary>
+                    /// <remarks>
+                    /// Applied by the generator to an <c>UnmanagedCallersOnlyAttribute</c> method, which dnne-gen binds the
+                    /// export to instead of the method's delegate type.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class ExportTrampolineAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="ExportTrampolineAttribute"/> instance with the specified parameters.
+                        /// </summary>
+                        /// <param name="method">The full name of the method, with nested types delimited by <c>+</c>.</param>
+                        public ExportTrampolineAttribute(string method)
+                        {
+                        }
+                    }
+
+                    /// <summary>
+                    /// Defines a C export for an instantiation of a generic method.
+                    /// </summary>
+                    /// <remarks>
+                    /// The attribute may be applied multiple times to a static generic method. A non-generic
+                    /// method marked with <c>UnmanagedCallersOnlyAttribute</c> is generated for each instantiation,
+                    /// which calls the generic method with the supplied type arguments.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, AllowMultiple = true, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class InstantiateAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="InstantiateAttribute"/> instance with the specified parameters.
+                        /// </summary>
+                        /// <param name="typeArguments">The type arguments for the instantiation.</param>
+                        public InstantiateAttribute(params global::System.Type[] typeArguments)
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the entry point to use to produce the C export.
+                        /// </summary>
+                        /// <remarks>
+                        /// If not set, the method name followed by the type argument names is used (for example, <c>Dot_Single</c>).
+                        /// </remarks>
+                        public string EntryPoint { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Defines a C export for a method that accepts or returns <c>Vector128&lt;T&gt;</c> or <c>Vector256&lt;T&gt;</c> by value.
+                    /// </summary>
+                    /// <remarks>
+                    /// Vectors can't be passed by value to a method marked with <c>UnmanagedCallersOnlyAttribute</c>.
+                    /// A method that accepts the vectors by address is generated instead and the native export
+                    /// passes them by value, in registers where the platform calling convention allows.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class VectorExportAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="VectorExportAttribute"/> instance.
+                        /// </summary>
+                        public VectorExportAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the entry point to use to produce the C export.
+                        /// </summary>
+                        public string EntryPoint { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Defines a pair of C exports for a method that returns <c>Task</c>, <c>Task&lt;T&gt;</c>, <c>ValueTask</c> or <c>ValueTask&lt;T&gt;</c>.
+                    /// </summary>
+                    /// <remarks>
+                    /// The <c>{EntryPoint}_begin</c> export accepts the method's arguments followed by a <c>dnne_completion*</c>,
+                    /// starts the operation and returns without waiting for it. The completion is signaled when the task
+                    /// completes and the <c>{EntryPoint}_end</c> export then collects the result. No thread is blocked while
+                    /// the operation is in progress.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class AsyncExportAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="AsyncExportAttribute"/> instance.
+                        /// </summary>
+                        public AsyncExportAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the prefix of the entry points to use to produce the C exports.
+                        /// </summary>
+                        public string EntryPoint { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Defines a C export that can also be recorded in a <c>dnne_command_buffer</c>.
+                    /// </summary>
+                    /// <remarks>
+                    /// The <c>{EntryPoint}_record</c> export appends a call to a buffer instead of making it. All recorded
+                    /// calls are then made by a single <c>dnne_submit</c> call, so the transition into the runtime is paid once
+                    /// per buffer. The arguments and return value must be integers, floating point values, enums or pointers.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class CommandExportAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="CommandExportAttribute"/> instance.
+                        /// </summary>
+                        public CommandExportAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the entry point to use to produce the C export.
+                        /// </summary>
+                        public string EntryPoint { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Indicates the opcode used to record calls to an export in a <c>dnne_command_buffer</c>.
+                    /// </summary>
+                    /// <remarks>
+                    /// Applied by the generator for <see cref="CommandExportAttribute"/>.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class CommandOpcodeAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="CommandOpcodeAttribute"/> instance with the specified parameters.
+                        /// </summary>
+                        /// <param name="opcode">The opcode of the export.</param>
+                        public CommandOpcodeAttribute(int opcode)
+                        {
+                        }
+                    }
+
+                    /// <summary>
+                    /// Defines a C export that runs in a shared server process when the native binary is built with <c>DnneOutOfProcess</c>.
+                    /// </summary>
+                    /// <remarks>
+                    /// The arguments are copied to the server, which runs the method and copies the return value back. An exception
+                    /// thrown by the method is reported to the calling process through the failure callback and the server keeps running.
+                    /// The arguments and return value must be integers, floating point values or enums. Pointers and pointer-sized
+                    /// integers aren't allowed, they are meaningless in another process.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class RemoteExportAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="RemoteExportAttribute"/> instance.
+                        /// </summary>
+                        public RemoteExportAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the entry point to use to produce the C export.
+                        /// </summary>
+                        public string EntryPoint { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Indicates the index used to dispatch calls to an export in the shared server process.
+                    /// </summary>
+                    /// <remarks>
+                    /// Applied by the generator for <see cref="RemoteExportAttribute"/>.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class RemoteIndexAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="RemoteIndexAttribute"/> instance with the specified parameters.
+                        /// </summary>
+                        /// <param name="index">The index of the export.</param>
+                        public RemoteIndexAttribute(int index)
+                        {
+                        }
+                    }
+
+                    /// <summary>
+                    /// Indicates an export is a pure function of its arguments, so the native export can cache its results.
+                    /// </summary>
+                    /// <remarks>
+                    /// The native export keeps recent results in a cache keyed by the arguments, and returns a cached result without
+                    /// calling into the runtime. Call <c>DNNE.PureCaches.Invalidate()</c> when data the results depend on changes.
+                    /// The arguments and return value must be fixed-size integers or floating point values, not <c>nint</c> or <c>nuint</c>.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Method, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class PureAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="PureAttribute"/> instance.
+                        /// </summary>
+                        public PureAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the number of results cached by the native export.
+                        /// </summary>
+                        /// <remarks>
+                        /// The default is 64. A result replaces the cached result of other arguments that map to the same entry.
+                        /// </remarks>
+                        public int CacheSize { get; set; } = 64;
+                    }
+
+                    /// <summary>
+                    /// Generates a handle type used to pass instances of a class to native code.
+                    /// </summary>
+                    /// <remarks>
+                    /// A <c>{TypeName}Handle</c> struct is generated next to the class. Handles are allocated from a table of slots
+                    /// rather than the GC handle table, so allocating and resolving a handle are indexed lookups, and a freed handle
+                    /// is detected when resolved. Each handle type is a distinct opaque type in the native exports.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Class, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class HandleAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="HandleAttribute"/> instance.
+                        /// </summary>
+                        public HandleAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the name of the native handle type.
+                        /// </summary>
+                        /// <remarks>
+                        /// If not set, the type name followed by <c>_handle</c> is used (for example, <c>MyClass_handle</c>).
+                        /// </remarks>
+                        public string Name { get; set; }
+                    }
+
+                    /// <summary>
+                    /// Indicates the native type of a handle.
+                    /// </summary>
+                    /// <remarks>
+                    /// Applied by the generator for <see cref="HandleAttribute"/>.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Struct, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class HandleTypeAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="HandleTypeAttribute"/> instance with the specified parameters.
+                        /// </summary>
+                        /// <param name="name">The name of the native handle type.</param>
+                        public HandleTypeAttribute(string name)
+                        {
+                        }
+                    }
+
+                    /// <summary>
+                    /// Indicates a vector argument, or the return value, that is passed by value by the native export.
+                    /// </summary>
+                    /// <remarks>
+                    /// Applied by the generator for <see cref="VectorExportAttribute"/> to a pointer argument. When applied
+                    /// to the return value, the final pointer argument receives the return value.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Parameter | global::System.AttributeTargets.ReturnValue, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class VectorByValueAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="VectorByValueAttribute"/> instance.
+                        /// </summary>
+                        public VectorByValueAttribute()
+                        {
+                        }
+                    }
+
+                    /// <summary>
+                    /// Exports a constant, or read-only data, so native code can read it without starting the runtime.
+                    /// </summary>
+                    /// <remarks>
+                    /// A primitive constant field is defined as a macro in the generated header. An RVA static field, or a static
+                    /// <c>ReadOnlySpan&lt;byte&gt;</c> property initialized from a constant array or a UTF-8 string literal, is
+                    /// exported as a <c>const uint8_t</c> array.
+                    /// </remarks>
+                    [global::System.AttributeUsage(global::System.AttributeTargets.Field | global::System.AttributeTargets.Property, Inherited = false)]
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal sealed class ExportDataAttribute : global::System.Attribute
+                    {
+                        /// <summary>
+                        /// Creates a new <see cref="ExportDataAttribute"/> instance.
+                        /// </summary>
+                        public ExportDataAttribute()
+                        {
+                        }
+
+                        /// <summary>
+                        /// Gets or sets the name of the native symbol.
+                        /// </summary>
+                        public string EntryPoint { get; set; }
+                    }
+
                     /// <summary>
                     /// Provides C code to be defined early in the generated C header file.
                     /// </summary>
@@ -0,0 +1,465 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates an export, and a command buffer opcode, for each method marked with <c>DNNE.CommandExportAttribute</c>.
+/// </summary>
+/// <remarks>
+/// The generated export is marked with <c>DNNE.CommandOpcodeAttribute</c> so dnne-gen also defines a native
+/// <c>{EntryPoint}_record</c> function that appends the call to a <c>dnne_command_buffer</c>. The platform layer
+/// passes the recorded calls to the generated <c>DNNE.CommandBuffer</c> type, which calls each method directly.
+/// Opcodes are assigned in entry point order. The exports are placed in a type named after the declaring type
+/// with a <c>CommandExports</c> suffix.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class CommandExportGenerator : IIncrementalGenerator
+{
+    private const string CommandExportAttributeName = "DNNE.CommandExportAttribute";
+    private const string CommandOpcodeAttributeName = "DNNE.CommandOpcodeAttribute";
+    private const string ExportAttributeName = "DNNE.ExportAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+    private const string OpcodePlaceholder = "__DNNE_COMMAND_OPCODE__";
+
+    private static readonly DiagnosticDescriptor s_invalidCommandExport = new(
+        id: "DNNE1004",
+        title: "Invalid command export",
+        messageFormat: "Method '{0}' can't be recorded in a command buffer: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<CommandExport> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetCommandExport(context, token))
+            .Where(static e => e is not null);
+
+        // The {EntryPoint}_record function is defined next to the exports, so its name must not be exported by any other method.
+        IncrementalValuesProvider<string> exportNames = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetExportName(context, token))
+            .Where(static n => n is not null);
+
+        context.RegisterSourceOutput(methods.Collect().Combine(exportNames.Collect()), static (context, input) =>
+        {
+            (ImmutableArray<CommandExport> exports, ImmutableArray<string> names) = input;
+            var usedNames = new HashSet<string>(names, StringComparer.Ordinal);
+            foreach (CommandExport export in exports)
+            {
+                usedNames.Add(export.EntryPoint);
+            }
+
+            // The opcodes only need to agree with the generated exports, which dnne-gen reads.
+            var entryPoints = new Dictionary<string, string>();
+            var commands = new List<CommandExport>();
+            foreach (CommandExport export in exports.OrderBy(static e => e.EntryPoint, StringComparer.Ordinal).ThenBy(static e => e.Target, StringComparer.Ordinal))
+            {
+                if (export.Diagnostic is not null)
+                {
+                    context.ReportDiagnostic(export.Diagnostic);
+                    continue;
+                }
+
+                // Overloads default to the same entry point, which would export duplicate symbols.
+                if (entryPoints.TryGetValue(export.EntryPoint, out string existing))
+                {
+                    context.ReportDiagnostic(Diagnostic.Create(s_invalidCommandExport, export.Location, export.MethodDisplayName,
+                        $"the export name '{export.EntryPoint}' is already used by '{existing}', set a unique EntryPoint"));
+                    continue;
+                }
+
+                string recordName = $"{export.EntryPoint}_record";
+                if (usedNames.Contains(recordName))
+                {
+                    context.ReportDiagnostic(Diagnostic.Create(s_invalidCommandExport, export.Location, export.MethodDisplayName,
+                        $"the generated export name '{recordName}' is already used by another export, set a different EntryPoint"));
+                    continue;
+                }
+
+                entryPoints.Add(export.EntryPoint, export.MethodDisplayName);
+                commands.Add(export);
+            }
+
+            if (commands.Count == 0)
+            {
+                return;
+            }
+
+            var hintNames = new HashSet<string>();
+            for (int i = 0; i < commands.Count; ++i)
+            {
+                CommandExport export = commands[i];
+
+                // Overloads are generated into separate files.
+                string hintName = $"{export.ContainingTypeName}.{export.MethodName}";
+                for (int j = 1; !hintNames.Add(hintName); ++j)
+                {
+                    hintName = $"{export.ContainingTypeName}.{export.MethodName}{j}";
+                }
+
+                context.AddSource($"{hintName}.g.cs", Emit(export, opcode: i + 1));
+            }
+
+            context.AddSource("DnneCommandBuffer.g.cs", EmitCommandBuffer(commands));
+        });
+    }
+
+    private static CommandExport GetCommandExport(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == CommandExportAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        string @namespace = containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString();
+        string containingTypeName = GetCommandExportsTypeName(containingType);
+        string methodDisplayName = method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat);
+        Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+
+        string entryPoint = GetEntryPoint(method, attribute);
+
+        string error = Validate(method, context.SemanticModel.Compilation);
+        if (error is null && !InstantiationGenerator.IsValidEntryPoint(entryPoint))
+        {
+            error = $"'{entryPoint}' is not a valid native export name";
+        }
+
+        if (error is not null)
+        {
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidCommandExport, location, methodDisplayName, error);
+            return new CommandExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, null, null, ImmutableArray<string>.Empty, null, diagnostic);
+        }
+
+        string target = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}";
+        string returnType = method.ReturnsVoid ? null : method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        ImmutableArray<string> parameterTypes = method.Parameters
+            .Select(static p => p.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat))
+            .ToImmutableArray();
+
+        return new CommandExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, target, returnType, parameterTypes, EmitExport(method, entryPoint), null);
+    }
+
+    // Name of the native export defined for a method declared with UnmanagedCallersOnlyAttribute or DNNE.ExportAttribute.
+    private static string GetExportName(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() is UnmanagedCallersOnlyAttributeName or ExportAttributeName);
+        return attribute is null ? null : GetEntryPoint(method, attribute);
+    }
+
+    private static string GetEntryPoint(IMethodSymbol method, AttributeData attribute)
+    {
+        return attribute.NamedArguments
+            .Where(static a => a.Key == "EntryPoint")
+            .Select(static a => a.Value.Value as string)
+            .FirstOrDefault()
+            ?? method.Name;
+    }
+
+    private static string Validate(IMethodSymbol method, Compilation compilation)
+    {
+        if (compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null)
+        {
+            return "UnmanagedCallersOnlyAttribute is not available in the target framework";
+        }
+
+        if (compilation.Options is not CSharpCompilationOptions { AllowUnsafe: true })
+        {
+            return "unsafe code must be allowed in the project";
+        }
+
+        if (!method.IsStatic || method.IsGenericMethod)
+        {
+            return "the method must be static and non-generic";
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the method and its containing types must be accessible within the assembly";
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return "the containing types must not be generic";
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            return "by-reference parameters and returns are not supported";
+        }
+
+        // Each argument is recorded in an 8 byte slot.
+        if (method.Parameters.Any(static p => !IsCommandType(p.Type)) || (!method.ReturnsVoid && !IsCommandType(method.ReturnType)))
+        {
+            return "the arguments and return value must be integers, floating point values, enums or pointers";
+        }
+
+        return null;
+    }
+
+    private static bool IsCommandType(ITypeSymbol type)
+    {
+        if (type is IPointerTypeSymbol)
+        {
+            return true;
+        }
+
+        if (type is INamedTypeSymbol { TypeKind: TypeKind.Enum } named)
+        {
+            type = named.EnumUnderlyingType;
+        }
+
+        return type?.SpecialType is SpecialType.System_SByte
+            or SpecialType.System_Byte
+            or SpecialType.System_Int16
+            or SpecialType.System_UInt16
+            or SpecialType.System_Int32
+            or SpecialType.System_UInt32
+            or SpecialType.System_Int64
+            or SpecialType.System_UInt64
+            or SpecialType.System_IntPtr
+            or SpecialType.System_UIntPtr
+            or SpecialType.System_Single
+            or SpecialType.System_Double;
+    }
+
+    private static string EmitExport(IMethodSymbol method, string entryPoint)
+    {
+        string exportName = entryPoint;
+
+        var builder = new StringBuilder();
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Export of <c>{InstantiationGenerator.EscapeXml(method.ContainingType.Name)}.{InstantiationGenerator.EscapeXml(method.Name)}</c> that can also be recorded in a command buffer.");
+        builder.AppendLine($"        /// </summary>");
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetAttributes()))
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        // The opcode is assigned once every command export is known.
+        builder.AppendLine($"        [global::{CommandOpcodeAttributeName}({OpcodePlaceholder})]");
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint, quote: true)})]");
+
+        var parameters = new List<string>();
+        foreach (IParameterSymbol parameter in method.Parameters)
+        {
+            string attributes = string.Concat(InstantiationGenerator.GetCopiedAttributes(parameter.GetAttributes()).Select(static a => $"{a} "));
+            parameters.Add($"{attributes}{parameter.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)} {InstantiationGenerator.EscapeIdentifier(parameter.Name)}");
+        }
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetReturnTypeAttributes()))
+        {
+            builder.AppendLine($"        [return: {attribute.Substring(1)}");
+        }
+
+        string returnType = method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        builder.AppendLine($"        public static {returnType} {exportName}({string.Join(", ", parameters)})");
+        builder.AppendLine($"        {{");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}({string.Join(", ", method.Parameters.Select(static p => InstantiationGenerator.EscapeIdentifier(p.Name)))})";
+        builder.AppendLine(method.ReturnsVoid ? $"            {call};" : $"            return {call};");
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    private static string Emit(CommandExport export, int opcode)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine($"namespace {export.Namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static unsafe partial class {export.ContainingTypeName}");
+        builder.AppendLine("    {");
+        builder.Append(export.Code.Replace(OpcodePlaceholder, opcode.ToString()));
+        builder.AppendLine("    }");
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private static string EmitCommandBuffer(List<CommandExport> commands)
+    {
+        var cases = new StringBuilder();
+        for (int i = 0; i < commands.Count; ++i)
+        {
+            CommandExport command = commands[i];
+
+            // The address of the result, if any, precedes the arguments.
+            int first = command.ReturnType is null ? 0 : 1;
+            string arguments = string.Join(", ", command.ParameterTypes.Select((type, index) => $"*({type}*)(args + {first + index})"));
+            string call = $"{command.Target}({arguments})";
+
+            cases.AppendLine($"                        case {i + 1}:");
+            if (command.ReturnType is null)
+            {
+                cases.AppendLine($"                            {call};");
+            }
+            else
+            {
+                cases.AppendLine($"                        {{");
+                cases.AppendLine($"                            {command.ReturnType} ret = {call};");
+                cases.AppendLine($"                            {command.ReturnType}* result = *({command.ReturnType}**)args;");
+                cases.AppendLine($"                            if (result != null)");
+                cases.AppendLine($"                            {{");
+                cases.AppendLine($"                                *result = ret;");
+                cases.AppendLine($"                            }}");
+                cases.AppendLine($"                        }}");
+            }
+
+            cases.AppendLine($"                            break;");
+        }
+
+        return $$"""
+            // <auto-generated/>
+            #pragma warning disable
+
+            namespace DNNE
+            {
+                /// <summary>
+                /// Runs the calls recorded in a native <c>dnne_command_buffer</c>.
+                /// </summary>
+                /// <remarks>
+                /// Each call is a header slot holding the opcode in the low 32 bits and the number of 8 byte slots
+                /// that follow in the high 32 bits, then the address of the result if the method returns a value,
+                /// then one slot per argument.
+                /// </remarks>
+                [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                internal static unsafe class CommandBuffer
+                {
+                    [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                    private static int Submit(ulong* commands, nint count)
+                    {
+                        try
+                        {
+                            ulong* end = commands + count;
+                            while (commands < end)
+                            {
+                                ulong header = *commands;
+                                ulong* args = commands + 1;
+                                switch ((uint)header)
+                                {
+            {{cases}}                        default:
+                                        return new global::System.ArgumentException(null, nameof(commands)).HResult;
+                                }
+
+                                commands = args + (uint)(header >> 32);
+                            }
+
+                            return 0;
+                        }
+                        catch (global::System.Exception e)
+                        {
+                            // Calls after the one that threw aren't run.
+                            return e.HResult;
+                        }
+                    }
+                }
+            }
+            """;
+    }
+
+    private static string GetCommandExportsTypeName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return $"{string.Join("_", names)}CommandExports";
+    }
+
+    private sealed class CommandExport
+    {
+        public CommandExport(
+            string @namespace,
+            string containingTypeName,
+            string methodName,
+            string methodDisplayName,
+            string entryPoint,
+            Location location,
+            string target,
+            string returnType,
+            ImmutableArray<string> parameterTypes,
+            string code,
+            Diagnostic diagnostic)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            MethodName = methodName;
+            MethodDisplayName = methodDisplayName;
+            EntryPoint = entryPoint;
+            Location = location;
+            Target = target;
+            ReturnType = returnType;
+            ParameterTypes = parameterTypes;
+            Code = code;
+            Diagnostic = diagnostic;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string MethodName { get; }
+
+        public string MethodDisplayName { get; }
+
+        public string EntryPoint { get; }
+
+        public Location Location { get; }
+
+        // Fully qualified name of the method called by the command buffer.
+        public string Target { get; }
+
+        // Null if the method returns void.
+        public string ReturnType { get; }
+
+        public ImmutableArray<string> ParameterTypes { get; }
+
+        public string Code { get; }
+
+        public Diagnostic Diagnostic { get; }
+    }
+}
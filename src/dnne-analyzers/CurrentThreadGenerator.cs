@@ -0,0 +1,88 @@
+using Microsoft.CodeAnalysis;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates the managed implementation of the native <c>dnne_prepare_current_thread()</c>
+/// and <c>dnne_release_current_thread()</c>.
+/// </summary>
+/// <remarks>
+/// The platform layer resolves the generated methods by name, they aren't native exports.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class CurrentThreadGenerator : IIncrementalGenerator
+{
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        context.RegisterPostInitializationOutput(static context =>
+        {
+            context.AddSource("DnneCurrentThread.g.cs", """
+                // <auto-generated/>
+                #pragma warning disable
+                #if NET5_0_OR_GREATER
+
+                namespace DNNE
+                {
+                    /// <summary>
+                    /// Prepares native threads to call exports.
+                    /// </summary>
+                    /// <remarks>
+                    /// Handlers of <see cref="Preparing"/> and <see cref="Releasing"/> are called on the native thread,
+                    /// so they can initialize and release the thread-static state of the assembly.
+                    /// </remarks>
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal static class CurrentThread
+                    {
+                        /// <summary>
+                        /// Raised on a thread passed to the native <c>dnne_prepare_current_thread()</c>.
+                        /// </summary>
+                        public static event global::System.Action Preparing;
+
+                        /// <summary>
+                        /// Raised on a thread passed to the native <c>dnne_release_current_thread()</c>.
+                        /// </summary>
+                        public static event global::System.Action Releasing;
+
+                        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                        private static int Prepare()
+                        {
+                            try
+                            {
+                                // The runtime creates the managed thread, its culture and
+                                // its stack limits the first time they are used.
+                                global::System.GC.KeepAlive(global::System.Threading.Thread.CurrentThread);
+                                global::System.GC.KeepAlive(global::System.Globalization.CultureInfo.CurrentCulture);
+                                global::System.GC.KeepAlive(global::System.Globalization.CultureInfo.CurrentUICulture);
+                                global::System.Runtime.CompilerServices.RuntimeHelpers.EnsureSufficientExecutionStack();
+
+                                Preparing?.Invoke();
+                                return 0;
+                            }
+                            catch (global::System.Exception e)
+                            {
+                                return e.HResult;
+                            }
+                        }
+
+                        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                        private static int Release()
+                        {
+                            try
+                            {
+                                Releasing?.Invoke();
+                                return 0;
+                            }
+                            catch (global::System.Exception e)
+                            {
+                                return e.HResult;
+                            }
+                        }
+                    }
+                }
+
+                #endif
+                """);
+        });
+    }
+}
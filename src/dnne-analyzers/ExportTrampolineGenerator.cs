@@ -0,0 +1,244 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates an <c>UnmanagedCallersOnlyAttribute</c> trampoline for each method marked with <c>DNNE.ExportAttribute</c>.
+/// </summary>
+/// <remarks>
+/// An export marked with <c>DNNE.ExportAttribute</c> is otherwise bound through a delegate type, which marshals
+/// every call. The trampoline is marked with <c>DNNE.ExportTrampolineAttribute</c> so dnne-gen binds the export
+/// to it instead. Trampolines aren't public, so they aren't exports themselves, and are placed in a type named
+/// after the declaring type with an <c>ExportTrampolines</c> suffix. A method whose signature needs marshalling
+/// is left bound through its delegate type.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class ExportTrampolineGenerator : IIncrementalGenerator
+{
+    private const string ExportAttributeName = "DNNE.ExportAttribute";
+    private const string ExportTrampolineAttributeName = "DNNE.ExportTrampolineAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+    private const string MarshalAsAttributeName = "System.Runtime.InteropServices.MarshalAsAttribute";
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<Trampoline> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetTrampoline(context, token))
+            .Where(static t => t is not null);
+
+        IncrementalValueProvider<(ImmutableArray<Trampoline> Methods, bool AllowUnsafe)> all = methods.Collect()
+            .Combine(context.CompilationProvider.Select(static (compilation, _) => compilation.Options is CSharpCompilationOptions { AllowUnsafe: true }));
+
+        context.RegisterSourceOutput(all, static (context, all) =>
+        {
+            foreach (IGrouping<(string Namespace, string ContainingTypeName), Trampoline> type in all.Methods.GroupBy(static t => (t.Namespace, t.ContainingTypeName)))
+            {
+                string hintName = type.Key.Namespace is null ? type.Key.ContainingTypeName : $"{type.Key.Namespace}.{type.Key.ContainingTypeName}";
+                context.AddSource($"{hintName}.g.cs", Emit(type.Key.Namespace, type.Key.ContainingTypeName, type, all.AllowUnsafe));
+            }
+        });
+    }
+
+    private static Trampoline GetTrampoline(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        if (!method.GetAttributes().Any(static a => a.AttributeClass?.ToDisplayString() == ExportAttributeName))
+        {
+            return null;
+        }
+
+        // Trampolines can't be generated for .NET Framework. The export is still bound through its delegate type.
+        if (context.SemanticModel.Compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null
+            || !CanCallWithoutMarshalling(method))
+        {
+            return null;
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        string @namespace = containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString();
+
+        // The full name of the method as computed by dnne-gen, with nested types delimited by '+'.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = containingType; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.MetadataName);
+        }
+
+        string target = $"{string.Join("+", names)}.{method.MetadataName}";
+        if (@namespace is not null)
+        {
+            target = $"{@namespace}.{target}";
+        }
+
+        return new Trampoline(@namespace, $"{string.Join("_", names)}ExportTrampolines", EmitTrampoline(method, target));
+    }
+
+    private static bool CanCallWithoutMarshalling(IMethodSymbol method)
+    {
+        if (!method.IsStatic || method.IsGenericMethod)
+        {
+            return false;
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return false;
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return false;
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            return false;
+        }
+
+        // Custom marshalling is only applied by the delegate.
+        if (method.GetReturnTypeAttributes().Concat(method.Parameters.SelectMany(static p => p.GetAttributes()))
+            .Any(static a => a.AttributeClass?.ToDisplayString() == MarshalAsAttributeName))
+        {
+            return false;
+        }
+
+        return (method.ReturnsVoid || IsBlittable(method.ReturnType)) && method.Parameters.All(static p => IsBlittable(p.Type));
+    }
+
+    private static bool IsBlittable(ITypeSymbol type)
+    {
+        switch (type)
+        {
+            case IPointerTypeSymbol:
+            case IFunctionPointerTypeSymbol:
+            case INamedTypeSymbol { TypeKind: TypeKind.Enum }:
+                return true;
+
+            case INamedTypeSymbol { TypeKind: TypeKind.Struct, IsGenericType: false } named:
+                switch (named.SpecialType)
+                {
+                    case SpecialType.System_SByte:
+                    case SpecialType.System_Byte:
+                    case SpecialType.System_Int16:
+                    case SpecialType.System_UInt16:
+                    case SpecialType.System_Int32:
+                    case SpecialType.System_UInt32:
+                    case SpecialType.System_Int64:
+                    case SpecialType.System_UInt64:
+                    case SpecialType.System_IntPtr:
+                    case SpecialType.System_UIntPtr:
+                    case SpecialType.System_Single:
+                    case SpecialType.System_Double:
+                        return true;
+                    case SpecialType.None:
+                        break;
+                    default:
+                        // bool, char, decimal and DateTime are converted by the delegate.
+                        return false;
+                }
+
+                // Other runtime structs, such as DateTime, may also be converted.
+                if (named.ContainingNamespace?.ToDisplayString() == "System" || !named.IsUnmanagedType)
+                {
+                    return false;
+                }
+
+                return named.GetMembers()
+                    .OfType<IFieldSymbol>()
+                    .Where(static f => !f.IsStatic)
+                    .All(static f => f.IsFixedSizeBuffer
+                        ? IsBlittable(((IPointerTypeSymbol)f.Type).PointedAtType)
+                        : IsBlittable(f.Type));
+
+            default:
+                return false;
+        }
+    }
+
+    private static string EmitTrampoline(IMethodSymbol method, string target)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Trampoline for <c>{InstantiationGenerator.EscapeXml(method.ContainingType.Name)}.{InstantiationGenerator.EscapeXml(method.Name)}</c> that is bound without a delegate.");
+        builder.AppendLine($"        /// </summary>");
+        builder.AppendLine($"        [global::{ExportTrampolineAttributeName}({SymbolDisplay.FormatLiteral(target, quote: true)})]");
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}]");
+
+        string parameters = string.Join(", ", method.Parameters.Select(static p => $"{p.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)} {InstantiationGenerator.EscapeIdentifier(p.Name)}"));
+        string returnType = method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        builder.AppendLine($"        internal static {returnType} {InstantiationGenerator.EscapeIdentifier(method.Name)}({parameters})");
+        builder.AppendLine($"        {{");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}({string.Join(", ", method.Parameters.Select(static p => InstantiationGenerator.EscapeIdentifier(p.Name)))})";
+        builder.AppendLine(method.ReturnsVoid ? $"            {call};" : $"            return {call};");
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    private static string Emit(string @namespace, string containingTypeName, IEnumerable<Trampoline> trampolines, bool allowUnsafe)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (@namespace is not null)
+        {
+            builder.AppendLine($"namespace {@namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static {(allowUnsafe ? "unsafe " : string.Empty)}partial class {containingTypeName}");
+        builder.AppendLine("    {");
+
+        string separator = string.Empty;
+        foreach (Trampoline trampoline in trampolines)
+        {
+            builder.Append(separator);
+            builder.Append(trampoline.Code);
+            separator = "\n";
+        }
+
+        builder.AppendLine("    }");
+
+        if (@namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private sealed class Trampoline
+    {
+        public Trampoline(string @namespace, string containingTypeName, string code)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            Code = code;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string Code { get; }
+    }
+}
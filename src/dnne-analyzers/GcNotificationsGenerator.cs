@@ -0,0 +1,293 @@
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates the managed implementation of the native <c>dnne_register_gc_callback()</c>.
+/// </summary>
+/// <remarks>
+/// The generated type calls the native callback through an unmanaged function pointer,
+/// so it is only generated when unsafe code is allowed in the consuming project.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class GcNotificationsGenerator : IIncrementalGenerator
+{
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValueProvider<bool> allowUnsafe = context.CompilationProvider
+            .Select(static (compilation, _) => compilation.Options is CSharpCompilationOptions { AllowUnsafe: true });
+
+        context.RegisterSourceOutput(allowUnsafe, static (context, allowUnsafe) =>
+        {
+            if (!allowUnsafe)
+            {
+                return;
+            }
+
+            context.AddSource("DnneGcNotifications.g.cs", """
+                // <auto-generated/>
+                #pragma warning disable
+                #if NET5_0_OR_GREATER
+
+                namespace DNNE
+                {
+                    /// <summary>
+                    /// Reports the start and end of each GC, and the approach of a full blocking GC, to the callback
+                    /// registered with the native <c>dnne_register_gc_callback()</c>.
+                    /// </summary>
+                    /// <remarks>
+                    /// The GC events of the runtime's event source are observed by an in-process listener.
+                    /// The listener receives them after they are written, so the start and end are post-hoc.
+                    /// The approach of a full blocking GC is announced by the GC itself before the collection,
+                    /// and is waited for on a dedicated thread.
+                    /// </remarks>
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal static unsafe class GcNotifications
+                    {
+                        // Between 1 and 99, higher values announce a full GC earlier. See GC.RegisterForFullGCNotification().
+                        private const int FullGCApproachThreshold = 10;
+
+                        private static readonly object s_lock = new object();
+                        private static Listener s_listener;
+                        private static global::System.Threading.Thread s_approachWatcher;
+
+                        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                        private static int Register(global::System.IntPtr callback, global::System.IntPtr user)
+                        {
+                            try
+                            {
+                                Listener previous;
+                                lock (s_lock)
+                                {
+                                    // The full GC notification is process wide, so the watcher is started once and
+                                    // reports to whichever listener is registered.
+                                    if (callback != global::System.IntPtr.Zero && s_approachWatcher == null)
+                                    {
+                                        global::System.GC.RegisterForFullGCNotification(FullGCApproachThreshold, FullGCApproachThreshold);
+                                        s_approachWatcher = new global::System.Threading.Thread(WatchFullGCApproach)
+                                        {
+                                            IsBackground = true,
+                                            Name = "DNNE GC approach",
+                                        };
+                                        s_approachWatcher.Start();
+                                    }
+
+                                    previous = s_listener;
+                                    s_listener = callback != global::System.IntPtr.Zero
+                                        ? new Listener((delegate* unmanaged<GcEvent*, global::System.IntPtr, void>)callback, user)
+                                        : null;
+                                }
+
+                                // Wait for a callback in progress outside the lock, the callback may register another.
+                                previous?.Close();
+                                return 0;
+                            }
+                            catch (global::System.Exception e)
+                            {
+                                return e.HResult;
+                            }
+                        }
+
+                        private static void WatchFullGCApproach()
+                        {
+                            while (true)
+                            {
+                                // Not succeeded if the notification was cancelled by other code in the process.
+                                if (global::System.GC.WaitForFullGCApproach() != global::System.GCNotificationStatus.Succeeded)
+                                {
+                                    return;
+                                }
+
+                                global::System.Threading.Volatile.Read(ref s_listener)?.OnFullGCApproach();
+                                global::System.GC.WaitForFullGCComplete();
+                            }
+                        }
+
+                        // Matches struct dnne_gc_event.
+                        [global::System.Runtime.InteropServices.StructLayout(global::System.Runtime.InteropServices.LayoutKind.Sequential)]
+                        private struct GcEvent
+                        {
+                            public uint Size;
+                            public int Type;
+                            public int Generation;
+                            public int Reason;
+                            public int Kind;
+                            public ulong Index;
+                            public ulong PauseDurationNs;
+                        }
+
+                        private sealed class Listener : global::System.Diagnostics.Tracing.EventListener
+                        {
+                            private const string RuntimeEventSourceName = "Microsoft-Windows-DotNETRuntime";
+                            private const long GCKeyword = 0x1;
+
+                            // See ClrEtwAll.man in dotnet/runtime.
+                            private const int GCStartEventId = 1;
+                            private const int GCEndEventId = 2;
+                            private const int GCRestartEEEndEventId = 3;
+                            private const int GCSuspendEEBeginEventId = 9;
+
+                            private const int GCEventStart = 1;
+                            private const int GCEventEnd = 2;
+                            private const int GCEventApproach = 3;
+                            private const int GCKindBlocking = 0;
+
+                            private readonly delegate* unmanaged<GcEvent*, global::System.IntPtr, void> _callback;
+                            private readonly global::System.IntPtr _user;
+
+                            // Held while the callback is called, so Close() returns once no callback is in progress.
+                            private readonly object _dispatchLock = new object();
+                            private bool _closed;
+
+                            // Events of the event source are dispatched on a single thread.
+                            private readonly global::System.Collections.Generic.Dictionary<long, GcEvent> _inProgress = new();
+                            private readonly global::System.Collections.Generic.List<GcEvent> _pendingEnd = new();
+                            private global::System.DateTime _suspendStart;
+                            private bool _suspended;
+
+                            public Listener(delegate* unmanaged<GcEvent*, global::System.IntPtr, void> callback, global::System.IntPtr user)
+                            {
+                                _callback = callback;
+                                _user = user;
+                            }
+
+                            /// <summary>
+                            /// Stop calling the callback, waiting for a call in progress on another thread.
+                            /// </summary>
+                            public void Close()
+                            {
+                                lock (_dispatchLock)
+                                {
+                                    _closed = true;
+                                }
+
+                                Dispose();
+                            }
+
+                            /// <summary>
+                            /// Report that a full blocking GC is approaching, called on the watcher thread.
+                            /// </summary>
+                            public void OnFullGCApproach()
+                            {
+                                // The collection hasn't started, so its index is after the last one.
+                                var evt = new GcEvent()
+                                {
+                                    Size = (uint)sizeof(GcEvent),
+                                    Type = GCEventApproach,
+                                    Index = (ulong)global::System.GC.CollectionCount(0),
+                                    Generation = global::System.GC.MaxGeneration,
+                                    Kind = GCKindBlocking,
+                                };
+                                Invoke(&evt);
+                            }
+
+                            private void Invoke(GcEvent* evt)
+                            {
+                                lock (_dispatchLock)
+                                {
+                                    if (!_closed)
+                                    {
+                                        _callback(evt, _user);
+                                    }
+                                }
+                            }
+
+                            protected override void OnEventSourceCreated(global::System.Diagnostics.Tracing.EventSource eventSource)
+                            {
+                                if (eventSource.Name == RuntimeEventSourceName)
+                                {
+                                    EnableEvents(eventSource, global::System.Diagnostics.Tracing.EventLevel.Informational, (global::System.Diagnostics.Tracing.EventKeywords)GCKeyword);
+                                }
+                            }
+
+                            protected override void OnEventWritten(global::System.Diagnostics.Tracing.EventWrittenEventArgs eventData)
+                            {
+                                // Events can be written before the constructor has run.
+                                if (_callback == null)
+                                {
+                                    return;
+                                }
+
+                                switch (eventData.EventId)
+                                {
+                                    case GCSuspendEEBeginEventId:
+                                        _suspendStart = eventData.TimeStamp;
+                                        _suspended = true;
+                                        break;
+
+                                    case GCStartEventId:
+                                    {
+                                        var evt = new GcEvent()
+                                        {
+                                            Size = (uint)sizeof(GcEvent),
+                                            Type = GCEventStart,
+                                            Index = (ulong)GetPayload(eventData, "Count"),
+                                            Generation = (int)GetPayload(eventData, "Depth"),
+                                            Reason = (int)GetPayload(eventData, "Reason"),
+                                            Kind = (int)GetPayload(eventData, "Type"),
+                                        };
+                                        _inProgress[(long)evt.Index] = evt;
+                                        Invoke(&evt);
+                                        break;
+                                    }
+
+                                    case GCEndEventId:
+                                    {
+                                        long index = GetPayload(eventData, "Count");
+                                        if (!_inProgress.Remove(index, out GcEvent evt))
+                                        {
+                                            break;
+                                        }
+
+                                        evt.Type = GCEventEnd;
+
+                                        // The pause is only known when managed code is resumed.
+                                        if (_suspended)
+                                        {
+                                            _pendingEnd.Add(evt);
+                                        }
+                                        else
+                                        {
+                                            Invoke(&evt);
+                                        }
+                                        break;
+                                    }
+
+                                    case GCRestartEEEndEventId:
+                                    {
+                                        if (!_suspended)
+                                        {
+                                            break;
+                                        }
+
+                                        _suspended = false;
+                                        ulong pause = (ulong)((eventData.TimeStamp - _suspendStart).Ticks * 100);
+                                        foreach (GcEvent pending in _pendingEnd)
+                                        {
+                                            GcEvent evt = pending;
+                                            evt.PauseDurationNs = pause;
+                                            Invoke(&evt);
+                                        }
+
+                                        _pendingEnd.Clear();
+                                        break;
+                                    }
+                                }
+                            }
+
+                            private static long GetPayload(global::System.Diagnostics.Tracing.EventWrittenEventArgs eventData, string name)
+                            {
+                                int index = eventData.PayloadNames?.IndexOf(name) ?? -1;
+                                return index >= 0 ? global::System.Convert.ToInt64(eventData.Payload[index]) : 0;
+                            }
+                        }
+                    }
+                }
+
+                #endif
+                """);
+        });
+    }
+}
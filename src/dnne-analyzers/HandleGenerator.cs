@@ -0,0 +1,415 @@
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates a handle type for each class marked with <c>DNNE.HandleAttribute</c>.
+/// </summary>
+/// <remarks>
+/// The generated struct is named after the class with a <c>Handle</c> suffix and is marked with
+/// <c>DNNE.HandleTypeAttribute</c>, so dnne-gen declares a distinct native type for it. Each struct
+/// holds its own table of slots, so handles are allocated and resolved without the GC handle table.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class HandleGenerator : IIncrementalGenerator
+{
+    private const string HandleAttributeName = "DNNE.HandleAttribute";
+    private const string HandleTypeAttributeName = "DNNE.HandleTypeAttribute";
+
+    private static readonly DiagnosticDescriptor s_invalidHandleType = new(
+        id: "DNNE1005",
+        title: "Invalid handle type",
+        messageFormat: "Type '{0}' can't be passed to native code by handle: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<HandleType> types = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is ClassDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetHandleType(context, token))
+            .Where(static t => t is not null);
+
+        context.RegisterSourceOutput(types.Collect(), static (context, types) =>
+        {
+            // A partial class is seen once per declaration.
+            var hintNames = new HashSet<string>();
+            foreach (HandleType type in types)
+            {
+                if (type.Diagnostic is not null)
+                {
+                    context.ReportDiagnostic(type.Diagnostic);
+                    continue;
+                }
+
+                if (hintNames.Add(type.HintName))
+                {
+                    context.AddSource($"{type.HintName}.g.cs", type.Code);
+                }
+            }
+        });
+    }
+
+    private static HandleType GetHandleType(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not INamedTypeSymbol type)
+        {
+            return null;
+        }
+
+        AttributeData attribute = type.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == HandleAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        string hintName = type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat).Replace("global::", string.Empty);
+        string handleTypeName = $"{GetFlattenedName(type)}Handle";
+        string nativeName = attribute.NamedArguments
+            .Where(static a => a.Key == "Name")
+            .Select(static a => a.Value.Value as string)
+            .FirstOrDefault()
+            ?? $"{GetFlattenedName(type)}_handle";
+
+        string error = Validate(type, nativeName);
+        if (error is not null)
+        {
+            Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidHandleType, location,
+                type.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat), error);
+            return new HandleType(hintName, null, diagnostic);
+        }
+
+        return new HandleType(hintName, Emit(type, handleTypeName, nativeName), null);
+    }
+
+    private static string Validate(INamedTypeSymbol type, string nativeName)
+    {
+        if (type.IsStatic)
+        {
+            return "the type must not be static";
+        }
+
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            if (current.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the type and its containing types must be accessible within the assembly";
+            }
+
+            if (current.IsGenericType)
+            {
+                return "the type and its containing types must not be generic";
+            }
+        }
+
+        // The name is used as is in the C and Rust declarations.
+        if (!SyntaxFacts.IsValidIdentifier(nativeName) || nativeName.Any(static c => c > 0x7f))
+        {
+            return $"'{nativeName}' is not a valid native type name";
+        }
+
+        return null;
+    }
+
+    private static string Emit(INamedTypeSymbol type, string handleTypeName, string nativeName)
+    {
+        string @namespace = type.ContainingNamespace.IsGlobalNamespace ? null : type.ContainingNamespace.ToDisplayString();
+        string target = type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        string typeName = InstantiationGenerator.EscapeXml(type.ToDisplayString(SymbolDisplayFormat.MinimallyQualifiedFormat));
+
+        // The handle can appear in the signature of any export that can name the type.
+        string accessibility = "public";
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            if (current.DeclaredAccessibility != Accessibility.Public)
+            {
+                accessibility = "internal";
+            }
+        }
+
+        string code = $$"""
+                /// <summary>
+                /// Handle to a <c>{{typeName}}</c> instance, passed to native code as a <c>{{nativeName}}</c>.
+                /// </summary>
+                /// <remarks>
+                /// The default value is the null handle. A handle holds a slot index plus one in the low 32 bits and the
+                /// generation of the slot in the high 32 bits. Freeing a handle advances the generation of its slot, so a
+                /// stale handle no longer resolves once the slot is reused. Slots are allocated in fixed size slabs that
+                /// are never moved or released. Each thread keeps the slots it frees in its own free list, and exchanges
+                /// them with other threads in batches through a lock-free queue. The free slots of a thread that has exited
+                /// are queued when its free list is finalized. Freeing a handle while another thread is resolving it is a
+                /// race in the caller, as it is with a <c>GCHandle</c>.
+                /// </remarks>
+                [global::{{HandleTypeAttributeName}}("{{nativeName}}")]
+                [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                {{accessibility}} readonly struct {{handleTypeName}} : global::System.IEquatable<{{handleTypeName}}>
+                {
+                    private const int SlabShift = 10;
+                    private const int SlabSize = 1 << SlabShift;
+                    private const int BatchSize = 64;
+
+                    private static readonly object s_growLock = new object();
+                    private static readonly global::System.Collections.Concurrent.ConcurrentQueue<int[]> s_freeBatches = new global::System.Collections.Concurrent.ConcurrentQueue<int[]>();
+                    private static Slot[][] s_slabs = new Slot[4][];
+                    private static int s_slotCount;
+
+                    [global::System.ThreadStatic]
+                    private static FreeList t_freeList;
+
+                    private readonly ulong _value;
+
+                    private {{handleTypeName}}(ulong value)
+                    {
+                        _value = value;
+                    }
+
+                    /// <summary>
+                    /// Gets whether this is the null handle.
+                    /// </summary>
+                    public bool IsNull => _value == 0;
+
+                    /// <summary>
+                    /// Gets the instance referenced by the handle.
+                    /// </summary>
+                    /// <exception cref="global::System.ArgumentException">The handle is null or has been freed.</exception>
+                    public {{target}} Target
+                    {
+                        get
+                        {
+                            if (!TryGetTarget(out {{target}} target))
+                            {
+                                throw new global::System.ArgumentException("The handle is null or has been freed.");
+                            }
+
+                            return target;
+                        }
+                    }
+
+                    /// <summary>
+                    /// Allocates a handle to an instance.
+                    /// </summary>
+                    /// <param name="target">The instance referenced by the handle.</param>
+                    /// <returns>The new handle.</returns>
+                    public static {{handleTypeName}} Alloc({{target}} target)
+                    {
+                        if (target is null)
+                        {
+                            throw new global::System.ArgumentNullException(nameof(target));
+                        }
+
+                        FreeList freeList = t_freeList ??= new FreeList();
+                        int index;
+                        if (freeList.Count != 0)
+                        {
+                            index = freeList.Slots[--freeList.Count];
+                        }
+                        else if (s_freeBatches.TryDequeue(out int[] batch))
+                        {
+                            // Batches queued by exited threads can be smaller than BatchSize.
+                            global::System.Array.Copy(batch, freeList.Slots, batch.Length - 1);
+                            freeList.Count = batch.Length - 1;
+                            index = batch[batch.Length - 1];
+                        }
+                        else
+                        {
+                            index = AllocSlot();
+                        }
+
+                        ref Slot slot = ref GetSlot(index);
+                        slot.Target = target;
+                        return new {{handleTypeName}}(((ulong)slot.Generation << 32) | (uint)(index + 1));
+                    }
+
+                    /// <summary>
+                    /// Gets the instance referenced by the handle, if the handle is valid.
+                    /// </summary>
+                    /// <param name="target">The instance referenced by the handle.</param>
+                    /// <returns>True if the handle is valid, otherwise false.</returns>
+                    [global::System.Runtime.CompilerServices.MethodImpl(global::System.Runtime.CompilerServices.MethodImplOptions.AggressiveInlining)]
+                    public bool TryGetTarget(out {{target}} target)
+                    {
+                        // The null handle wraps to an index past the last slab.
+                        uint index = (uint)_value - 1;
+                        Slot[][] slabs = global::System.Threading.Volatile.Read(ref s_slabs);
+                        if ((index >> SlabShift) < (uint)slabs.Length && slabs[index >> SlabShift] is Slot[] slab)
+                        {
+                            ref Slot slot = ref slab[index & (SlabSize - 1)];
+                            if (slot.Generation == (uint)(_value >> 32))
+                            {
+                                target = slot.Target;
+                                return target is not null;
+                            }
+                        }
+
+                        target = null;
+                        return false;
+                    }
+
+                    /// <summary>
+                    /// Frees the handle. The instance is no longer referenced by the handle.
+                    /// </summary>
+                    /// <exception cref="global::System.ArgumentException">The handle is null or has already been freed.</exception>
+                    public void Free()
+                    {
+                        // Only one of several threads freeing the same handle advances the generation.
+                        int index = (int)(uint)_value - 1;
+                        uint generation = (uint)(_value >> 32);
+                        if (!TryGetTarget(out _)
+                            || global::System.Threading.Interlocked.CompareExchange(ref GetSlot(index).Generation, generation + 1, generation) != generation)
+                        {
+                            throw new global::System.ArgumentException("The handle is null or has already been freed.");
+                        }
+
+                        GetSlot(index).Target = null;
+
+                        FreeList freeList = t_freeList ??= new FreeList();
+                        freeList.Slots[freeList.Count++] = index;
+                        if (freeList.Count == freeList.Slots.Length)
+                        {
+                            // Share half of the free slots with threads that allocate more than they free.
+                            int[] batch = new int[BatchSize];
+                            global::System.Array.Copy(freeList.Slots, BatchSize, batch, 0, BatchSize);
+                            freeList.Count = BatchSize;
+                            s_freeBatches.Enqueue(batch);
+                        }
+                    }
+
+                    /// <inheritdoc/>
+                    public bool Equals({{handleTypeName}} other) => _value == other._value;
+
+                    /// <inheritdoc/>
+                    public override bool Equals(object obj) => obj is {{handleTypeName}} other && Equals(other);
+
+                    /// <inheritdoc/>
+                    public override int GetHashCode() => _value.GetHashCode();
+
+                    public static bool operator ==({{handleTypeName}} left, {{handleTypeName}} right) => left._value == right._value;
+
+                    public static bool operator !=({{handleTypeName}} left, {{handleTypeName}} right) => left._value != right._value;
+
+                    private static ref Slot GetSlot(int index)
+                    {
+                        return ref global::System.Threading.Volatile.Read(ref s_slabs)[index >> SlabShift][index & (SlabSize - 1)];
+                    }
+
+                    private static int AllocSlot()
+                    {
+                        int index = global::System.Threading.Interlocked.Increment(ref s_slotCount) - 1;
+                        if (index < 0)
+                        {
+                            throw new global::System.OutOfMemoryException();
+                        }
+
+                        // The thread that took the first slot of a slab may not have created it yet.
+                        Slot[][] slabs = global::System.Threading.Volatile.Read(ref s_slabs);
+                        if ((index >> SlabShift) >= slabs.Length || slabs[index >> SlabShift] is null)
+                        {
+                            AllocSlab(index >> SlabShift);
+                        }
+
+                        return index;
+                    }
+
+                    private static void AllocSlab(int slab)
+                    {
+                        lock (s_growLock)
+                        {
+                            Slot[][] slabs = s_slabs;
+                            if (slab >= slabs.Length)
+                            {
+                                // Existing slabs are shared with the larger array, so slots are never moved.
+                                global::System.Array.Resize(ref slabs, global::System.Math.Max(slabs.Length * 2, slab + 1));
+                            }
+
+                            if (slabs[slab] is null)
+                            {
+                                global::System.Threading.Volatile.Write(ref slabs[slab], new Slot[SlabSize]);
+                            }
+
+                            global::System.Threading.Volatile.Write(ref s_slabs, slabs);
+                        }
+                    }
+
+                    private struct Slot
+                    {
+                        public {{target}} Target;
+                        public uint Generation;
+                    }
+
+                    private sealed class FreeList
+                    {
+                        public readonly int[] Slots = new int[BatchSize * 2];
+                        public int Count;
+
+                        // Only unreachable once the owning thread has exited, so the slots are no longer used by it.
+                        ~FreeList()
+                        {
+                            if (Count != 0)
+                            {
+                                int[] batch = new int[Count];
+                                global::System.Array.Copy(Slots, batch, Count);
+                                s_freeBatches.Enqueue(batch);
+                            }
+                        }
+                    }
+                }
+            """;
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (@namespace is not null)
+        {
+            builder.AppendLine($"namespace {@namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine(code);
+
+        if (@namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private static string GetFlattenedName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return string.Join("_", names);
+    }
+
+    private sealed class HandleType
+    {
+        public HandleType(string hintName, string code, Diagnostic diagnostic)
+        {
+            HintName = hintName;
+            Code = code;
+            Diagnostic = diagnostic;
+        }
+
+        public string HintName { get; }
+
+        public string Code { get; }
+
+        public Diagnostic Diagnostic { get; }
+    }
+}
@@ -0,0 +1,308 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates a non-generic export for each <c>DNNE.InstantiateAttribute</c> on a generic method.
+/// </summary>
+/// <remarks>
+/// Generic methods can't be marked with <c>UnmanagedCallersOnlyAttribute</c>, so a wrapper is generated
+/// for each instantiation. The wrappers are placed in a type named after the declaring type with an
+/// <c>Instantiations</c> suffix and are exported by dnne-gen like any other method.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class InstantiationGenerator : IIncrementalGenerator
+{
+    private const string InstantiateAttributeName = "DNNE.InstantiateAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+
+    // DNNE attributes that are copied from the generic method to the generated export.
+    private static readonly HashSet<string> s_copiedAttributes = new()
+    {
+        "DNNE.C99DeclCodeAttribute",
+        "DNNE.C99TypeAttribute",
+        "DNNE.RustDeclCodeAttribute",
+        "DNNE.RustTypeAttribute",
+    };
+
+    private static readonly DiagnosticDescriptor s_invalidInstantiation = new(
+        id: "DNNE1001",
+        title: "Invalid generic method instantiation",
+        messageFormat: "Method '{0}' can't be instantiated for export: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<Instantiations> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { TypeParameterList: not null, AttributeLists.Count: > 0 },
+            static (context, token) => GetInstantiations(context, token))
+            .Where(static i => i is not null);
+
+        IncrementalValueProvider<(ImmutableArray<Instantiations> Methods, bool AllowUnsafe)> all = methods.Collect()
+            .Combine(context.CompilationProvider.Select(static (compilation, _) => compilation.Options is CSharpCompilationOptions { AllowUnsafe: true }));
+
+        context.RegisterSourceOutput(all, static (context, all) =>
+        {
+            var hintNames = new HashSet<string>();
+            foreach (Instantiations instantiations in all.Methods)
+            {
+                foreach (Diagnostic diagnostic in instantiations.Diagnostics)
+                {
+                    context.ReportDiagnostic(diagnostic);
+                }
+
+                if (instantiations.Exports.Length == 0)
+                {
+                    continue;
+                }
+
+                // Overloads are generated into separate files.
+                string hintName = $"{instantiations.ContainingTypeName}.{instantiations.MethodName}.Instantiations";
+                for (int i = 1; !hintNames.Add(hintName); ++i)
+                {
+                    hintName = $"{instantiations.ContainingTypeName}.{instantiations.MethodName}.Instantiations{i}";
+                }
+
+                context.AddSource($"{hintName}.g.cs", Emit(instantiations, all.AllowUnsafe));
+            }
+        });
+    }
+
+    private static Instantiations GetInstantiations(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        ImmutableArray<AttributeData> attributes = method.GetAttributes()
+            .Where(static a => a.AttributeClass?.ToDisplayString() == InstantiateAttributeName)
+            .ToImmutableArray();
+        if (attributes.IsEmpty)
+        {
+            return null;
+        }
+
+        var diagnostics = ImmutableArray.CreateBuilder<Diagnostic>();
+        var exports = ImmutableArray.CreateBuilder<string>();
+        string methodDisplayName = method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat);
+
+        string error = Validate(method, context.SemanticModel.Compilation);
+        foreach (AttributeData attribute in attributes)
+        {
+            Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+            if (error is not null)
+            {
+                diagnostics.Add(Diagnostic.Create(s_invalidInstantiation, location, methodDisplayName, error));
+                continue;
+            }
+
+            // The type arguments are supplied as a params array.
+            ImmutableArray<ITypeSymbol> typeArguments = attribute.ConstructorArguments
+                .SelectMany(static a => a.Kind == TypedConstantKind.Array ? a.Values : ImmutableArray.Create(a))
+                .Select(static a => a.Value as ITypeSymbol)
+                .Where(static t => t is not null)
+                .ToImmutableArray();
+            if (typeArguments.Length != method.TypeParameters.Length)
+            {
+                diagnostics.Add(Diagnostic.Create(s_invalidInstantiation, location, methodDisplayName,
+                    $"expected {method.TypeParameters.Length} type argument(s) but {typeArguments.Length} were supplied"));
+                continue;
+            }
+
+            string entryPoint = attribute.NamedArguments
+                .Where(static a => a.Key == "EntryPoint")
+                .Select(static a => a.Value.Value as string)
+                .FirstOrDefault()
+                ?? $"{method.Name}_{string.Join("_", typeArguments.Select(static t => t.Name))}";
+            if (!IsValidEntryPoint(entryPoint))
+            {
+                diagnostics.Add(Diagnostic.Create(s_invalidInstantiation, location, methodDisplayName,
+                    $"'{entryPoint}' is not a valid native export name"));
+                continue;
+            }
+
+            exports.Add(EmitExport(method, typeArguments, entryPoint));
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        return new Instantiations(
+            containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString(),
+            GetInstantiationsTypeName(containingType),
+            method.Name,
+            exports.ToImmutable(),
+            diagnostics.ToImmutable());
+    }
+
+    private static string Validate(IMethodSymbol method, Compilation compilation)
+    {
+        if (compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null)
+        {
+            return "UnmanagedCallersOnlyAttribute is not available in the target framework";
+        }
+
+        if (!method.IsStatic)
+        {
+            return "the method must be static";
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the method and its containing types must be accessible within the assembly";
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return "the containing types must not be generic";
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            return "by-reference parameters and returns are not supported";
+        }
+
+        return null;
+    }
+
+    private static string EmitExport(IMethodSymbol method, ImmutableArray<ITypeSymbol> typeArguments, string entryPoint)
+    {
+        IMethodSymbol instance = method.Construct(typeArguments.ToArray());
+        var builder = new StringBuilder();
+        string typeArgumentList = string.Join(", ", typeArguments.Select(static t => t.ToDisplayString(SymbolDisplayFormat.MinimallyQualifiedFormat)));
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Instantiation of <c>{EscapeXml(method.ContainingType.Name)}.{EscapeXml(method.Name)}&lt;{EscapeXml(typeArgumentList)}&gt;</c>.");
+        builder.AppendLine($"        /// </summary>");
+
+        foreach (string attribute in GetCopiedAttributes(method.GetAttributes()))
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint, quote: true)})]");
+        foreach (string attribute in GetCopiedAttributes(method.GetReturnTypeAttributes()))
+        {
+            builder.AppendLine($"        [return: {attribute.Substring(1)}");
+        }
+
+        string returnType = instance.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        IEnumerable<string> parameters = instance.Parameters.Select(static p =>
+            $"{string.Concat(GetCopiedAttributes(p.GetAttributes()).Select(static a => $"{a} "))}{p.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)} {EscapeIdentifier(p.Name)}");
+        builder.AppendLine($"        public static {returnType} {entryPoint}({string.Join(", ", parameters)})");
+        builder.AppendLine($"        {{");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{EscapeIdentifier(method.Name)}<{string.Join(", ", typeArguments.Select(static t => t.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)))}>({string.Join(", ", instance.Parameters.Select(static p => EscapeIdentifier(p.Name)))})";
+        builder.AppendLine(instance.ReturnsVoid ? $"            {call};" : $"            return {call};");
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    internal static IEnumerable<string> GetCopiedAttributes(ImmutableArray<AttributeData> attributes)
+    {
+        foreach (AttributeData attribute in attributes)
+        {
+            if (attribute.AttributeClass is null
+                || !s_copiedAttributes.Contains(attribute.AttributeClass.ToDisplayString())
+                || attribute.ConstructorArguments.Length != 1
+                || attribute.ConstructorArguments[0].Value is not string value)
+            {
+                continue;
+            }
+
+            yield return $"[global::{attribute.AttributeClass.ToDisplayString()}({SymbolDisplay.FormatLiteral(value, quote: true)})]";
+        }
+    }
+
+    private static string Emit(Instantiations instantiations, bool allowUnsafe)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (instantiations.Namespace is not null)
+        {
+            builder.AppendLine($"namespace {instantiations.Namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static {(allowUnsafe ? "unsafe " : string.Empty)}partial class {instantiations.ContainingTypeName}");
+        builder.AppendLine("    {");
+        builder.Append(string.Join(System.Environment.NewLine, instantiations.Exports));
+        builder.AppendLine("    }");
+
+        if (instantiations.Namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private static string GetInstantiationsTypeName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return $"{string.Join("_", names)}Instantiations";
+    }
+
+    internal static string EscapeIdentifier(string name)
+    {
+        return SyntaxFacts.GetKeywordKind(name) != SyntaxKind.None ? $"@{name}" : name;
+    }
+
+    /// <summary>
+    /// Determine if the name can be used as is for a native export and a C# method.
+    /// </summary>
+    internal static bool IsValidEntryPoint(string name)
+    {
+        return SyntaxFacts.IsValidIdentifier(name)
+            && SyntaxFacts.GetKeywordKind(name) == SyntaxKind.None
+            && name.All(static c => c is (>= 'a' and <= 'z') or (>= 'A' and <= 'Z') or (>= '0' and <= '9') or '_');
+    }
+
+    internal static string EscapeXml(string value)
+    {
+        return value.Replace("&", "&amp;").Replace("<", "&lt;").Replace(">", "&gt;");
+    }
+
+    private sealed class Instantiations
+    {
+        public Instantiations(string @namespace, string containingTypeName, string methodName, ImmutableArray<string> exports, ImmutableArray<Diagnostic> diagnostics)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            MethodName = methodName;
+            Exports = exports;
+            Diagnostics = diagnostics;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string MethodName { get; }
+
+        public ImmutableArray<string> Exports { get; }
+
+        public ImmutableArray<Diagnostic> Diagnostics { get; }
+    }
+}
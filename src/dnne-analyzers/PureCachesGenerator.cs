@@ -0,0 +1,154 @@
+using System.Linq;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates the managed side of the native caches of exports marked with <c>DNNE.PureAttribute</c>.
+/// </summary>
+/// <remarks>
+/// The native caches are keyed by an epoch owned by the generated <c>DNNE.PureCaches</c> type, so invalidating
+/// the caches from managed code doesn't call into native code. The platform layer resolves the generated method
+/// by name, it isn't a native export. Methods marked with <c>DNNE.PureAttribute</c> are also validated.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class PureCachesGenerator : IIncrementalGenerator
+{
+    private const string PureAttributeName = "DNNE.PureAttribute";
+    private const string ExportAttributeName = "DNNE.ExportAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+
+    private static readonly DiagnosticDescriptor s_invalidPureExport = new(
+        id: "DNNE1006",
+        title: "Invalid pure export",
+        messageFormat: "The results of method '{0}' can't be cached: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        context.RegisterPostInitializationOutput(static context =>
+        {
+            context.AddSource("DnnePureCaches.g.cs", """
+                // <auto-generated/>
+                #pragma warning disable
+                #if NET5_0_OR_GREATER
+
+                namespace DNNE
+                {
+                    /// <summary>
+                    /// Invalidates the native caches of exports marked with <see cref="PureAttribute"/>.
+                    /// </summary>
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal static class PureCaches
+                    {
+                        // Results cached in an earlier epoch aren't used. The native caches
+                        // read the epoch in place, so it is allocated on the pinned object heap.
+                        private static readonly long[] s_epoch = CreateEpoch();
+
+                        /// <summary>
+                        /// Invalidates the results cached by all exports marked with <see cref="PureAttribute"/>.
+                        /// </summary>
+                        /// <remarks>
+                        /// Call after changing data the results depend on. Calls that begin afterwards don't return an earlier result.
+                        /// </remarks>
+                        public static void Invalidate()
+                        {
+                            global::System.Threading.Interlocked.Increment(ref s_epoch[0]);
+                        }
+
+                        private static long[] CreateEpoch()
+                        {
+                            // The native caches treat an epoch of 0 as unregistered.
+                            long[] epoch = global::System.GC.AllocateArray<long>(1, pinned: true);
+                            epoch[0] = 1;
+                            return epoch;
+                        }
+
+                        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                        private static global::System.IntPtr Register()
+                        {
+                            return global::System.Runtime.InteropServices.Marshal.UnsafeAddrOfPinnedArrayElement(s_epoch, 0);
+                        }
+                    }
+                }
+
+                #endif
+                """);
+        });
+
+        IncrementalValuesProvider<Diagnostic> diagnostics = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => Validate(context, token))
+            .Where(static d => d is not null);
+
+        context.RegisterSourceOutput(diagnostics, static (context, diagnostic) => context.ReportDiagnostic(diagnostic));
+    }
+
+    private static Diagnostic Validate(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == PureAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        string error = null;
+        if (!method.GetAttributes().Any(static a => a.AttributeClass?.ToDisplayString() is ExportAttributeName or UnmanagedCallersOnlyAttributeName))
+        {
+            error = "the method must be exported";
+        }
+        else if (attribute.NamedArguments.Any(static a => a.Key == "CacheSize" && a.Value.Value is int size && size <= 0))
+        {
+            error = "the cache size must be positive";
+        }
+        else if (method.ReturnsVoid)
+        {
+            error = "the method must return a value";
+        }
+        else if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            error = "by-reference parameters and returns are not supported";
+        }
+        else if (method.Parameters.Any(static p => !IsCacheableType(p.Type)) || !IsCacheableType(method.ReturnType))
+        {
+            // Each argument is part of the key, so values with identity such as pointers aren't allowed.
+            error = "the arguments and return value must be fixed-size integers or floating point values";
+        }
+
+        if (error is null)
+        {
+            return null;
+        }
+
+        Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+        return Diagnostic.Create(s_invalidPureExport, location,
+            method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat), error);
+    }
+
+    // Matches the types dnne-gen caches, C99Emitter.s_pureCacheableTypes and RustEmitter.s_pureCacheableTypes.
+    // nint and nuint usually hold addresses, and bool and char aren't blittable.
+    private static bool IsCacheableType(ITypeSymbol type)
+    {
+        return type.SpecialType is SpecialType.System_SByte
+            or SpecialType.System_Byte
+            or SpecialType.System_Int16
+            or SpecialType.System_UInt16
+            or SpecialType.System_Int32
+            or SpecialType.System_UInt32
+            or SpecialType.System_Int64
+            or SpecialType.System_UInt64
+            or SpecialType.System_Single
+            or SpecialType.System_Double;
+    }
+}
@@ -0,0 +1,454 @@
+using System;
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates an export, and a dispatch index, for each method marked with <c>DNNE.RemoteExportAttribute</c>.
+/// </summary>
+/// <remarks>
+/// The generated export is marked with <c>DNNE.RemoteIndexAttribute</c>. When the native binary is built with
+/// <c>DnneOutOfProcess</c>, dnne-gen copies the arguments of the export into a payload and the shared server passes
+/// it to the generated <c>DNNE.RemoteExports</c> type, which calls the method directly and catches any exception.
+/// Indices are assigned in entry point order. The exports are placed in a type named after the declaring type
+/// with a <c>RemoteExports</c> suffix.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class RemoteExportGenerator : IIncrementalGenerator
+{
+    private const string RemoteExportAttributeName = "DNNE.RemoteExportAttribute";
+    private const string RemoteIndexAttributeName = "DNNE.RemoteIndexAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+    private const string IndexPlaceholder = "__DNNE_REMOTE_INDEX__";
+
+    // Size of the payload copied to the server, must match C99Emitter.RemotePayloadSize in dnne-gen.
+    private const int RemotePayloadSize = 240;
+
+    private static readonly DiagnosticDescriptor s_invalidRemoteExport = new(
+        id: "DNNE1007",
+        title: "Invalid remote export",
+        messageFormat: "Method '{0}' can't be called from another process: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<RemoteExport> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetRemoteExport(context, token))
+            .Where(static e => e is not null);
+
+        context.RegisterSourceOutput(methods.Collect(), static (context, exports) =>
+        {
+            var entryPoints = new Dictionary<string, string>();
+            var remotes = new List<RemoteExport>();
+            foreach (RemoteExport export in exports.OrderBy(static e => e.EntryPoint, StringComparer.Ordinal).ThenBy(static e => e.Target, StringComparer.Ordinal))
+            {
+                if (export.Diagnostic is not null)
+                {
+                    context.ReportDiagnostic(export.Diagnostic);
+                    continue;
+                }
+
+                // Overloads default to the same entry point, which would export duplicate symbols.
+                if (entryPoints.TryGetValue(export.EntryPoint, out string existing))
+                {
+                    context.ReportDiagnostic(Diagnostic.Create(s_invalidRemoteExport, export.Location, export.MethodDisplayName,
+                        $"the export name '{export.EntryPoint}' is already used by '{existing}', set a unique EntryPoint"));
+                    continue;
+                }
+
+                entryPoints.Add(export.EntryPoint, export.MethodDisplayName);
+                remotes.Add(export);
+            }
+
+            if (remotes.Count == 0)
+            {
+                return;
+            }
+
+            var hintNames = new HashSet<string>();
+            for (int i = 0; i < remotes.Count; ++i)
+            {
+                RemoteExport export = remotes[i];
+
+                // Overloads are generated into separate files.
+                string hintName = $"{export.ContainingTypeName}.{export.MethodName}";
+                for (int j = 1; !hintNames.Add(hintName); ++j)
+                {
+                    hintName = $"{export.ContainingTypeName}.{export.MethodName}{j}";
+                }
+
+                context.AddSource($"{hintName}.g.cs", Emit(export, index: i + 1));
+            }
+
+            context.AddSource("DnneRemoteExports.g.cs", EmitRemoteExports(remotes));
+        });
+    }
+
+    private static RemoteExport GetRemoteExport(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == RemoteExportAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        string @namespace = containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString();
+        string containingTypeName = GetRemoteExportsTypeName(containingType);
+        string methodDisplayName = method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat);
+        Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+
+        string entryPoint = attribute.NamedArguments
+            .Where(static a => a.Key == "EntryPoint")
+            .Select(static a => a.Value.Value as string)
+            .FirstOrDefault()
+            ?? method.Name;
+
+        string error = Validate(method, context.SemanticModel.Compilation);
+        if (error is null && !InstantiationGenerator.IsValidEntryPoint(entryPoint))
+        {
+            error = $"'{entryPoint}' is not a valid native export name";
+        }
+
+        string target = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}";
+        if (error is not null)
+        {
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidRemoteExport, location, methodDisplayName, error);
+            return new RemoteExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, target, null, ImmutableArray<string>.Empty, null, diagnostic);
+        }
+
+        string returnType = method.ReturnsVoid ? null : method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        ImmutableArray<string> parameterTypes = method.Parameters
+            .Select(static p => p.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat))
+            .ToImmutableArray();
+
+        return new RemoteExport(@namespace, containingTypeName, method.Name, methodDisplayName, entryPoint, location, target, returnType, parameterTypes, EmitExport(method, entryPoint), null);
+    }
+
+    private static string Validate(IMethodSymbol method, Compilation compilation)
+    {
+        if (compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null)
+        {
+            return "UnmanagedCallersOnlyAttribute is not available in the target framework";
+        }
+
+        if (compilation.Options is not CSharpCompilationOptions { AllowUnsafe: true })
+        {
+            return "unsafe code must be allowed in the project";
+        }
+
+        if (!method.IsStatic || method.IsGenericMethod)
+        {
+            return "the method must be static and non-generic";
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the method and its containing types must be accessible within the assembly";
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return "the containing types must not be generic";
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            return "by-reference parameters and returns are not supported";
+        }
+
+        // Values are copied to the server, an address or handle is meaningless there.
+        if (method.Parameters.Any(static p => !IsRemoteType(p.Type)) || (!method.ReturnsVoid && !IsRemoteType(method.ReturnType)))
+        {
+            return "the arguments and return value must be integers, floating point values or enums, pointers and pointer-sized integers are not allowed";
+        }
+
+        IEnumerable<ITypeSymbol> members = method.Parameters.Select(static p => p.Type);
+        if (!method.ReturnsVoid)
+        {
+            members = members.Append(method.ReturnType);
+        }
+
+        // Each member is aligned to its size, like the payload struct dnne-gen emits.
+        int size = 0;
+        foreach (ITypeSymbol member in members)
+        {
+            int memberSize = GetRemoteTypeSize(member);
+            size = (size + memberSize - 1) / memberSize * memberSize + memberSize;
+        }
+
+        if (size > RemotePayloadSize)
+        {
+            return $"the arguments and return value must fit in {RemotePayloadSize} bytes, including padding";
+        }
+
+        return null;
+    }
+
+    private static int GetRemoteTypeSize(ITypeSymbol type)
+    {
+        if (type is INamedTypeSymbol { TypeKind: TypeKind.Enum } named)
+        {
+            type = named.EnumUnderlyingType;
+        }
+
+        return type.SpecialType switch
+        {
+            SpecialType.System_SByte or SpecialType.System_Byte => 1,
+            SpecialType.System_Int16 or SpecialType.System_UInt16 => 2,
+            SpecialType.System_Int32 or SpecialType.System_UInt32 or SpecialType.System_Single => 4,
+            _ => 8,
+        };
+    }
+
+    private static bool IsRemoteType(ITypeSymbol type)
+    {
+        if (type is INamedTypeSymbol { TypeKind: TypeKind.Enum } named)
+        {
+            type = named.EnumUnderlyingType;
+        }
+
+        return type?.SpecialType is SpecialType.System_SByte
+            or SpecialType.System_Byte
+            or SpecialType.System_Int16
+            or SpecialType.System_UInt16
+            or SpecialType.System_Int32
+            or SpecialType.System_UInt32
+            or SpecialType.System_Int64
+            or SpecialType.System_UInt64
+            or SpecialType.System_Single
+            or SpecialType.System_Double;
+    }
+
+    private static string EmitExport(IMethodSymbol method, string entryPoint)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Export of <c>{InstantiationGenerator.EscapeXml(method.ContainingType.Name)}.{InstantiationGenerator.EscapeXml(method.Name)}</c> that can run in a shared server process.");
+        builder.AppendLine($"        /// </summary>");
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetAttributes()))
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        // The index is assigned once every remote export is known.
+        builder.AppendLine($"        [global::{RemoteIndexAttributeName}({IndexPlaceholder})]");
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint, quote: true)})]");
+
+        var parameters = new List<string>();
+        foreach (IParameterSymbol parameter in method.Parameters)
+        {
+            string attributes = string.Concat(InstantiationGenerator.GetCopiedAttributes(parameter.GetAttributes()).Select(static a => $"{a} "));
+            parameters.Add($"{attributes}{parameter.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)} {InstantiationGenerator.EscapeIdentifier(parameter.Name)}");
+        }
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetReturnTypeAttributes()))
+        {
+            builder.AppendLine($"        [return: {attribute.Substring(1)}");
+        }
+
+        string returnType = method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        builder.AppendLine($"        public static {returnType} {entryPoint}({string.Join(", ", parameters)})");
+        builder.AppendLine($"        {{");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}({string.Join(", ", method.Parameters.Select(static p => InstantiationGenerator.EscapeIdentifier(p.Name)))})";
+        builder.AppendLine(method.ReturnsVoid ? $"            {call};" : $"            return {call};");
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    private static string Emit(RemoteExport export, int index)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine($"namespace {export.Namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static unsafe partial class {export.ContainingTypeName}");
+        builder.AppendLine("    {");
+        builder.Append(export.Code.Replace(IndexPlaceholder, index.ToString()));
+        builder.AppendLine("    }");
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private static string EmitRemoteExports(List<RemoteExport> remotes)
+    {
+        var payloads = new StringBuilder();
+        var cases = new StringBuilder();
+        for (int i = 0; i < remotes.Count; ++i)
+        {
+            RemoteExport remote = remotes[i];
+            int index = i + 1;
+            string arguments = string.Join(", ", remote.ParameterTypes.Select((_, j) => $"args->Arg{j}"));
+            string call = $"{remote.Target}({arguments})";
+
+            cases.AppendLine($"                    case {index}:");
+            if (remote.ParameterTypes.Length == 0 && remote.ReturnType is null)
+            {
+                cases.AppendLine($"                        {call};");
+                cases.AppendLine($"                        return 0;");
+                continue;
+            }
+
+            // Matches the payload struct dnne-gen defines for the export.
+            payloads.AppendLine($"        [global::System.Runtime.InteropServices.StructLayout(global::System.Runtime.InteropServices.LayoutKind.Sequential)]");
+            payloads.AppendLine($"        private struct Payload{index}");
+            payloads.AppendLine($"        {{");
+            for (int j = 0; j < remote.ParameterTypes.Length; ++j)
+            {
+                payloads.AppendLine($"            public {remote.ParameterTypes[j]} Arg{j};");
+            }
+
+            if (remote.ReturnType is not null)
+            {
+                payloads.AppendLine($"            public {remote.ReturnType} Ret;");
+            }
+
+            payloads.AppendLine($"        }}");
+            payloads.AppendLine();
+
+            cases.AppendLine($"                    {{");
+            cases.AppendLine($"                        Payload{index}* args = (Payload{index}*)payload;");
+            cases.AppendLine(remote.ReturnType is null
+                ? $"                        {call};"
+                : $"                        args->Ret = {call};");
+            cases.AppendLine($"                        return 0;");
+            cases.AppendLine($"                    }}");
+        }
+
+        return $$"""
+            // <auto-generated/>
+            #pragma warning disable
+
+            namespace DNNE
+            {
+                /// <summary>
+                /// Runs calls to exports marked with <see cref="RemoteExportAttribute"/> in the shared server process.
+                /// </summary>
+                /// <remarks>
+                /// The payload holds the arguments in order followed by the return value, if any, laid out as a C struct.
+                /// </remarks>
+                [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                internal static unsafe class RemoteExports
+                {
+            {{payloads}}        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                    private static int Dispatch(int index, void* payload)
+                    {
+                        try
+                        {
+                            switch (index)
+                            {
+            {{cases}}                    default:
+                                    return new global::System.ArgumentException(null, nameof(index)).HResult;
+                            }
+                        }
+                        catch (global::System.Exception e)
+                        {
+                            // The exception is reported to the calling process, the server keeps running.
+                            return e.HResult;
+                        }
+                    }
+                }
+            }
+            """;
+    }
+
+    private static string GetRemoteExportsTypeName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return $"{string.Join("_", names)}RemoteExports";
+    }
+
+    private sealed class RemoteExport
+    {
+        public RemoteExport(
+            string @namespace,
+            string containingTypeName,
+            string methodName,
+            string methodDisplayName,
+            string entryPoint,
+            Location location,
+            string target,
+            string returnType,
+            ImmutableArray<string> parameterTypes,
+            string code,
+            Diagnostic diagnostic)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            MethodName = methodName;
+            MethodDisplayName = methodDisplayName;
+            EntryPoint = entryPoint;
+            Location = location;
+            Target = target;
+            ReturnType = returnType;
+            ParameterTypes = parameterTypes;
+            Code = code;
+            Diagnostic = diagnostic;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string MethodName { get; }
+
+        public string MethodDisplayName { get; }
+
+        public string EntryPoint { get; }
+
+        public Location Location { get; }
+
+        // Fully qualified name of the method called by the dispatcher.
+        public string Target { get; }
+
+        // Null if the method returns void.
+        public string ReturnType { get; }
+
+        public ImmutableArray<string> ParameterTypes { get; }
+
+        public string Code { get; }
+
+        public Diagnostic Diagnostic { get; }
+    }
+}
@@ -0,0 +1,102 @@
+using Microsoft.CodeAnalysis;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates the managed implementation of the native <c>dnne_get_runtime_metrics()</c>.
+/// </summary>
+/// <remarks>
+/// The platform layer resolves the generated method by name, it isn't a native export.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class RuntimeMetricsGenerator : IIncrementalGenerator
+{
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        context.RegisterPostInitializationOutput(static context =>
+        {
+            context.AddSource("DnneRuntimeMetrics.g.cs", """
+                // <auto-generated/>
+                #pragma warning disable
+                #if NET5_0_OR_GREATER
+
+                namespace DNNE
+                {
+                    /// <summary>
+                    /// Populates the native <c>dnne_runtime_metrics</c> structure.
+                    /// </summary>
+                    [global::System.Diagnostics.CodeAnalysis.ExcludeFromCodeCoverage]
+                    internal static class RuntimeMetrics
+                    {
+                        // Offset of the first field after the size and reserved fields in dnne_runtime_metrics.
+                        // The reserved field fixes the layout on every ABI, the platform layer checks it at compile time.
+                        private const int FirstFieldOffset = 8;
+
+                        [global::System.Runtime.InteropServices.UnmanagedCallersOnly]
+                        private static int Get(global::System.IntPtr metrics)
+                        {
+                            try
+                            {
+                                // Fields beyond the size supplied by the caller aren't written.
+                                int size = global::System.Runtime.InteropServices.Marshal.ReadInt32(metrics);
+                                int offset = FirstFieldOffset;
+
+                                global::System.GCMemoryInfo info = global::System.GC.GetGCMemoryInfo();
+                                Write(metrics, size, ref offset, info.HeapSizeBytes);
+                                global::System.ReadOnlySpan<global::System.GCGenerationInfo> generations = info.GenerationInfo;
+                                for (int i = 0; i < 5; ++i)
+                                {
+                                    Write(metrics, size, ref offset, i < generations.Length ? generations[i].SizeAfterBytes : 0);
+                                }
+
+                                Write(metrics, size, ref offset, global::System.GC.GetTotalAllocatedBytes(precise: false));
+                                for (int i = 0; i < 3; ++i)
+                                {
+                                    Write(metrics, size, ref offset, global::System.GC.CollectionCount(i));
+                                }
+
+                #if NET7_0_OR_GREATER
+                                Write(metrics, size, ref offset, global::System.GC.GetTotalPauseDuration().Ticks * 100);
+                #else
+                                Write(metrics, size, ref offset, 0);
+                #endif
+
+                #if NET6_0_OR_GREATER
+                                Write(metrics, size, ref offset, global::System.Runtime.JitInfo.GetCompiledMethodCount());
+                                Write(metrics, size, ref offset, global::System.Runtime.JitInfo.GetCompiledILBytes());
+                                Write(metrics, size, ref offset, global::System.Runtime.JitInfo.GetCompilationTime().Ticks * 100);
+                #else
+                                Write(metrics, size, ref offset, 0);
+                                Write(metrics, size, ref offset, 0);
+                                Write(metrics, size, ref offset, 0);
+                #endif
+
+                                Write(metrics, size, ref offset, global::System.Threading.ThreadPool.ThreadCount);
+                                Write(metrics, size, ref offset, global::System.Threading.ThreadPool.PendingWorkItemCount);
+                                Write(metrics, size, ref offset, global::System.Threading.ThreadPool.CompletedWorkItemCount);
+                                return 0;
+                            }
+                            catch (global::System.Exception e)
+                            {
+                                return e.HResult;
+                            }
+                        }
+
+                        private static void Write(global::System.IntPtr metrics, int size, ref int offset, long value)
+                        {
+                            if (offset + sizeof(long) <= size)
+                            {
+                                global::System.Runtime.InteropServices.Marshal.WriteInt64(metrics, offset, value);
+                            }
+
+                            offset += sizeof(long);
+                        }
+                    }
+                }
+
+                #endif
+                """);
+        });
+    }
+}
@@ -0,0 +1,290 @@
+using System.Collections.Generic;
+using System.Collections.Immutable;
+using System.Linq;
+using System.Text;
+using System.Threading;
+using Microsoft.CodeAnalysis;
+using Microsoft.CodeAnalysis.CSharp;
+using Microsoft.CodeAnalysis.CSharp.Syntax;
+
+namespace DNNE;
+
+/// <summary>
+/// A generator that generates an export for each method marked with <c>DNNE.VectorExportAttribute</c>.
+/// </summary>
+/// <remarks>
+/// The runtime doesn't support <c>Vector128&lt;T&gt;</c> or <c>Vector256&lt;T&gt;</c> by value in the signature of a
+/// method marked with <c>UnmanagedCallersOnlyAttribute</c>. The generated export accepts each vector by address
+/// and marks it with <c>DNNE.VectorByValueAttribute</c> so dnne-gen declares the native export with the vector
+/// passed by value. The exports are placed in a type named after the declaring type with a <c>VectorExports</c> suffix.
+/// </remarks>
+[Generator(LanguageNames.CSharp)]
+public sealed class VectorExportGenerator : IIncrementalGenerator
+{
+    private const string VectorExportAttributeName = "DNNE.VectorExportAttribute";
+    private const string VectorByValueAttributeName = "DNNE.VectorByValueAttribute";
+    private const string UnmanagedCallersOnlyAttributeName = "System.Runtime.InteropServices.UnmanagedCallersOnlyAttribute";
+    private const string ReturnParameterName = "__dnne_ret";
+
+    private static readonly HashSet<string> s_vectorTypes = new()
+    {
+        "System.Runtime.Intrinsics.Vector128<T>",
+        "System.Runtime.Intrinsics.Vector256<T>",
+    };
+
+    private static readonly DiagnosticDescriptor s_invalidVectorExport = new(
+        id: "DNNE1002",
+        title: "Invalid vector export",
+        messageFormat: "Method '{0}' can't be exported with vector arguments: {1}",
+        category: "DNNE",
+        defaultSeverity: DiagnosticSeverity.Error,
+        isEnabledByDefault: true);
+
+    /// <inheritdoc/>
+    public void Initialize(IncrementalGeneratorInitializationContext context)
+    {
+        IncrementalValuesProvider<VectorExport> methods = context.SyntaxProvider.CreateSyntaxProvider(
+            static (node, _) => node is MethodDeclarationSyntax { AttributeLists.Count: > 0 },
+            static (context, token) => GetVectorExport(context, token))
+            .Where(static e => e is not null);
+
+        context.RegisterSourceOutput(methods.Collect(), static (context, exports) =>
+        {
+            var hintNames = new HashSet<string>();
+            foreach (VectorExport export in exports)
+            {
+                if (export.Diagnostic is not null)
+                {
+                    context.ReportDiagnostic(export.Diagnostic);
+                    continue;
+                }
+
+                // Overloads are generated into separate files.
+                string hintName = $"{export.ContainingTypeName}.{export.MethodName}";
+                for (int i = 1; !hintNames.Add(hintName); ++i)
+                {
+                    hintName = $"{export.ContainingTypeName}.{export.MethodName}{i}";
+                }
+
+                context.AddSource($"{hintName}.g.cs", Emit(export));
+            }
+        });
+    }
+
+    private static VectorExport GetVectorExport(GeneratorSyntaxContext context, CancellationToken token)
+    {
+        if (context.SemanticModel.GetDeclaredSymbol(context.Node, token) is not IMethodSymbol method)
+        {
+            return null;
+        }
+
+        AttributeData attribute = method.GetAttributes()
+            .FirstOrDefault(static a => a.AttributeClass?.ToDisplayString() == VectorExportAttributeName);
+        if (attribute is null)
+        {
+            return null;
+        }
+
+        INamedTypeSymbol containingType = method.ContainingType;
+        string @namespace = containingType.ContainingNamespace.IsGlobalNamespace ? null : containingType.ContainingNamespace.ToDisplayString();
+        string containingTypeName = GetVectorExportsTypeName(containingType);
+
+        string error = Validate(method, context.SemanticModel.Compilation);
+        if (error is not null)
+        {
+            Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidVectorExport, location,
+                method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat), error);
+            return new VectorExport(@namespace, containingTypeName, method.Name, null, diagnostic);
+        }
+
+        string entryPoint = attribute.NamedArguments
+            .Where(static a => a.Key == "EntryPoint")
+            .Select(static a => a.Value.Value as string)
+            .FirstOrDefault()
+            ?? method.Name;
+        if (!InstantiationGenerator.IsValidEntryPoint(entryPoint))
+        {
+            Location location = attribute.ApplicationSyntaxReference?.GetSyntax(token).GetLocation();
+            Diagnostic diagnostic = Diagnostic.Create(s_invalidVectorExport, location,
+                method.ToDisplayString(SymbolDisplayFormat.CSharpShortErrorMessageFormat), $"'{entryPoint}' is not a valid native export name");
+            return new VectorExport(@namespace, containingTypeName, method.Name, null, diagnostic);
+        }
+
+        return new VectorExport(@namespace, containingTypeName, method.Name, EmitExport(method, entryPoint), null);
+    }
+
+    private static string Validate(IMethodSymbol method, Compilation compilation)
+    {
+        if (compilation.GetTypeByMetadataName(UnmanagedCallersOnlyAttributeName) is null)
+        {
+            return "UnmanagedCallersOnlyAttribute is not available in the target framework";
+        }
+
+        if (compilation.Options is not CSharpCompilationOptions { AllowUnsafe: true })
+        {
+            return "unsafe code must be allowed in the project";
+        }
+
+        if (!method.IsStatic || method.IsGenericMethod)
+        {
+            return "the method must be static and non-generic";
+        }
+
+        for (ISymbol symbol = method; symbol is not null and not INamespaceSymbol; symbol = symbol.ContainingSymbol)
+        {
+            if (symbol.DeclaredAccessibility is Accessibility.Private or Accessibility.Protected or Accessibility.ProtectedAndInternal)
+            {
+                return "the method and its containing types must be accessible within the assembly";
+            }
+
+            if (symbol is INamedTypeSymbol { IsGenericType: true })
+            {
+                return "the containing types must not be generic";
+            }
+        }
+
+        if (method.Parameters.Any(static p => p.RefKind != RefKind.None) || method.ReturnsByRef || method.ReturnsByRefReadonly)
+        {
+            return "by-reference parameters and returns are not supported";
+        }
+
+        if (!method.Parameters.Any(static p => IsVectorType(p.Type)) && !IsVectorType(method.ReturnType))
+        {
+            return "the method has no Vector128<T> or Vector256<T> arguments or return value";
+        }
+
+        return null;
+    }
+
+    private static string EmitExport(IMethodSymbol method, string entryPoint)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine($"        /// <summary>");
+        builder.AppendLine($"        /// Export of <c>{InstantiationGenerator.EscapeXml(method.ContainingType.Name)}.{InstantiationGenerator.EscapeXml(method.Name)}</c> with vectors passed by address.");
+        builder.AppendLine($"        /// </summary>");
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetAttributes()))
+        {
+            builder.AppendLine($"        {attribute}");
+        }
+
+        builder.AppendLine($"        [global::{UnmanagedCallersOnlyAttributeName}(EntryPoint = {SymbolDisplay.FormatLiteral(entryPoint, quote: true)})]");
+
+        bool returnsVector = IsVectorType(method.ReturnType);
+        var parameters = new List<string>();
+        var arguments = new List<string>();
+        foreach (IParameterSymbol parameter in method.Parameters)
+        {
+            string attributes = string.Concat(InstantiationGenerator.GetCopiedAttributes(parameter.GetAttributes()).Select(static a => $"{a} "));
+            string type = parameter.Type.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+            string name = InstantiationGenerator.EscapeIdentifier(parameter.Name);
+            if (IsVectorType(parameter.Type))
+            {
+                parameters.Add($"{attributes}[global::{VectorByValueAttributeName}] {type}* {name}");
+                arguments.Add($"*{name}");
+            }
+            else
+            {
+                parameters.Add($"{attributes}{type} {name}");
+                arguments.Add(name);
+            }
+        }
+
+        foreach (string attribute in InstantiationGenerator.GetCopiedAttributes(method.GetReturnTypeAttributes()))
+        {
+            builder.AppendLine($"        [return: {attribute.Substring(1)}");
+        }
+
+        string returnType = method.ReturnType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat);
+        if (returnsVector)
+        {
+            // The return value is written through a trailing argument.
+            builder.AppendLine($"        [return: global::{VectorByValueAttributeName}]");
+            parameters.Add($"[global::{VectorByValueAttributeName}] {returnType}* {ReturnParameterName}");
+        }
+
+        builder.AppendLine($"        public static {(returnsVector ? "void" : returnType)} {entryPoint}({string.Join(", ", parameters)})");
+        builder.AppendLine($"        {{");
+
+        string call = $"{method.ContainingType.ToDisplayString(SymbolDisplayFormat.FullyQualifiedFormat)}.{InstantiationGenerator.EscapeIdentifier(method.Name)}({string.Join(", ", arguments)})";
+        if (returnsVector)
+        {
+            builder.AppendLine($"            *{ReturnParameterName} = {call};");
+        }
+        else
+        {
+            builder.AppendLine(method.ReturnsVoid ? $"            {call};" : $"            return {call};");
+        }
+
+        builder.AppendLine($"        }}");
+
+        return builder.ToString();
+    }
+
+    private static string Emit(VectorExport export)
+    {
+        var builder = new StringBuilder();
+        builder.AppendLine("// <auto-generated/>");
+        builder.AppendLine("#pragma warning disable");
+        builder.AppendLine();
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine($"namespace {export.Namespace}");
+            builder.AppendLine("{");
+        }
+
+        builder.AppendLine($"    internal static unsafe partial class {export.ContainingTypeName}");
+        builder.AppendLine("    {");
+        builder.Append(export.Code);
+        builder.AppendLine("    }");
+
+        if (export.Namespace is not null)
+        {
+            builder.AppendLine("}");
+        }
+
+        return builder.ToString();
+    }
+
+    private static bool IsVectorType(ITypeSymbol type)
+    {
+        return type is INamedTypeSymbol { IsGenericType: true } named
+            && s_vectorTypes.Contains(named.OriginalDefinition.ToDisplayString());
+    }
+
+    private static string GetVectorExportsTypeName(INamedTypeSymbol type)
+    {
+        // Nested types are flattened into a single top-level type name.
+        var names = new List<string>();
+        for (INamedTypeSymbol current = type; current is not null; current = current.ContainingType)
+        {
+            names.Insert(0, current.Name);
+        }
+
+        return $"{string.Join("_", names)}VectorExports";
+    }
+
+    private sealed class VectorExport
+    {
+        public VectorExport(string @namespace, string containingTypeName, string methodName, string code, Diagnostic diagnostic)
+        {
+            Namespace = @namespace;
+            ContainingTypeName = containingTypeName;
+            MethodName = methodName;
+            Code = code;
+            Diagnostic = diagnostic;
+        }
+
+        public string Namespace { get; }
+
+        public string ContainingTypeName { get; }
+
+        public string MethodName { get; }
+
+        public string Code { get; }
+
+        public Diagnostic Diagnostic { get; }
+    }
+}
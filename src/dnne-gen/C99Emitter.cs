@@ -18,9 +18,10 @@
 // SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
-using System.Collections.Specialized;
 using System.Diagnostics;
+using System.Globalization;
 using System.IO;
 using System.Linq;
 using System.Runtime.InteropServices;
@@ -35,13 +36,30 @@ namespace DNNE
         private const string SafeMacroRegEx = "[^a-zA-Z0-9_]";
         private static readonly C99TypeProvider s_typeProvider = new C99TypeProvider();
 
-        public static void Emit(TextWriter outputStream, string assemblyName, IEnumerable<ExportedMethod> exports, IEnumerable<string> additionalCodeStatements)
+        public static void Emit(TextWriter outputStream, string assemblyName, IEnumerable<ExportedMethod> exports, IEnumerable<ExportedData> data, IEnumerable<string> additionalCodeStatements, bool vector256Avx)
         {
             // Convert the assembly name into a supported string for C99 macros.
             var assemblyNameMacroSafe = Regex.Replace(assemblyName, SafeMacroRegEx, "_");
             var generatedHeaderDefine = $"__DNNE_GENERATED_HEADER_{assemblyNameMacroSafe.ToUpperInvariant()}__";
             var compileAsSourceDefine = "DNNE_COMPILE_AS_SOURCE";
 
+            // The vector ABI is fixed when the native binary is built, so it is defined here
+            // rather than left to the flags each consumer is compiled with.
+            string vectorAbiDefine = string.Empty;
+            string vectorAbiCheck = string.Empty;
+            if (vector256Avx)
+            {
+                vectorAbiDefine =
+@"// 256-bit vectors are passed in AVX registers.
+#define DNNE_VECTOR256_AVX
+";
+                vectorAbiCheck =
+@"#ifndef DNNE_NATIVE_M256
+    #error dnne.h was included before this header, without DNNE_VECTOR256_AVX defined.
+#endif
+";
+            }
+
             // Emit declaration preamble
             outputStream.WriteLine(
 $@"//
@@ -58,14 +76,14 @@ $@"//
 
 #include <stddef.h>
 #include <stdint.h>
-#ifdef {compileAsSourceDefine}
+{vectorAbiDefine}#ifdef {compileAsSourceDefine}
     #include <dnne.h>
 #else
     // When used as a header file, the assumption is
     // dnne.h will be next to this file.
     #include ""dnne.h""
 #endif // !{compileAsSourceDefine}
-");
+{vectorAbiCheck}");
 
             // Emit additional code statements
             if (additionalCodeStatements.Any())
@@ -82,10 +100,43 @@ $@"//
                 outputStream.WriteLine();
             }
 
-            using var implStream = new StringWriter();
+            // The output is written in a pass over the exports for each of the
+            // declarations, definitions and eager binding rather than buffered.
+            foreach (var export in exports)
+            {
+                (var preguard, var postguard) = GetPlatformGuards(export.Platforms);
+                (string declsig, _, _) = GetArgumentLists(export);
+                string callConv = s_typeProvider.MapCallConv(export.CallingConvention);
+
+                // Declare export
+                string signature = GetSignature(export);
+                outputStream.WriteLine(
+$@"{preguard}// Computed from {export.EnclosingTypeName}{Type.Delimiter}{export.MethodName}{export.XmlDoc}
+DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig});
+#define DNNE_SIGNATURE_HASH_{export.ExportName} UINT64_C(0x{ExportTable.SignatureHash(signature):x16}) // {signature}{GetRecordDeclaration(export, ";")}
+{postguard}");
+            }
+
+            // Declare exported data
+            foreach (var item in data)
+            {
+                (var preguard, var postguard) = GetPlatformGuards(item.Platforms);
+                string declaration = item.Constant is not null
+                    ? $"#define {item.ExportName} {FormatConstant(item.Constant)}"
+                    : $"DNNE_EXTERN_DATA DNNE_API const uint8_t {item.ExportName}[{item.Data.Length}];";
+                outputStream.WriteLine(
+$@"{preguard}// Computed from {item.EnclosingTypeName}{Type.Delimiter}{item.MemberName}{item.XmlDoc}
+{declaration}
+{postguard}");
+            }
+
+            // Emit declaration closing
+            outputStream.WriteLine(
+$@"#endif // {generatedHeaderDefine}
+");
 
             // Emit definition preamble
-            implStream.WriteLine(
+            outputStream.WriteLine(
 $@"//
 // Define exported functions
 //
@@ -113,62 +164,109 @@ extern void* get_callable_managed_function(
 extern void* get_fast_callable_managed_function(
     const char_t* dotnet_type,
     const char_t* dotnet_type_method);
+
+// Eager binding resolves every export when the runtime is preloaded and uses
+// GNU indirect functions so callers that bind to an export afterwards bypass the stub.
+// Probed and traced exports always call through the stub.
+#if defined(DNNE_EAGER_BINDING) && defined(__ELF__) && defined(__GLIBC__) && !defined(DNNE_USDT_PROBES) && !defined(DNNE_TRACING) && !defined(DNNE_OUT_OF_PROCESS)
+    #define DNNE_BIND_EAGERLY
+
+extern int try_get_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    const char_t* dotnet_delegate_type,
+    void** func);
+
+extern int try_get_fast_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    void** func);
+#endif // DNNE_BIND_EAGERLY
+
+#if defined(DNNE_USDT_PROBES) || defined(DNNE_TRACING)
+    #include <dnne_sdt.h>
+#endif // DNNE_USDT_PROBES || DNNE_TRACING
+
+// Timeline tracing records the entry and return of each export by export id, see platform.c.
+#if defined(DNNE_TRACING) && !defined(DNNE_WINDOWS)
+extern void dnne_trace_event(uint32_t event);
+
+    #define DNNE_TRACE_EXPORT_ENTRY(id) dnne_trace_event(id)
+    #define DNNE_TRACE_EXPORT_RETURN(id) dnne_trace_event((id) | UINT32_C(0x80000000))
+#else
+    #define DNNE_TRACE_EXPORT_ENTRY(id)
+    #define DNNE_TRACE_EXPORT_RETURN(id)
+#endif // DNNE_TRACING
+
+// Out-of-process dispatch sends calls to remote exports to a server process
+// shared by every process that loads this binary, see platform.c.
+#ifdef DNNE_OUT_OF_PROCESS
+extern __attribute__((visibility(""hidden""))) int dnne_remote_call(uint32_t index, void* payload, size_t payload_size);
+#endif // DNNE_OUT_OF_PROCESS
 ");
 
+            // The {export}_record functions append to a command buffer, see platform.c.
+            if (exports.Any(static e => e.CommandOpcode != 0))
+            {
+                outputStream.WriteLine(
+@"#include <string.h>
+
+extern uint64_t* dnne_command_buffer_append(dnne_command_buffer* buffer, uint32_t opcode, uint32_t slot_count);
+");
+            }
+
+            // Pure exports look up their results in a cache before calling the stub, see platform.c.
+            if (exports.Any(static e => e.PureCacheSize != 0))
+            {
+                outputStream.WriteLine(
+@"#include <string.h>
+
+extern int dnne_pure_cache_lookup(uint64_t* entries, uint32_t size, uint32_t key_count, const uint64_t* key, uint64_t* value, uint64_t* epoch);
+extern void dnne_pure_cache_store(uint64_t* entries, uint32_t size, uint32_t key_count, const uint64_t* key, uint64_t value, uint64_t epoch);
+");
+            }
+
             // Emit string table
-            implStream.WriteLine(
+            outputStream.WriteLine(
 @"//
 // String constants
 //
 ");
             int count = 1;
-            var map = new StringDictionary();
+            var map = new Dictionary<string, string>(StringComparer.Ordinal);
             foreach (var method in exports)
             {
-                if (map.ContainsKey(method.EnclosingTypeName))
+                if (map.ContainsKey(method.BindingTypeName))
                 {
                     continue;
                 }
 
                 string id = $"t{count++}_name";
-                implStream.WriteLine(
+                outputStream.WriteLine(
 $@"#ifdef DNNE_TARGET_NET_FRAMEWORK
-    static const char_t* {id} = DNNE_STR(""{method.EnclosingTypeName}"");
+    static const char_t* {id} = DNNE_STR(""{method.BindingTypeName}"");
 #else
-    static const char_t* {id} = DNNE_STR(""{method.EnclosingTypeName}, {assemblyName}"");
+    static const char_t* {id} = DNNE_STR(""{method.BindingTypeName}, {assemblyName}"");
 #endif // !DNNE_TARGET_NET_FRAMEWORK
 ");
-                map.Add(method.EnclosingTypeName, id);
+                map.Add(method.BindingTypeName, id);
             }
 
             // Emit the exports
-            implStream.WriteLine(
+            outputStream.WriteLine(
 @"
 //
 // Exports
 //
 ");
+            int exportId = 0;
             foreach (var export in exports)
             {
                 (var preguard, var postguard) = GetPlatformGuards(export.Platforms);
+                (string declsig, string ptrsig, string callsig) = GetArgumentLists(export);
+                exportId++;
 
-                // Create declaration and call signature.
-                string delim = "";
-                var declsig = new StringBuilder();
-                var callsig = new StringBuilder();
-                for (int i = 0; i < export.ArgumentTypes.Length; ++i)
-                {
-                    var argName = export.ArgumentNames[i] ?? $"arg{i}";
-                    declsig.AppendFormat("{0}{1} {2}", delim, export.ArgumentTypes[i], argName);
-                    callsig.AppendFormat("{0}{1}", delim, argName);
-                    delim = ", ";
-                }
-
-                // Special casing for void signature.
-                if (declsig.Length == 0)
-                {
-                    declsig.Append("void");
-                }
+                string ptrReturnType = export.ReturnByAddress ? "void" : export.ReturnType;
 
                 // Special casing for void return.
                 string returnStatementKeyword = "return ";
@@ -177,9 +275,22 @@ $@"#ifdef DNNE_TARGET_NET_FRAMEWORK
                     returnStatementKeyword = string.Empty;
                 }
 
+                // Only integral and pointer arguments can be supplied to a probe.
+                var probeArgs = new StringBuilder();
+                for (int i = 0; i < MaxProbeArguments; ++i)
+                {
+                    string probeArg = "0";
+                    if (i < export.ArgumentTypes.Length && IsProbeCompatibleType(export.ArgumentTypes[i]))
+                    {
+                        probeArg = $"(intptr_t){export.ArgumentNames[i] ?? $"arg{i}"}";
+                    }
+
+                    probeArgs.AppendFormat(", {0}", probeArg);
+                }
+
                 string callConv = s_typeProvider.MapCallConv(export.CallingConvention);
 
-                string classNameConstant = map[export.EnclosingTypeName];
+                string classNameConstant = map[export.BindingTypeName];
                 Debug.Assert(!string.IsNullOrEmpty(classNameConstant));
 
                 // Generate the acquire managed function based on the export type.
@@ -189,50 +300,706 @@ $@"#ifdef DNNE_TARGET_NET_FRAMEWORK
                     acquireManagedFunction =
 $@"const char_t* methodName = DNNE_STR(""{export.MethodName}"");
         const char_t* delegateType = DNNE_STR(""{export.EnclosingTypeName}+{export.MethodName}Delegate, {assemblyName}"");
-        {export.ExportName}_ptr = ({export.ReturnType}({callConv}*)({declsig}))get_callable_managed_function({classNameConstant}, methodName, delegateType);";
+        {export.ExportName}_ptr = ({ptrReturnType}({callConv}*)({ptrsig}))get_callable_managed_function({classNameConstant}, methodName, delegateType);";
 
                 }
                 else
                 {
                     Debug.Assert(export.Type == ExportType.UnmanagedCallersOnly);
                     acquireManagedFunction =
-$@"const char_t* methodName = DNNE_STR(""{export.MethodName}"");
-        {export.ExportName}_ptr = ({export.ReturnType}({callConv}*)({declsig}))get_fast_callable_managed_function({classNameConstant}, methodName);";
+$@"const char_t* methodName = DNNE_STR(""{export.BindingMethodName}"");
+        {export.ExportName}_ptr = ({ptrReturnType}({callConv}*)({ptrsig}))get_fast_callable_managed_function({classNameConstant}, methodName);";
                 }
 
-                // Declare export
-                outputStream.WriteLine(
-$@"{preguard}// Computed from {export.EnclosingTypeName}{Type.Delimiter}{export.MethodName}{export.XmlDoc}
-DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig});
-{postguard}");
+                // Define the call to the managed function, optionally surrounded by probes.
+                string probeReturnValue = "0";
+                string callManagedFunction = $"{export.ExportName}_ptr({callsig});";
+                string unprobedCall = $"{returnStatementKeyword}{callManagedFunction}";
+                if (export.ReturnByAddress)
+                {
+                    callManagedFunction = $"{export.ReturnType} dnne_ret;\n    {callManagedFunction}";
+                    unprobedCall = $"{callManagedFunction}\n    return dnne_ret;";
+                }
+                else if (!export.ReturnType.Equals("void"))
+                {
+                    if (IsProbeCompatibleType(export.ReturnType))
+                    {
+                        probeReturnValue = "(intptr_t)dnne_ret";
+                    }
 
-                // Define export in implementation stream
-                implStream.WriteLine(
-$@"{preguard}// Computed from {export.EnclosingTypeName}{Type.Delimiter}{export.MethodName}
-static {export.ReturnType} ({callConv}* {export.ExportName}_ptr)({declsig});
+                    callManagedFunction = $"{export.ReturnType} dnne_ret = {callManagedFunction}";
+                }
+
+                string probeExportName = $"\"{export.ExportName}\"";
+                string probedCall =
+$@"#if defined(DNNE_USDT_PROBES) || defined(DNNE_TRACING)
+    DNNE_SDT_PROBE6(dnne, export__entry, {exportId}, {probeExportName}{probeArgs});
+    {callManagedFunction}
+    DNNE_TRACE_EXPORT_RETURN({exportId});
+    DNNE_SDT_PROBE3(dnne, export__return, {exportId}, {probeExportName}, {probeReturnValue});
+    {(export.ReturnType.Equals("void") ? "return;" : "return dnne_ret;")}
+#else
+    {unprobedCall}
+#endif // !DNNE_USDT_PROBES && !DNNE_TRACING";
+
+                // When bound eagerly, the stub is only called until the export is bound.
+                bool isPure = export.PureCacheSize != 0;
+                bool canBindEagerly = CanBindEagerly(export);
+                string stubDefinition = isPure
+                    ? $"static {export.ReturnType} {callConv} {export.ExportName}_uncached({declsig})"
+                    : canBindEagerly
+                    ? $@"#ifdef DNNE_BIND_EAGERLY
+static {export.ReturnType} {callConv} {export.ExportName}_stub({declsig})
+#else
+DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig})
+#endif // !DNNE_BIND_EAGERLY"
+                    : $"DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig})";
+                string indirectFunction = canBindEagerly
+                    ? $@"
+#ifdef DNNE_BIND_EAGERLY
+static void* {export.ExportName}_resolver(void)
+{{
+    return {export.ExportName}_ptr != NULL ? (void*){export.ExportName}_ptr : (void*){export.ExportName}_stub;
+}}
+DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig}) __attribute__((ifunc(""{export.ExportName}_resolver"")));
+#endif // DNNE_BIND_EAGERLY"
+                    : string.Empty;
+
+                // A pure export returns a cached result, if there is one, before calling the stub.
+                // The arguments form the key and each is copied into its own 8 byte word.
+                string pureDefinition = string.Empty;
+                if (isPure)
+                {
+                    int keyCount = Math.Max(1, export.ArgumentTypes.Length);
+                    var key = new StringBuilder();
+                    var args = new StringBuilder();
+                    for (int i = 0; i < export.ArgumentTypes.Length; ++i)
+                    {
+                        string argName = export.ArgumentNames[i] ?? $"arg{i}";
+                        key.Append($"\n    memcpy(&dnne_key[{i}], &{argName}, sizeof({argName}));");
+                        args.Append($"{(i == 0 ? "" : ", ")}{argName}");
+                    }
+
+                    // Each entry is a sequence number, an epoch, the result and the key.
+                    string cacheArgs = $"{export.ExportName}_cache, {export.PureCacheSize}, {keyCount}, dnne_key";
+                    pureDefinition =
+$@"
+static uint64_t {export.ExportName}_cache[{export.PureCacheSize} * {3 + keyCount}];
 DNNE_EXTERN_C DNNE_API {export.ReturnType} {callConv} {export.ExportName}({declsig})
 {{
+    uint64_t dnne_key[{keyCount}] = {{ 0 }};{key}
+    uint64_t dnne_value = 0;
+    uint64_t dnne_epoch;
+    {export.ReturnType} dnne_ret;
+    if (dnne_pure_cache_lookup({cacheArgs}, &dnne_value, &dnne_epoch))
+    {{
+        memcpy(&dnne_ret, &dnne_value, sizeof(dnne_ret));
+        return dnne_ret;
+    }}
+
+    dnne_ret = {export.ExportName}_uncached({args});
+    memcpy(&dnne_value, &dnne_ret, sizeof(dnne_ret));
+    dnne_pure_cache_store({cacheArgs}, dnne_value, dnne_epoch);
+    return dnne_ret;
+}}";
+                }
+
+                // A remote export's arguments and return value are copied through a payload
+                // struct, the server passes it to the generated DNNE.RemoteExports type.
+                string remoteArgs = string.Empty;
+                string remoteCall = string.Empty;
+                if (export.RemoteIndex != 0)
+                {
+                    var members = new StringBuilder();
+                    var copyIn = new StringBuilder();
+                    for (int i = 0; i < export.ArgumentTypes.Length; ++i)
+                    {
+                        string argName = export.ArgumentNames[i] ?? $"arg{i}";
+                        members.Append($" {export.ArgumentTypes[i]} {argName};");
+                        copyIn.Append($"\n    dnne_args.{argName} = {argName};");
+                    }
+
+                    bool isVoid = export.ReturnType.Equals("void");
+                    if (!isVoid)
+                    {
+                        members.Append($" {export.ReturnType} dnne_ret;");
+                    }
+
+                    // A struct requires at least one member.
+                    if (members.Length == 0)
+                    {
+                        members.Append(" char dnne_unused;");
+                    }
+
+                    remoteArgs =
+$@"#ifdef DNNE_OUT_OF_PROCESS
+struct dnne_remote_{export.ExportName} {{{members} }};
+typedef char dnne_remote_{export.ExportName}_fits[sizeof(struct dnne_remote_{export.ExportName}) <= {RemotePayloadSize} ? 1 : -1];
+#endif // DNNE_OUT_OF_PROCESS
+";
+                    remoteCall =
+$@"#ifdef DNNE_OUT_OF_PROCESS
+    struct dnne_remote_{export.ExportName} dnne_args;{copyIn}
+    if (dnne_remote_call({export.RemoteIndex}, &dnne_args, sizeof(dnne_args)))
+        {(isVoid ? "return;" : "return dnne_args.dnne_ret;")}
+#endif // DNNE_OUT_OF_PROCESS
+";
+                }
+
+                // A recorded call is made by the generated DNNE.CommandBuffer type. The
+                // address of the result, if any, precedes the arguments.
+                string recordDefinition = string.Empty;
+                if (export.CommandOpcode != 0)
+                {
+                    bool isVoid = export.ReturnType.Equals("void");
+                    int first = isVoid ? 0 : 1;
+                    var record = new StringBuilder();
+                    if (!isVoid)
+                    {
+                        record.Append("\n    dnne_slots[0] = (uint64_t)(uintptr_t)dnne_result;");
+                    }
+
+                    for (int i = 0; i < export.ArgumentTypes.Length; ++i)
+                    {
+                        string argName = export.ArgumentNames[i] ?? $"arg{i}";
+                        record.Append($"\n    memcpy(&dnne_slots[{first + i}], &{argName}, sizeof({argName}));");
+                    }
+
+                    recordDefinition =
+$@"
+{GetRecordDeclaration(export, string.Empty).TrimStart()}
+{{
+    uint64_t* dnne_slots = dnne_command_buffer_append(dnne_buffer, {export.CommandOpcode}, {first + export.ArgumentTypes.Length});
+    if (dnne_slots == NULL)
+        return DNNE_E_OUTOFMEMORY;
+{record}
+    return DNNE_SUCCESS;
+}}";
+                }
+
+                // Define export in implementation stream
+                outputStream.WriteLine(
+$@"{preguard}// Computed from {export.EnclosingTypeName}{Type.Delimiter}{export.MethodName} (export id {exportId})
+static {ptrReturnType} ({callConv}* {export.ExportName}_ptr)({ptrsig});
+{remoteArgs}{stubDefinition}
+{{
+{remoteCall}    DNNE_TRACE_EXPORT_ENTRY({exportId});
     if ({export.ExportName}_ptr == NULL)
     {{
         {acquireManagedFunction}
     }}
-    {returnStatementKeyword}{export.ExportName}_ptr({callsig});
-}}
+{probedCall}
+}}{indirectFunction}{pureDefinition}{recordDefinition}
+{postguard}");
+            }
+
+            // Define exported data
+            if (data.Any(static d => d.Constant is null))
+            {
+                outputStream.WriteLine(
+@"//
+// Exported data
+//
+");
+                foreach (var item in data.Where(static d => d.Constant is null))
+                {
+                    (var preguard, var postguard) = GetPlatformGuards(item.Platforms);
+                    outputStream.WriteLine(
+$@"{preguard}// Computed from {item.EnclosingTypeName}{Type.Delimiter}{item.MemberName}
+DNNE_EXTERN_C DNNE_API const uint8_t {item.ExportName}[{item.Data.Length}] =
+{{");
+                    item.WriteData(outputStream);
+                    outputStream.WriteLine(
+$@"}};
 {postguard}");
+                }
             }
 
-            // Emit implementation closing
-            implStream.Write($"#endif // {compileAsSourceDefine}");
+            EmitExportTable(outputStream, assemblyName, exports);
+            EmitRemoteAbi(outputStream, exports);
+            EmitTraceNameTable(outputStream, exports);
 
-            // Emit output closing for header and merge in implementation
+            // Emit eager binding
             outputStream.WriteLine(
-$@"#endif // {generatedHeaderDefine}
+$@"#ifdef DNNE_BIND_EAGERLY
+//
+// Eager binding
+//
+
+// Called by preload_runtime() and try_preload_runtime() once the runtime is loaded, so
+// an indirect function resolver that runs afterwards for a caller that binds lazily
+// (i.e., dlsym() or a PLT entry) returns the managed entry point. Loading the binary
+// doesn't load the runtime. Exports already bound, by a call or a previous preload,
+// are skipped.
+void dnne_bind_exports(void)
+{{
+    void* func;");
+            foreach (var export in exports)
+            {
+                (var preguard, var postguard) = GetPlatformGuards(export.Platforms);
+                (_, string ptrsig, _) = GetArgumentLists(export);
+                string ptrReturnType = export.ReturnByAddress ? "void" : export.ReturnType;
+                string callConv = s_typeProvider.MapCallConv(export.CallingConvention);
+                string classNameConstant = map[export.BindingTypeName];
+
+                // Eagerly bind the export without aborting. On failure the stub
+                // resolves the export, and reports the failure, on first call.
+                string tryAcquireManagedFunction = export.Type == ExportType.Export
+                    ? $"try_get_callable_managed_function({classNameConstant}, DNNE_STR(\"{export.MethodName}\"), DNNE_STR(\"{export.EnclosingTypeName}+{export.MethodName}Delegate, {assemblyName}\"), &func)"
+                    : $"try_get_fast_callable_managed_function({classNameConstant}, DNNE_STR(\"{export.BindingMethodName}\"), &func)";
+                outputStream.Write(
+$@"{preguard}    if ({export.ExportName}_ptr == NULL && {tryAcquireManagedFunction} == DNNE_SUCCESS)
+        {export.ExportName}_ptr = ({ptrReturnType}({callConv}*)({ptrsig}))func;
+{postguard}");
+            }
+
+            outputStream.WriteLine(
+@"}
+#endif // DNNE_BIND_EAGERLY
+");
+
+            // Emit output closing
+            outputStream.WriteLine($"#endif // {compileAsSourceDefine}");
+        }
+
+        // The argument lists of the export declaration, the managed function pointer and the call.
+        // The managed function signature differs when arguments are passed by address.
+        private static (string declsig, string ptrsig, string callsig) GetArgumentLists(ExportedMethod export)
+        {
+            string delim = "";
+            var declsig = new StringBuilder();
+            var ptrsig = new StringBuilder();
+            var callsig = new StringBuilder();
+            for (int i = 0; i < export.ArgumentTypes.Length; ++i)
+            {
+                var argName = export.ArgumentNames[i] ?? $"arg{i}";
+                bool byAddress = export.ArgumentsByAddress[i];
+                declsig.AppendFormat("{0}{1} {2}", delim, export.ArgumentTypes[i], argName);
+                ptrsig.AppendFormat("{0}{1}{2} {3}", delim, export.ArgumentTypes[i], byAddress ? "*" : "", argName);
+                callsig.AppendFormat("{0}{1}{2}", delim, byAddress ? "&" : "", argName);
+                delim = ", ";
+            }
+
+            if (export.ReturnByAddress)
+            {
+                ptrsig.AppendFormat("{0}{1}* dnne_ret", delim, export.ReturnType);
+                callsig.AppendFormat("{0}&dnne_ret", delim);
+            }
 
-{implStream}");
+            // Special casing for void signature.
+            if (declsig.Length == 0)
+            {
+                declsig.Append("void");
+            }
+
+            if (ptrsig.Length == 0)
+            {
+                ptrsig.Append("void");
+            }
+
+            return (declsig.ToString(), ptrsig.ToString(), callsig.ToString());
+        }
+
+
+        // Arguments passed by address, and cached results, require the stub.
+        private static bool CanBindEagerly(ExportedMethod export)
+        {
+            return !export.ReturnByAddress && !export.ArgumentsByAddress.Any(static b => b) && export.PureCacheSize == 0;
+        }
+
+        // Declaration of the function that records a call to the export in a command buffer.
+        private static string GetRecordDeclaration(ExportedMethod export, string terminator)
+        {
+            if (export.CommandOpcode == 0)
+            {
+                return string.Empty;
+            }
+
+            var args = new StringBuilder("dnne_command_buffer* dnne_buffer");
+            for (int i = 0; i < export.ArgumentTypes.Length; ++i)
+            {
+                args.Append($", {export.ArgumentTypes[i]} {export.ArgumentNames[i] ?? $"arg{i}"}");
+            }
+
+            if (!export.ReturnType.Equals("void"))
+            {
+                args.Append($", {export.ReturnType}* dnne_result");
+            }
+
+            return $"\nDNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE {export.ExportName}_record({args}){terminator}";
+        }
+
+        // Trace records identify an export by export id, the name is only needed when the trace is written.
+        private static void EmitTraceNameTable(TextWriter implStream, IEnumerable<ExportedMethod> exports)
+        {
+            var names = new StringBuilder("    NULL,\n");
+            int exportId = 0;
+            foreach (var export in exports)
+            {
+                exportId++;
+                names.Append($"    \"{export.ExportName}\",\n");
+            }
+
+            implStream.WriteLine(
+$@"#if defined(DNNE_TRACING) && !defined(DNNE_WINDOWS)
+//
+// Timeline tracing
+//
+
+DNNE_EXTERN_C __attribute__((visibility(""hidden""))) const uint32_t dnne_trace_export_count = {exportId + 1};
+DNNE_EXTERN_C __attribute__((visibility(""hidden""))) const char* const dnne_trace_export_names[{exportId + 1}] =
+{{
+{names}}};
+#endif // DNNE_TRACING
+");
+        }
+
+        // The server dispatches calls by the index of the remote export. The ABI hash names
+        // the server, so processes with a different set of remote exports never share one.
+        private static void EmitRemoteAbi(TextWriter implStream, IEnumerable<ExportedMethod> exports)
+        {
+            var abi = new StringBuilder();
+            foreach (var export in exports.Where(static e => e.RemoteIndex != 0))
+            {
+                abi.Append($"{export.RemoteIndex}:{export.ExportName}:{GetSignature(export)};");
+            }
+
+            implStream.WriteLine(
+$@"#ifdef DNNE_OUT_OF_PROCESS
+//
+// Out-of-process dispatch
+//
+
+DNNE_EXTERN_C __attribute__((visibility(""hidden""))) const uint64_t dnne_remote_abi = UINT64_C(0x{ExportTable.SignatureHash(abi.ToString()):x16});
+#endif // DNNE_OUT_OF_PROCESS
+");
+        }
+
+        private static void EmitExportTable(TextWriter implStream, string assemblyName, IEnumerable<ExportedMethod> exports)
+        {
+            // Exports with the same name are expected to be defined for mutually exclusive platforms.
+            var entries = exports.GroupBy(static e => e.ExportName).ToList();
+            if (entries.Count == 0)
+            {
+                implStream.WriteLine(
+@"//
+// Export table
+//
+
+DNNE_EXTERN_C DNNE_API void* DNNE_CALLTYPE dnne_find_export(const char* name, uint64_t* signature_hash)
+{
+    (void)name;
+    (void)signature_hash;
+    return NULL;
+}
+
+DNNE_EXTERN_C DNNE_API size_t DNNE_CALLTYPE dnne_enumerate_exports(const struct dnne_export** exports)
+{
+    if (exports != NULL)
+        *exports = NULL;
+    return 0;
+}
+");
+                return;
+            }
+
+            var table = ExportTable.Create(assemblyName, entries.Select(static e => e.Key).ToList());
+            string[] slots = FormatSlots(static (name, export) => $"{{ \"{name}\", (void*)&{name}, UINT64_C(0x{ExportTable.SignatureHash(GetSignature(export)):x16}) }},", static name => $"{{ \"{name}\", NULL, 0 }},");
+            string[] bindings = FormatSlots(static (name, export) => $"{{ (void* volatile*)&{name}_ptr, {(CanBindEagerly(export) ? 1 : 0)} }},", static _ => "{ NULL, 0 },");
+
+            // Entries are placed in hash order, with a slot for each platform the export is defined for.
+            string[] FormatSlots(Func<string, ExportedMethod, string> format, Func<string, string> missing)
+            {
+                var formatted = new string[entries.Count];
+                for (int i = 0; i < entries.Count; ++i)
+                {
+                    var slot = new StringBuilder();
+                    string name = entries[i].Key;
+                    string directive = "#if";
+                    foreach (var export in entries[i])
+                    {
+                        string entry = format(name, export);
+                        string condition = GetPlatformCondition(export.Platforms);
+                        if (condition is null)
+                        {
+                            slot.Append(directive == "#if" ? $"    {entry}\n" : $"#else\n    {entry}\n");
+                            directive = null;
+                            break;
+                        }
+
+                        slot.Append($"{directive} {condition}\n    {entry}\n");
+                        directive = "#elif";
+                    }
+
+                    if (directive is not null)
+                    {
+                        // Not defined for the current platform.
+                        slot.Append($"#else\n    {missing(name)}\n#endif\n");
+                    }
+                    else if (slot[0] == '#')
+                    {
+                        slot.Append("#endif\n");
+                    }
+
+                    formatted[table.Slots[i]] = slot.ToString();
+                }
+
+                return formatted;
+            }
+
+            implStream.WriteLine(
+$@"//
+// Export table
+//
+
+// Minimal perfect hash of the export names. The bucket of a name selects
+// the seed used to hash the name to its slot in the table.
+static const uint16_t dnne_export_seeds[{table.Seeds.Length}] =
+{{
+{FormatSeeds(table.Seeds)}
+}};
+
+static const struct dnne_export dnne_exports[{entries.Count}] =
+{{
+{string.Concat(slots)}}};
+
+#ifndef DNNE_WINDOWS
+// Variable holding the managed function each export is bound to, in the order of dnne_exports.
+// The address in dnne_exports of an indirect export is resolved when the binary is loaded,
+// before the export is bound, so it is always the stub. Also read by dnne_write_perf_map() in
+// platform.c, which must match the layout of struct dnne_export_binding.
+struct dnne_export_binding
+{{
+    void* volatile* func;
+    int indirect;
+}};
+
+DNNE_EXTERN_C __attribute__((visibility(""hidden""))) const struct dnne_export_binding dnne_export_bindings[{entries.Count}] =
+{{
+{string.Concat(bindings)}}};
+#endif // !DNNE_WINDOWS
+
+// Must match ExportTable.Hash(), ExportTable.Mix() and ExportTable.Reduce() in dnne-gen.
+static uint64_t dnne_export_mix(uint64_t h)
+{{
+    h ^= h >> 33;
+    h *= UINT64_C(0xff51afd7ed558ccd);
+    h ^= h >> 33;
+    h *= UINT64_C(0xc4ceb9fe1a85ec53);
+    h ^= h >> 33;
+    return h;
+}}
+
+DNNE_EXTERN_C DNNE_API void* DNNE_CALLTYPE dnne_find_export(const char* name, uint64_t* signature_hash)
+{{
+    if (name == NULL)
+        return NULL;
+
+    uint64_t h = UINT64_C(14695981039346656037);
+    for (const char* c = name; *c != '\0'; ++c)
+    {{
+        h ^= (uint8_t)*c;
+        h *= UINT64_C(1099511628211);
+    }}
+
+    uint64_t seed = dnne_export_seeds[((dnne_export_mix(h) >> 32) * {table.Seeds.Length}u) >> 32];
+    size_t slot = ((dnne_export_mix(h ^ (seed * UINT64_C(0x9e3779b97f4a7c15))) >> 32) * {entries.Count}u) >> 32;
+    const struct dnne_export* entry = &dnne_exports[slot];
+    if (entry->address == NULL)
+        return NULL;
+
+    const char* expected = entry->name;
+    while (*name != '\0' && *name == *expected)
+    {{
+        ++name;
+        ++expected;
+    }}
+
+    if (*name != *expected)
+        return NULL;
+
+    if (signature_hash != NULL)
+        *signature_hash = entry->signature_hash;
+
+#ifdef DNNE_BIND_EAGERLY
+    // Once bound, an indirect export is the managed function itself.
+    const struct dnne_export_binding* binding = &dnne_export_bindings[slot];
+    void* func = binding->indirect ? *binding->func : NULL;
+    if (func != NULL)
+        return func;
+#endif // DNNE_BIND_EAGERLY
+    return entry->address;
+}}
+
+DNNE_EXTERN_C DNNE_API size_t DNNE_CALLTYPE dnne_enumerate_exports(const struct dnne_export** exports)
+{{
+    if (exports != NULL)
+        *exports = dnne_exports;
+    return {entries.Count};
+}}
+");
+
+            static string FormatSeeds(ushort[] seeds)
+            {
+                var lines = new StringBuilder();
+                for (int i = 0; i < seeds.Length; i += 16)
+                {
+                    lines.Append("    ");
+                    lines.AppendJoin(", ", seeds.Skip(i).Take(16));
+                    lines.Append(i + 16 < seeds.Length ? ",\n" : string.Empty);
+                }
+
+                return lines.ToString();
+            }
+        }
+
+        // A constant as a C expression, for example "INT32_C(5)" or "1.5f".
+        private static string FormatConstant(object constant)
+        {
+            return constant switch
+            {
+                bool b => b ? "1" : "0",
+                char c => $"UINT16_C({(int)c})",
+                sbyte v => FormatInteger("INT8_C", v, sbyte.MinValue),
+                byte v => $"UINT8_C({v})",
+                short v => FormatInteger("INT16_C", v, short.MinValue),
+                ushort v => $"UINT16_C({v})",
+                int v => FormatInteger("INT32_C", v, int.MinValue),
+                uint v => $"UINT32_C({v})",
+                long v => FormatInteger("INT64_C", v, long.MinValue),
+                ulong v => $"UINT64_C({v})",
+                float v => $"{ExportedData.FormatFloatingPoint(v.ToString("R", CultureInfo.InvariantCulture))}f",
+                double v => ExportedData.FormatFloatingPoint(v.ToString("R", CultureInfo.InvariantCulture)),
+                _ => throw new NotSupportedException($"Unknown constant type: {constant.GetType()}"),
+            };
+
+            // The macros only accept non-negative values and the magnitude of the minimum value isn't representable.
+            static string FormatInteger(string macro, long value, long minValue)
+            {
+                return value switch
+                {
+                    >= 0 => $"{macro}({value})",
+                    _ when value == minValue => $"(-{macro}({-(value + 1)}) - 1)",
+                    _ => $"(-{macro}({-value}))",
+                };
+            }
+        }
+
+        // The signature hashed for the export table, for example "int32_t(int32_t,int32_t)".
+        private static string GetSignature(ExportedMethod export)
+        {
+            static string Normalize(string type) => s_normalizedTypes.GetOrAdd(type, static t => Regex.Replace(t.Trim(), @"\s+", " "));
+            return $"{Normalize(export.ReturnType)}({string.Join(",", export.ArgumentTypes.Select(Normalize))})";
+        }
+
+        // The same few types appear in most signatures.
+        private static readonly ConcurrentDictionary<string, string> s_normalizedTypes = new ConcurrentDictionary<string, string>(StringComparer.Ordinal);
+
+        // The entry probe supplies the export id and name, leaving room for the leading arguments.
+        private const int MaxProbeArguments = 4;
+
+        private static readonly HashSet<string> s_probeCompatibleTypes = new HashSet<string>()
+        {
+            "int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t",
+            "intptr_t", "uintptr_t", "size_t", "ptrdiff_t", "DNNE_WCHAR",
+            "char", "signed char", "unsigned char", "short", "unsigned short",
+            "int", "unsigned int", "unsigned", "long", "unsigned long", "bool", "_Bool",
+        };
+
+        // Types whose values are equal exactly when their bits are, matching PureCachesGenerator.IsCacheableType
+        // and RustEmitter.s_pureCacheableTypes. Pointer-sized integers usually hold addresses, and bool and
+        // character types have values that aren't canonical, so they aren't cached.
+        private static readonly HashSet<string> s_pureCacheableTypes = new HashSet<string>()
+        {
+            "int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t",
+            "float", "double",
+        };
+
+        // Values that mean the same in another process, with their size. Pointers and
+        // pointer-sized integers, which usually hold addresses or handles, aren't allowed.
+        private static readonly Dictionary<string, int> s_remotableTypes = new Dictionary<string, int>()
+        {
+            { "int8_t", 1 }, { "uint8_t", 1 }, { "int16_t", 2 }, { "uint16_t", 2 },
+            { "int32_t", 4 }, { "uint32_t", 4 }, { "int64_t", 8 }, { "uint64_t", 8 },
+            { "float", 4 }, { "double", 8 },
+        };
+
+        // Size of the slot payload the arguments and return value are copied to.
+        // Must match DNNE_REMOTE_PAYLOAD_SIZE in platform.c.
+        public const int RemotePayloadSize = 240;
+
+        // Arguments and return values are copied to the server process by value.
+        public static bool IsRemotable(ExportedMethod export)
+        {
+            return !export.ReturnByAddress
+                && !export.ArgumentsByAddress.Any(static b => b)
+                && (export.ReturnType.Equals("void") || s_remotableTypes.ContainsKey(export.ReturnType.Trim()))
+                && export.ArgumentTypes.All(static t => s_remotableTypes.ContainsKey(t.Trim()));
+        }
+
+        // Size of the payload struct of a remotable export. Each member is aligned to its size,
+        // which is the largest alignment of the type on any supported platform.
+        public static int GetRemotePayloadSize(ExportedMethod export)
+        {
+            IEnumerable<string> members = export.ReturnType.Equals("void")
+                ? export.ArgumentTypes
+                : export.ArgumentTypes.Append(export.ReturnType);
+
+            int size = 0;
+            int alignment = 1;
+            foreach (string member in members)
+            {
+                int memberSize = s_remotableTypes[member.Trim()];
+                size = (size + memberSize - 1) / memberSize * memberSize + memberSize;
+                alignment = Math.Max(alignment, memberSize);
+            }
+
+            // The struct has a member even if there are no arguments or return value.
+            return Math.Max(1, (size + alignment - 1) / alignment * alignment);
+        }
+
+        // Results are cached by value, so values with identity such as pointers aren't allowed.
+        public static bool IsPureCacheable(ExportedMethod export)
+        {
+            return !export.ReturnByAddress
+                && !export.ArgumentsByAddress.Any(static b => b)
+                && s_pureCacheableTypes.Contains(export.ReturnType.Trim())
+                && export.ArgumentTypes.All(static t => s_pureCacheableTypes.Contains(t.Trim()));
+        }
+
+        private static bool IsProbeCompatibleType(string type)
+        {
+            type = type.Trim();
+            return type.EndsWith("*") || s_probeCompatibleTypes.Contains(type);
+        }
+
+        // The platform guards as a single preprocessor condition, or null if there are none.
+        private static string GetPlatformCondition(in PlatformSupport platformSupport)
+        {
+            (string preguard, _) = GetPlatformGuards(platformSupport);
+            string[] conditions = preguard.Split('\n', StringSplitOptions.RemoveEmptyEntries)
+                .Select(static l => l.Substring("#if ".Length))
+                .ToArray();
+
+            return conditions.Length switch
+            {
+                0 => null,
+                1 => conditions[0],
+                _ => string.Join(" && ", conditions.Select(static c => $"({c})")),
+            };
         }
 
         private static (string preguard, string postguard) GetPlatformGuards(in PlatformSupport platformSupport)
         {
+            // Most exports aren't platform specific.
+            if (IsEmpty(platformSupport.Assembly)
+                && IsEmpty(platformSupport.Module)
+                && IsEmpty(platformSupport.Type)
+                && IsEmpty(platformSupport.Method))
+            {
+                return (string.Empty, string.Empty);
+            }
+
             var pre = new StringBuilder();
             var post = new StringBuilder();
 
@@ -249,6 +1016,8 @@ $@"#endif // {generatedHeaderDefine}
 
             return (pre.ToString(), post.ToString());
 
+            static bool IsEmpty(in Scope scope) => !scope.Support.Any() && !scope.NoSupport.Any();
+
             static string ConvertScope(in Scope scope, ref StringBuilder pre)
             {
                 (string pre_support, string post_support) = ConvertCollection(scope.Support, "(", ")");
@@ -0,0 +1,85 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+using System.IO;
+
+namespace DNNE
+{
+    /// <summary>
+    /// Emits C source that embeds the assembly, and optionally its runtimeconfig.json, in the native binary.
+    /// </summary>
+    /// <remarks>
+    /// The source is compiled with the generated exports when <c>DNNE_EMBED_ASSEMBLY</c> is defined.
+    /// The platform layer loads the assembly from memory instead of from a file next to the native binary.
+    /// </remarks>
+    internal static class EmbeddedAssemblyEmitter
+    {
+        public static void Emit(TextWriter outputStream, string assemblyName, ReadOnlySpan<byte> assembly, byte[] runtimeConfig)
+        {
+            outputStream.WriteLine(
+$@"//
+// Auto-generated by dnne-gen
+//
+// The {assemblyName} assembly embedded in the native binary, see DNNE_EMBED_ASSEMBLY in platform.c.
+//
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Only the exports are visible outside of the native binary.
+#if defined(_WIN32) || defined(__CYGWIN__)
+    #define DNNE_EMBEDDED
+#else
+    #define DNNE_EMBEDDED __attribute__((__visibility__(""hidden"")))
+#endif
+
+DNNE_EMBEDDED extern const uint8_t dnne_embedded_assembly[];
+DNNE_EMBEDDED extern const size_t dnne_embedded_assembly_size;
+DNNE_EMBEDDED extern const uint8_t dnne_embedded_runtimeconfig[];
+DNNE_EMBEDDED extern const size_t dnne_embedded_runtimeconfig_size;
+
+const uint8_t dnne_embedded_assembly[] =
+{{");
+            ExportedData.WriteBytes(outputStream, assembly);
+            outputStream.WriteLine(
+@"};
+const size_t dnne_embedded_assembly_size = sizeof(dnne_embedded_assembly);
+");
+
+            if (runtimeConfig is null)
+            {
+                outputStream.WriteLine(
+@"// Not embedded, the runtimeconfig.json next to the native binary is used.
+const uint8_t dnne_embedded_runtimeconfig[1] = { 0 };
+const size_t dnne_embedded_runtimeconfig_size = 0;");
+            }
+            else
+            {
+                outputStream.WriteLine(
+@"const uint8_t dnne_embedded_runtimeconfig[] =
+{");
+                ExportedData.WriteBytes(outputStream, runtimeConfig);
+                outputStream.WriteLine(
+@"};
+const size_t dnne_embedded_runtimeconfig_size = sizeof(dnne_embedded_runtimeconfig);");
+            }
+        }
+    }
+}
@@ -0,0 +1,190 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Text;
+
+namespace DNNE
+{
+    /// <summary>
+    /// Computes the perfect hash table used to look up exports by name at run time.
+    /// </summary>
+    /// <remarks>
+    /// The table uses hash and displace: each name is assigned to a bucket by its hash and
+    /// each bucket is given a seed that places all of its names in distinct slots. A lookup
+    /// therefore hashes the name once and reads a single seed and a single slot. The hash
+    /// functions must match those in the generated source, see <see cref="C99Emitter"/>.
+    /// </remarks>
+    internal sealed class ExportTable
+    {
+        // Average number of names per bucket.
+        private const int NamesPerBucket = 4;
+
+        // Spreads the seed of a bucket across all bits of the hash.
+        private const ulong SeedMultiplier = 0x9e3779b97f4a7c15ul;
+
+        private ExportTable(ushort[] seeds, int[] slots)
+        {
+            Seeds = seeds;
+            Slots = slots;
+        }
+
+        /// <summary>
+        /// Seed for each bucket.
+        /// </summary>
+        public ushort[] Seeds { get; }
+
+        /// <summary>
+        /// Slot of each name, in the order the names were supplied.
+        /// </summary>
+        public int[] Slots { get; }
+
+        /// <summary>
+        /// Compute a minimal perfect hash for a set of distinct names.
+        /// </summary>
+        public static ExportTable Create(string assemblyName, IReadOnlyList<string> names)
+        {
+            if (names.Count == 0)
+            {
+                return new ExportTable(Array.Empty<ushort>(), Array.Empty<int>());
+            }
+
+            ulong[] keys = names.Select(static n => Hash(n)).ToArray();
+
+            // Smaller buckets are easier to place, retry with more buckets on failure.
+            for (int bucketCount = (names.Count + NamesPerBucket - 1) / NamesPerBucket; ; bucketCount *= 2)
+            {
+                bucketCount = Math.Min(bucketCount, names.Count);
+                if (TryCreate(keys, bucketCount, out ExportTable table))
+                {
+                    return table;
+                }
+
+                if (bucketCount == names.Count)
+                {
+                    throw new GeneratorException(assemblyName, "Unable to compute the export table.");
+                }
+            }
+        }
+
+        private static bool TryCreate(ulong[] keys, int bucketCount, out ExportTable table)
+        {
+            table = null;
+            int slotCount = keys.Length;
+
+            // Place the largest buckets first, while most slots are free.
+            (ulong Key, int[] Names)[] buckets = Enumerable.Range(0, keys.Length)
+                .GroupBy(i => Reduce(Mix(keys[i]), bucketCount))
+                .Select(static b => (b.Key, b.ToArray()))
+                .OrderByDescending(static b => b.Item2.Length)
+                .ToArray();
+
+            var seeds = new ushort[bucketCount];
+            var slots = new int[keys.Length];
+            var occupied = new bool[slotCount];
+            var candidate = new List<int>();
+            foreach ((ulong key, int[] bucket) in buckets)
+            {
+                bool placed = false;
+                for (uint seed = 1; seed <= ushort.MaxValue && !placed; ++seed)
+                {
+                    candidate.Clear();
+                    foreach (int i in bucket)
+                    {
+                        int slot = (int)Reduce(Mix(keys[i] ^ (seed * SeedMultiplier)), slotCount);
+                        if (occupied[slot] || candidate.Contains(slot))
+                        {
+                            break;
+                        }
+
+                        candidate.Add(slot);
+                    }
+
+                    if (candidate.Count != bucket.Length)
+                    {
+                        continue;
+                    }
+
+                    int j = 0;
+                    foreach (int i in bucket)
+                    {
+                        slots[i] = candidate[j++];
+                        occupied[slots[i]] = true;
+                    }
+
+                    seeds[key] = (ushort)seed;
+                    placed = true;
+                }
+
+                if (!placed)
+                {
+                    return false;
+                }
+            }
+
+            table = new ExportTable(seeds, slots);
+            return true;
+        }
+
+        /// <summary>
+        /// 64-bit FNV-1a of a signature.
+        /// </summary>
+        public static ulong SignatureHash(string signature)
+        {
+            return Hash(signature);
+        }
+
+        // 64-bit FNV-1a of the UTF-8 encoding.
+        private static ulong Hash(string value)
+        {
+            const int MaxStackBytes = 512;
+            int byteCount = Encoding.UTF8.GetByteCount(value);
+            Span<byte> key = byteCount <= MaxStackBytes ? stackalloc byte[MaxStackBytes] : new byte[byteCount];
+            key = key[..Encoding.UTF8.GetBytes(value, key)];
+
+            ulong h = 14695981039346656037ul;
+            foreach (byte b in key)
+            {
+                h ^= b;
+                h *= 1099511628211ul;
+            }
+
+            return h;
+        }
+
+        // Map a hash to [0, count) with a multiply instead of a division.
+        private static ulong Reduce(ulong h, int count)
+        {
+            return ((h >> 32) * (ulong)count) >> 32;
+        }
+
+        // The MurmurHash3 64-bit finalizer.
+        private static ulong Mix(ulong h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdul;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ul;
+            h ^= h >> 33;
+            return h;
+        }
+    }
+}
@@ -25,9 +25,12 @@ using System.IO;
 using System.Linq;
 using System.Reflection;
 using System.Reflection.Metadata;
+using System.Reflection.Metadata.Ecma335;
 using System.Reflection.PortableExecutable;
+using System.Runtime.ExceptionServices;
 using System.Runtime.InteropServices;
 using System.Runtime.Versioning;
+using System.Threading.Tasks;
 using System.Xml;
 
 namespace DNNE
@@ -51,6 +54,9 @@ namespace DNNE
             Rust,
         }
 
+        // Matches the default of DNNE.PureAttribute.CacheSize.
+        private const int DefaultPureCacheSize = 64;
+
         private bool isDisposed = false;
 
         private readonly ICustomAttributeTypeProvider<KnownType> typeResolver = new TypeResolver();
@@ -59,10 +65,14 @@ namespace DNNE
         private readonly MetadataReader mdReader;
         private readonly Scope assemblyScope;
         private readonly Scope moduleScope;
-        private readonly IDictionary<TypeDefinitionHandle, Scope> typePlatformScenarios = new Dictionary<TypeDefinitionHandle, Scope>();
         private readonly Dictionary<string, string> loadedXmlDocumentation;
+        private readonly Dictionary<TypeDefinitionHandle, string> handleTypes;
+        private readonly Dictionary<string, (string TypeName, string MethodName)> exportTrampolines;
         private readonly OutputLanguage language;
 
+        // Pass 256-bit vectors in AVX registers in the generated C99 source.
+        public bool Vector256Avx { get; init; }
+
         public Generator(string validAssemblyPath, string xmlDocFile, OutputLanguage language)
         {
             this.language = language;
@@ -77,25 +87,295 @@ namespace DNNE
 
             ModuleDefinition modDef = this.mdReader.GetModuleDefinition();
             this.moduleScope = this.GetOSPlatformScope(modDef.GetCustomAttributes());
+
+            this.handleTypes = this.GetHandleTypes();
+            this.exportTrampolines = this.GetExportTrampolines();
         }
 
         public void Emit(string outputFile)
         {
-            using var generatedCode = new StringWriter();
-            Emit(generatedCode);
-
-            // Write the generated code to the output file.
-            using (var outputFileStream = new StreamWriter(File.Create(outputFile)))
+            // The generated code is written directly to the output file. Remove
+            // a partially written file so it isn't mistaken for up to date.
+            try
             {
-                outputFileStream.Write(generatedCode.ToString());
+                using var outputFileStream = new StreamWriter(File.Create(outputFile));
+                Emit(outputFileStream);
+            }
+            catch
+            {
+                File.Delete(outputFile);
+                throw;
             }
         }
 
         public void Emit(TextWriter outputStream)
         {
             var additionalCodeStatements = new List<string>();
+            var exportedData = new List<ExportedData>();
+            List<ExportedMethod> exportedMethods = GetExportedMethods(additionalCodeStatements, exportedData);
+
+            string assemblyName = this.mdReader.GetString(this.mdReader.GetAssemblyDefinition().Name);
+            if (this.language == OutputLanguage.Rust)
+            {
+                RustEmitter.Emit(outputStream, assemblyName, exportedMethods, exportedData, additionalCodeStatements);
+            }
+            else
+            {
+                C99Emitter.Emit(outputStream, assemblyName, exportedMethods, exportedData, additionalCodeStatements, this.Vector256Avx);
+            }
+        }
+
+        public void EmitTrimmerDescriptor(string outputFile)
+        {
+            List<ExportedMethod> exportedMethods = GetExportedMethods(new List<string>(), new List<ExportedData>());
+
+            string assemblyName = this.mdReader.GetString(this.mdReader.GetAssemblyDefinition().Name);
+            using (var outputFileStream = new StreamWriter(File.Create(outputFile)))
+            {
+                TrimmerDescriptorEmitter.Emit(outputFileStream, assemblyName, exportedMethods, GetPlatformHelperTypes());
+            }
+        }
+
+        public void EmitEmbeddedAssembly(string outputFile, string runtimeConfigPath)
+        {
+            string assemblyName = this.mdReader.GetString(this.mdReader.GetAssemblyDefinition().Name);
+            byte[] runtimeConfig = string.IsNullOrWhiteSpace(runtimeConfigPath) ? null : File.ReadAllBytes(runtimeConfigPath);
+            using (var outputFileStream = new StreamWriter(File.Create(outputFile)))
+            {
+                EmbeddedAssemblyEmitter.Emit(outputFileStream, assemblyName, File.ReadAllBytes(this.assemblyPath), runtimeConfig);
+            }
+        }
+
+        /// <summary>
+        /// Get the generated types in the DNNE namespace that are called by the platform layer.
+        /// </summary>
+        /// <remarks>
+        /// The platform layer resolves non-public <c>UnmanagedCallersOnlyAttribute</c> methods
+        /// on these types by name, so they aren't exports.
+        /// </remarks>
+        private List<string> GetPlatformHelperTypes()
+        {
+            var helperTypes = new List<string>();
+            foreach (TypeDefinitionHandle typeDefHandle in this.mdReader.TypeDefinitions)
+            {
+                TypeDefinition typeDef = this.mdReader.GetTypeDefinition(typeDefHandle);
+                if (typeDef.IsNested || !this.mdReader.StringComparer.Equals(typeDef.Namespace, "DNNE"))
+                {
+                    continue;
+                }
+
+                bool isHelper = typeDef.GetMethods()
+                    .SelectMany(m => this.mdReader.GetMethodDefinition(m).GetCustomAttributes())
+                    .Any(a => this.GetExportAttributeType(this.mdReader.GetCustomAttribute(a)) == ExportType.UnmanagedCallersOnly);
+                if (isHelper)
+                {
+                    helperTypes.Add($"DNNE.{this.mdReader.GetString(typeDef.Name)}");
+                }
+            }
+
+            return helperTypes;
+        }
+
+        /// <summary>
+        /// Get the native names of the handle types generated for <c>DNNE.HandleAttribute</c>.
+        /// </summary>
+        private Dictionary<TypeDefinitionHandle, string> GetHandleTypes()
+        {
+            var handleTypes = new Dictionary<TypeDefinitionHandle, string>();
+            foreach (TypeDefinitionHandle typeDefHandle in this.mdReader.TypeDefinitions)
+            {
+                TypeDefinition typeDef = this.mdReader.GetTypeDefinition(typeDefHandle);
+                foreach (CustomAttributeHandle customAttrHandle in typeDef.GetCustomAttributes())
+                {
+                    CustomAttribute customAttr = this.mdReader.GetCustomAttribute(customAttrHandle);
+                    if (IsAttributeType(this.mdReader, customAttr, "DNNE", "HandleTypeAttribute"))
+                    {
+                        handleTypes[typeDefHandle] = GetFirstFixedArgAsStringValue(this.typeResolver, customAttr);
+                    }
+                }
+            }
+
+            return handleTypes;
+        }
+
+        /// <summary>
+        /// Get the <c>UnmanagedCallersOnlyAttribute</c> trampolines generated for <c>DNNE.ExportAttribute</c> methods.
+        /// </summary>
+        /// <remarks>
+        /// The trampolines are keyed by the full name of the method they call. They aren't public so they
+        /// aren't exports themselves.
+        /// </remarks>
+        private Dictionary<string, (string TypeName, string MethodName)> GetExportTrampolines()
+        {
+            var trampolines = new Dictionary<string, (string TypeName, string MethodName)>(StringComparer.Ordinal);
+            foreach (TypeDefinitionHandle typeDefHandle in this.mdReader.TypeDefinitions)
+            {
+                TypeDefinition typeDef = this.mdReader.GetTypeDefinition(typeDefHandle);
+                foreach (MethodDefinitionHandle methodDefHandle in typeDef.GetMethods())
+                {
+                    MethodDefinition methodDef = this.mdReader.GetMethodDefinition(methodDefHandle);
+                    foreach (CustomAttributeHandle customAttrHandle in methodDef.GetCustomAttributes())
+                    {
+                        CustomAttribute customAttr = this.mdReader.GetCustomAttribute(customAttrHandle);
+                        if (IsAttributeType(this.mdReader, customAttr, "DNNE", "ExportTrampolineAttribute"))
+                        {
+                            trampolines[GetFirstFixedArgAsStringValue(this.typeResolver, customAttr)] =
+                                (this.ComputeEnclosingTypeName(typeDef), this.mdReader.GetString(methodDef.Name));
+                        }
+                    }
+                }
+            }
+
+            return trampolines;
+        }
+
+        public int VerifyReadyToRun(string imagePath, TextWriter outputStream)
+        {
+            List<ExportedMethod> exportedMethods = GetExportedMethods(new List<string>(), new List<ExportedData>());
+
+            // The image is the trimmed and compiled copy of the assembly. Its metadata tokens and MVID
+            // differ from the intermediate assembly, so methods are matched by name in its own metadata.
+            using var imageStream = File.OpenRead(imagePath);
+            using var imagePeReader = new PEReader(imageStream);
+            if (!imagePeReader.HasMetadata)
+            {
+                throw new GeneratorException(imagePath, "Image has no metadata.");
+            }
+
+            MetadataReader imageReader = imagePeReader.GetMetadataReader(MetadataReaderOptions.None);
+            Guid mvid = imageReader.GetGuid(imageReader.GetModuleDefinition().Mvid);
+            ReadyToRunImage r2r = ReadyToRunImage.Load(imagePath, mvid);
+            if (r2r == null)
+            {
+                if (exportedMethods.Count != 0)
+                {
+                    // Use the canonical format so the warning is surfaced by MSBuild.
+                    outputStream.WriteLine($"{imagePath}: warning DNNE0001: Image contains no ReadyToRun code. All {exportedMethods.Count} exports will be compiled by the JIT on first call.");
+                }
+
+                return exportedMethods.Count;
+            }
+
+            // Overloads have the same name, so they are also distinguished by their parameter count.
+            var imageMethods = new Dictionary<(string TypeName, string MethodName, int ParameterCount), List<int>>();
+            foreach (TypeDefinitionHandle typeDefHandle in imageReader.TypeDefinitions)
+            {
+                TypeDefinition typeDef = imageReader.GetTypeDefinition(typeDefHandle);
+                string typeName = ComputeEnclosingTypeName(imageReader, typeDef);
+                foreach (MethodDefinitionHandle methodDefHandle in typeDef.GetMethods())
+                {
+                    MethodDefinition methodDef = imageReader.GetMethodDefinition(methodDefHandle);
+                    var key = (typeName, imageReader.GetString(methodDef.Name), GetParameterCount(imageReader, methodDef));
+                    if (!imageMethods.TryGetValue(key, out List<int> rows))
+                    {
+                        rows = new List<int>();
+                        imageMethods.Add(key, rows);
+                    }
+
+                    rows.Add(MetadataTokens.GetRowNumber(methodDefHandle));
+                }
+            }
+
+            int missing = 0;
+            foreach (ExportedMethod export in exportedMethods)
+            {
+                // The method called by the native export is the one that must have precompiled code.
+                int parameterCount = GetParameterCount(this.mdReader, this.mdReader.GetMethodDefinition(export.Handle));
+                if (imageMethods.TryGetValue((export.BindingTypeName, export.BindingMethodName, parameterCount), out List<int> rows))
+                {
+                    // An overload with the same number of parameters can't be told apart, so all must have code.
+                    if (rows.TrueForAll(r2r.HasMethodEntryPoint))
+                    {
+                        continue;
+                    }
+
+                    outputStream.WriteLine($"{r2r.CodeImagePath}: warning DNNE0002: Export '{export.ExportName}' ({export.BindingTypeName}.{export.BindingMethodName}) has no ReadyToRun code and will be compiled by the JIT on first call.");
+                }
+                else
+                {
+                    outputStream.WriteLine($"{imagePath}: warning DNNE0002: Export '{export.ExportName}' ({export.BindingTypeName}.{export.BindingMethodName}) was not found in the image and will fail to bind.");
+                }
+
+                missing++;
+            }
+
+            return missing;
+        }
+
+        private static int GetParameterCount(MetadataReader reader, MethodDefinition methodDef)
+        {
+            BlobReader signature = reader.GetBlobReader(methodDef.Signature);
+            SignatureHeader header = signature.ReadSignatureHeader();
+            if (header.IsGeneric)
+            {
+                signature.ReadCompressedInteger();
+            }
+
+            return signature.ReadCompressedInteger();
+        }
+
+        private List<ExportedMethod> GetExportedMethods(List<string> additionalCodeStatements, List<ExportedData> exportedData)
+        {
+            // Types are scanned in parallel. The results are merged in metadata
+            // order so the output doesn't depend on how the scan was scheduled.
+            TypeDefinitionHandle[] typeDefHandles = this.mdReader.TypeDefinitions.ToArray();
+            var scans = new TypeScan[typeDefHandles.Length];
+            Parallel.For(0, typeDefHandles.Length, i =>
+            {
+                var scan = new TypeScan();
+                try
+                {
+                    this.ScanType(typeDefHandles[i], scan);
+                }
+                catch (Exception e)
+                {
+                    scan.Error = ExceptionDispatchInfo.Capture(e);
+                }
+
+                scans[i] = scan;
+            });
+
+            // Handle types are declared ahead of user supplied code, which may refer to them.
+            TypeProviderBase typeProvider = this.language == OutputLanguage.Rust
+                ? new RustTypeProvider()
+                : new C99TypeProvider();
+            additionalCodeStatements.AddRange(this.handleTypes.Values.Select(typeProvider.GetHandleTypeDeclaration));
+
             var exportedMethods = new List<ExportedMethod>();
-            foreach (var methodDefHandle in this.mdReader.MethodDefinitions)
+            foreach (TypeScan scan in scans)
+            {
+                // Report the same error as a sequential scan.
+                scan.Error?.Throw();
+                exportedMethods.AddRange(scan.ExportedMethods);
+                exportedData.AddRange(scan.ExportedData);
+                additionalCodeStatements.AddRange(scan.AdditionalCodeStatements);
+            }
+
+            if (exportedMethods.Count == 0 && exportedData.Count == 0)
+            {
+                throw new GeneratorException(this.assemblyPath, "Nothing to export.");
+            }
+
+            return exportedMethods;
+        }
+
+        private void ScanType(TypeDefinitionHandle typeDefHandle, TypeScan scan)
+        {
+            TypeDefinition typeDef = this.mdReader.GetTypeDefinition(typeDefHandle);
+
+            // Computed once for all exports of the type.
+            string enclosingTypeName = null;
+            Scope typeScope = default;
+            void ComputeTypeDetails()
+            {
+                if (enclosingTypeName is null)
+                {
+                    enclosingTypeName = this.ComputeEnclosingTypeName(typeDef);
+                    typeScope = this.GetOSPlatformScope(typeDef.GetCustomAttributes());
+                }
+            }
+
+            foreach (var methodDefHandle in typeDef.GetMethods())
             {
                 MethodDefinition methodDef = this.mdReader.GetMethodDefinition(methodDefHandle);
 
@@ -111,6 +391,9 @@ namespace DNNE
                 var exportAttrType = ExportType.None;
                 string managedMethodName = this.mdReader.GetString(methodDef.Name);
                 string exportName = managedMethodName;
+                int commandOpcode = 0;
+                int remoteIndex = 0;
+                int pureCacheSize = 0;
                 // Check for target attribute
                 foreach (var customAttrHandle in methodDef.GetCustomAttributes())
                 {
@@ -121,7 +404,7 @@ namespace DNNE
                         // Check if method has other supported attributes.
                         if (this.TryGetLanguageDeclCodeAttributeValue(customAttr, out string declCode))
                         {
-                            additionalCodeStatements.Add(declCode);
+                            scan.AdditionalCodeStatements.Add(declCode);
                         }
                         else if (this.TryGetOSPlatformAttributeValue(customAttr, out bool isSupported, out OSPlatform scen))
                         {
@@ -134,6 +417,29 @@ namespace DNNE
                                 unsupported.Add(scen);
                             }
                         }
+                        else if (IsAttributeType(this.mdReader, customAttr, "DNNE", "CommandOpcodeAttribute"))
+                        {
+                            CustomAttributeValue<KnownType> data = customAttr.DecodeValue(this.typeResolver);
+                            commandOpcode = (int)data.FixedArguments[0].Value;
+                        }
+                        else if (IsAttributeType(this.mdReader, customAttr, "DNNE", "RemoteIndexAttribute"))
+                        {
+                            CustomAttributeValue<KnownType> data = customAttr.DecodeValue(this.typeResolver);
+                            remoteIndex = (int)data.FixedArguments[0].Value;
+                        }
+                        else if (IsAttributeType(this.mdReader, customAttr, "DNNE", "PureAttribute"))
+                        {
+                            CustomAttributeValue<KnownType> data = customAttr.DecodeValue(this.typeResolver);
+                            pureCacheSize = data.NamedArguments
+                                .Where(static a => a.Name == "CacheSize")
+                                .Select(static a => (int)a.Value)
+                                .DefaultIfEmpty(DefaultPureCacheSize)
+                                .First();
+                            if (pureCacheSize <= 0)
+                            {
+                                throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' must have a positive DNNE.PureAttribute cache size.");
+                            }
+                        }
 
                         continue;
                     }
@@ -211,25 +517,17 @@ namespace DNNE
                 }
 
                 // Extract method details
-                var typeDef = this.mdReader.GetTypeDefinition(methodDef.GetDeclaringType());
-                var enclosingTypeName = this.ComputeEnclosingTypeName(typeDef);
+                ComputeTypeDetails();
 
                 // Process method signature.
                 MethodSignature<string> signature;
+                TypeProviderBase typeProvider = this.language == OutputLanguage.Rust
+                    ? new RustTypeProvider(this.handleTypes)
+                    : new C99TypeProvider(this.handleTypes);
                 try
                 {
-                    if (this.language == OutputLanguage.Rust)
-                    {
-                        var typeProvider = new RustTypeProvider();
-                        signature = methodDef.DecodeSignature(typeProvider, null);
-                        typeProvider.ThrowIfUnsupportedLastPrimitiveType();
-                    }
-                    else
-                    {
-                        var typeProvider = new C99TypeProvider();
-                        signature = methodDef.DecodeSignature(typeProvider, null);
-                        typeProvider.ThrowIfUnsupportedLastPrimitiveType();
-                    }
+                    signature = methodDef.DecodeSignature(typeProvider, null);
+                    typeProvider.ThrowIfUnsupportedLastPrimitiveType();
                 }
                 catch (NotSupportedTypeException nste)
                 {
@@ -239,17 +537,20 @@ namespace DNNE
                 var returnType = signature.ReturnType;
                 var argumentTypes = signature.ParameterTypes.ToArray();
                 var argumentNames = new string[signature.ParameterTypes.Length];
+                var argumentsByAddress = new bool[signature.ParameterTypes.Length];
+                bool returnByAddress = false;
+                var overriddenTypes = new HashSet<int>();
+
+                // Sequence number starts from 1 for arguments.
+                // Number of 0 indicates return value.
+                // Update arg index to be from [0..n-1]
+                // Return index is -1.
+                const int ReturnIndex = -1;
 
                 // Process each parameter.
                 foreach (ParameterHandle paramHandle in methodDef.GetParameters())
                 {
                     Parameter param = this.mdReader.GetParameter(paramHandle);
-
-                    // Sequence number starts from 1 for arguments.
-                    // Number of 0 indicates return value.
-                    // Update arg index to be from [0..n-1]
-                    // Return index is -1.
-                    const int ReturnIndex = -1;
                     var argIndex = param.SequenceNumber - 1;
                     if (argIndex != ReturnIndex)
                     {
@@ -263,6 +564,7 @@ namespace DNNE
                         CustomAttribute custAttr = this.mdReader.GetCustomAttribute(attr);
                         if (TryGetLanguageTypeAttributeValue(custAttr, out string typeOverride))
                         {
+                            overriddenTypes.Add(argIndex);
                             if (argIndex == ReturnIndex)
                             {
                                 returnType = typeOverride;
@@ -275,9 +577,59 @@ namespace DNNE
                         }
                         else if (TryGetLanguageDeclCodeAttributeValue(custAttr, out string declCode))
                         {
-                            additionalCodeStatements.Add(declCode);
+                            scan.AdditionalCodeStatements.Add(declCode);
+                        }
+                        else if (IsAttributeType(this.mdReader, custAttr, "DNNE", "VectorByValueAttribute"))
+                        {
+                            if (argIndex == ReturnIndex)
+                            {
+                                returnByAddress = true;
+                            }
+                            else
+                            {
+                                argumentsByAddress[argIndex] = true;
+                            }
+                        }
+                    }
+                }
+
+                // SIMD vectors can't be passed by value to managed code, so the generated
+                // shim accepts them by address. The native export passes them by value.
+                for (int i = 0; i < argumentTypes.Length; ++i)
+                {
+                    if (argumentsByAddress[i])
+                    {
+                        if (!overriddenTypes.Contains(i))
+                        {
+                            argumentTypes[i] = typeProvider.GetPointeeType(argumentTypes[i]);
                         }
                     }
+                    else if (typeProvider.IsVectorType(argumentTypes[i]))
+                    {
+                        throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' has a SIMD vector argument. Use DNNE.VectorExportAttribute to export it.");
+                    }
+                }
+
+                if (returnByAddress)
+                {
+                    // The return value is written through the last argument.
+                    if (argumentTypes.Length == 0 || !argumentsByAddress[^1])
+                    {
+                        throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' must have a final DNNE.VectorByValueAttribute argument for the return value.");
+                    }
+
+                    if (!overriddenTypes.Contains(ReturnIndex))
+                    {
+                        returnType = argumentTypes[^1];
+                    }
+
+                    Array.Resize(ref argumentTypes, argumentTypes.Length - 1);
+                    Array.Resize(ref argumentNames, argumentNames.Length - 1);
+                    Array.Resize(ref argumentsByAddress, argumentsByAddress.Length - 1);
+                }
+                else if (typeProvider.IsVectorType(returnType))
+                {
+                    throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' has a SIMD vector return. Use DNNE.VectorExportAttribute to export it.");
                 }
 
                 var xmlDoc = FindXmlDoc(enclosingTypeName.Replace('+', '.') + Type.Delimiter + managedMethodName, argumentTypes);
@@ -294,18 +646,32 @@ namespace DNNE
                     }
                 }
 
-                exportedMethods.Add(new ExportedMethod()
+                // A DNNE.ExportAttribute method with a generated trampoline is bound to
+                // the trampoline like any UnmanagedCallersOnly method, not through a delegate.
+                string bindingTypeName = enclosingTypeName;
+                string bindingMethodName = managedMethodName;
+                if (exportAttrType == ExportType.Export
+                    && this.exportTrampolines.TryGetValue($"{enclosingTypeName}{Type.Delimiter}{managedMethodName}", out var trampoline))
                 {
+                    exportAttrType = ExportType.UnmanagedCallersOnly;
+                    (bindingTypeName, bindingMethodName) = trampoline;
+                }
+
+                var exportedMethod = new ExportedMethod()
+                {
+                    Handle = methodDefHandle,
                     Type = exportAttrType,
                     EnclosingTypeName = enclosingTypeName,
                     MethodName = managedMethodName,
+                    BindingTypeName = bindingTypeName,
+                    BindingMethodName = bindingMethodName,
                     ExportName = exportName,
                     CallingConvention = callConv,
                     Platforms = new PlatformSupport()
                     {
                         Assembly = this.assemblyScope,
                         Module = this.moduleScope,
-                        Type = GetTypeOSPlatformScope(methodDef),
+                        Type = typeScope,
                         Method = new Scope()
                         {
                             Support = supported,
@@ -316,23 +682,256 @@ namespace DNNE
                     XmlDoc = xmlDoc,
                     ArgumentTypes = ImmutableArray.Create(argumentTypes),
                     ArgumentNames = ImmutableArray.Create(argumentNames),
-                });
+                    ArgumentsByAddress = ImmutableArray.Create(argumentsByAddress),
+                    ReturnByAddress = returnByAddress,
+                    CommandOpcode = commandOpcode,
+                    RemoteIndex = remoteIndex,
+                    PureCacheSize = pureCacheSize,
+                };
+
+                bool isCacheable = this.language == OutputLanguage.Rust
+                    ? RustEmitter.IsPureCacheable(exportedMethod)
+                    : C99Emitter.IsPureCacheable(exportedMethod);
+                if (pureCacheSize != 0 && !isCacheable)
+                {
+                    throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' marked with DNNE.PureAttribute must take and return fixed-size integers or floating point values.");
+                }
+
+                // Out-of-process dispatch is only supported for C99.
+                if (remoteIndex != 0 && this.language == OutputLanguage.C99 && !C99Emitter.IsRemotable(exportedMethod))
+                {
+                    throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' marked with DNNE.RemoteIndexAttribute must take and return integers, floating point values or enums.");
+                }
+
+                if (remoteIndex != 0 && this.language == OutputLanguage.C99 && C99Emitter.GetRemotePayloadSize(exportedMethod) > C99Emitter.RemotePayloadSize)
+                {
+                    throw new GeneratorException(this.assemblyPath, $"Method '{managedMethodName}' marked with DNNE.RemoteIndexAttribute must take and return at most {C99Emitter.RemotePayloadSize} bytes, including padding.");
+                }
+
+                scan.ExportedMethods.Add(exportedMethod);
             }
 
-            if (exportedMethods.Count == 0)
+            // Constants and read-only data marked for export.
+            foreach (FieldDefinitionHandle fieldDefHandle in typeDef.GetFields())
             {
-                throw new GeneratorException(this.assemblyPath, "Nothing to export.");
+                FieldDefinition fieldDef = this.mdReader.GetFieldDefinition(fieldDefHandle);
+                if (!this.TryGetExportDataAttribute(fieldDef.GetCustomAttributes(), out string exportName, out Scope memberScope))
+                {
+                    continue;
+                }
+
+                ComputeTypeDetails();
+                string fieldName = this.mdReader.GetString(fieldDef.Name);
+                object constant = null;
+                ImmutableArray<byte> data = default;
+                if (fieldDef.Attributes.HasFlag(FieldAttributes.Literal))
+                {
+                    constant = this.GetConstantValue(fieldDef, fieldName);
+                }
+                else if (fieldDef.Attributes.HasFlag(FieldAttributes.Static | FieldAttributes.HasFieldRVA))
+                {
+                    data = this.GetFieldData(fieldDef, this.GetFieldSize(fieldDef, fieldName));
+                }
+                else
+                {
+                    throw new GeneratorException(this.assemblyPath, $"Field '{fieldName}' must be a constant to be exported as data.");
+                }
+
+                scan.ExportedData.Add(this.CreateExportedData(enclosingTypeName, typeScope, memberScope, fieldName, exportName, 'F', constant, data));
             }
 
-            string assemblyName = this.mdReader.GetString(this.mdReader.GetAssemblyDefinition().Name);
-            if (this.language == OutputLanguage.Rust)
+            foreach (PropertyDefinitionHandle propDefHandle in typeDef.GetProperties())
+            {
+                PropertyDefinition propDef = this.mdReader.GetPropertyDefinition(propDefHandle);
+                if (!this.TryGetExportDataAttribute(propDef.GetCustomAttributes(), out string exportName, out Scope memberScope))
+                {
+                    continue;
+                }
+
+                ComputeTypeDetails();
+                string propName = this.mdReader.GetString(propDef.Name);
+                ImmutableArray<byte> data = this.GetPropertyData(propDef, propName);
+                scan.ExportedData.Add(this.CreateExportedData(enclosingTypeName, typeScope, memberScope, propName, exportName, 'P', null, data));
+            }
+        }
+
+        private ExportedData CreateExportedData(
+            string enclosingTypeName,
+            Scope typeScope,
+            Scope memberScope,
+            string memberName,
+            string exportName,
+            char memberKind,
+            object constant,
+            ImmutableArray<byte> data)
+        {
+            return new ExportedData()
             {
-                RustEmitter.Emit(outputStream, assemblyName, exportedMethods, additionalCodeStatements);
+                EnclosingTypeName = enclosingTypeName,
+                MemberName = memberName,
+                ExportName = exportName ?? memberName,
+                Platforms = new PlatformSupport()
+                {
+                    Assembly = this.assemblyScope,
+                    Module = this.moduleScope,
+                    Type = typeScope,
+                    Method = memberScope,
+                },
+                XmlDoc = FindMemberXmlDoc($"{memberKind}:{enclosingTypeName.Replace('+', '.')}{Type.Delimiter}{memberName}"),
+                Constant = constant,
+                Data = data,
+            };
+        }
+
+        private bool TryGetExportDataAttribute(CustomAttributeHandleCollection attrs, out string exportName, out Scope memberScope)
+        {
+            bool found = false;
+            exportName = null;
+            var supported = new List<OSPlatform>();
+            var unsupported = new List<OSPlatform>();
+            foreach (var customAttrHandle in attrs)
+            {
+                CustomAttribute customAttr = this.mdReader.GetCustomAttribute(customAttrHandle);
+                if (IsAttributeType(this.mdReader, customAttr, "DNNE", "ExportDataAttribute"))
+                {
+                    found = true;
+                    CustomAttributeValue<KnownType> data = customAttr.DecodeValue(this.typeResolver);
+                    if (data.NamedArguments.Length == 1)
+                    {
+                        exportName = (string)data.NamedArguments[0].Value;
+                    }
+                }
+                else if (this.TryGetOSPlatformAttributeValue(customAttr, out bool isSupported, out OSPlatform scen))
+                {
+                    (isSupported ? supported : unsupported).Add(scen);
+                }
             }
-            else
+
+            memberScope = new Scope()
+            {
+                Support = supported,
+                NoSupport = unsupported,
+            };
+            return found;
+        }
+
+        private object GetConstantValue(FieldDefinition fieldDef, string fieldName)
+        {
+            Constant constant = this.mdReader.GetConstant(fieldDef.GetDefaultValue());
+            object value = constant.TypeCode switch
+            {
+                ConstantTypeCode.String or ConstantTypeCode.NullReference => null,
+                _ => this.mdReader.GetBlobReader(constant.Value).ReadConstant(constant.TypeCode),
+            };
+
+            if (value is null || (value is float f && !float.IsFinite(f)) || (value is double d && !double.IsFinite(d)))
+            {
+                throw new GeneratorException(this.assemblyPath, $"Field '{fieldName}' must be a finite primitive constant to be exported as data.");
+            }
+
+            return value;
+        }
+
+        // The size of an RVA field is the size of its type.
+        private int GetFieldSize(FieldDefinition fieldDef, string fieldName)
+        {
+            BlobReader signature = this.mdReader.GetBlobReader(fieldDef.Signature);
+            signature.ReadSignatureHeader();
+            SignatureTypeCode typeCode = signature.ReadSignatureTypeCode();
+            int size = typeCode switch
+            {
+                SignatureTypeCode.Boolean or SignatureTypeCode.SByte or SignatureTypeCode.Byte => 1,
+                SignatureTypeCode.Char or SignatureTypeCode.Int16 or SignatureTypeCode.UInt16 => 2,
+                SignatureTypeCode.Int32 or SignatureTypeCode.UInt32 or SignatureTypeCode.Single => 4,
+                SignatureTypeCode.Int64 or SignatureTypeCode.UInt64 or SignatureTypeCode.Double => 8,
+                SignatureTypeCode.TypeHandle when signature.ReadTypeHandle() is { Kind: HandleKind.TypeDefinition } handle
+                    => this.mdReader.GetTypeDefinition((TypeDefinitionHandle)handle).GetLayout().Size,
+                _ => 0,
+            };
+
+            if (size <= 0)
             {
-                C99Emitter.Emit(outputStream, assemblyName, exportedMethods, additionalCodeStatements);
+                throw new GeneratorException(this.assemblyPath, $"Field '{fieldName}' has data of unknown size.");
             }
+
+            return size;
+        }
+
+        private ImmutableArray<byte> GetFieldData(FieldDefinition fieldDef, int size)
+        {
+            return this.peReader.GetSectionData(fieldDef.GetRelativeVirtualAddress()).GetContent(0, size);
+        }
+
+        // A ReadOnlySpan<byte> property over constant data, for example "static ReadOnlySpan<byte> Table => new byte[] { ... };",
+        // is compiled to a getter that returns a span over an RVA field.
+        private ImmutableArray<byte> GetPropertyData(PropertyDefinition propDef, string propName)
+        {
+            GeneratorException Invalid() => new GeneratorException(this.assemblyPath, $"Property '{propName}' must be a static ReadOnlySpan<byte> over constant data to be exported as data.");
+
+            BlobReader signature = this.mdReader.GetBlobReader(propDef.Signature);
+            if (signature.ReadSignatureHeader().IsInstance
+                || signature.ReadCompressedInteger() != 0
+                || signature.ReadSignatureTypeCode() != SignatureTypeCode.GenericTypeInstance
+                || signature.ReadCompressedInteger() != (int)SignatureTypeKind.ValueType
+                || !this.IsTypeNamed(signature.ReadTypeHandle(), "System", "ReadOnlySpan`1")
+                || signature.ReadCompressedInteger() != 1
+                || signature.ReadSignatureTypeCode() is not (SignatureTypeCode.Byte or SignatureTypeCode.SByte))
+            {
+                throw Invalid();
+            }
+
+            MethodDefinitionHandle getterHandle = propDef.GetAccessors().Getter;
+            if (getterHandle.IsNil)
+            {
+                throw Invalid();
+            }
+
+            // Expect: ldsflda <field>; ldc.i4 <length>; newobj ReadOnlySpan<byte>(void*, int); ret
+            MethodDefinition getter = this.mdReader.GetMethodDefinition(getterHandle);
+            BlobReader il = this.peReader.GetMethodBody(getter.RelativeVirtualAddress).GetILReader();
+            if (il.RemainingBytes < 5 || (ILOpCode)il.ReadByte() != ILOpCode.Ldsflda)
+            {
+                throw Invalid();
+            }
+
+            EntityHandle fieldHandle = MetadataTokens.EntityHandle(il.ReadInt32());
+            int length = il.RemainingBytes == 0 ? -1 : (ILOpCode)il.ReadByte() switch
+            {
+                >= ILOpCode.Ldc_i4_0 and <= ILOpCode.Ldc_i4_8 and var op => op - ILOpCode.Ldc_i4_0,
+                ILOpCode.Ldc_i4_s when il.RemainingBytes >= 1 => il.ReadSByte(),
+                ILOpCode.Ldc_i4 when il.RemainingBytes >= 4 => il.ReadInt32(),
+                _ => -1,
+            };
+
+            if (length <= 0
+                || fieldHandle.Kind != HandleKind.FieldDefinition
+                || il.RemainingBytes != 6
+                || (ILOpCode)il.ReadByte() != ILOpCode.Newobj)
+            {
+                throw Invalid();
+            }
+
+            FieldDefinition fieldDef = this.mdReader.GetFieldDefinition((FieldDefinitionHandle)fieldHandle);
+            if (!fieldDef.Attributes.HasFlag(FieldAttributes.Static | FieldAttributes.HasFieldRVA))
+            {
+                throw Invalid();
+            }
+
+            return this.GetFieldData(fieldDef, length);
+        }
+
+        private bool IsTypeNamed(EntityHandle handle, string targetNamespace, string targetName)
+        {
+            (StringHandle ns, StringHandle name) = handle.Kind switch
+            {
+                HandleKind.TypeReference => (this.mdReader.GetTypeReference((TypeReferenceHandle)handle).Namespace, this.mdReader.GetTypeReference((TypeReferenceHandle)handle).Name),
+                HandleKind.TypeDefinition => (this.mdReader.GetTypeDefinition((TypeDefinitionHandle)handle).Namespace, this.mdReader.GetTypeDefinition((TypeDefinitionHandle)handle).Name),
+                _ => (default, default),
+            };
+
+            return !name.IsNil
+                && this.mdReader.StringComparer.Equals(ns, targetNamespace)
+                && this.mdReader.StringComparer.Equals(name, targetName);
         }
 
         private static Dictionary<string, string> LoadXmlDocumentation(string xmlDocumentation)
@@ -348,8 +947,13 @@ namespace DNNE
             {
                 if (xmlReader.NodeType == XmlNodeType.Element && xmlReader.Name == "member")
                 {
+                    // Methods are indexed by name without the parameter list.
+                    // The first of a set of overloads is used.
                     string raw_name = xmlReader["name"];
-                    actXml[raw_name] = xmlReader.ReadInnerXml();
+                    int paramStart = raw_name.IndexOf('(');
+                    string name = paramStart < 0 ? raw_name : raw_name[..paramStart];
+                    string doc = xmlReader.ReadInnerXml();
+                    actXml.TryAdd(name, doc);
                 }
             }
             return actXml;
@@ -357,16 +961,12 @@ namespace DNNE
 
         private string FindXmlDoc(string fullMethodName, string[] argumentTypes)
         {
-            string xmlDoc = "";
-            foreach (var item in loadedXmlDocumentation)
-            {
-                if (item.Key.StartsWith("M:" + fullMethodName))
-                {
-                    xmlDoc = item.Value;
-                    break;
-                }
-            }
-            if (xmlDoc == "")
+            return FindMemberXmlDoc("M:" + fullMethodName);
+        }
+
+        private string FindMemberXmlDoc(string memberId)
+        {
+            if (!loadedXmlDocumentation.TryGetValue(memberId, out string xmlDoc) || xmlDoc == "")
                 return "";
 
             var lines = xmlDoc.TrimStart('\n').TrimEnd().Split("\n");
@@ -408,19 +1008,24 @@ namespace DNNE
 
         private string ComputeEnclosingTypeName(TypeDefinition typeDef)
         {
-            var enclosingTypes = new List<string>() { this.mdReader.GetString(typeDef.Name) };
+            return ComputeEnclosingTypeName(this.mdReader, typeDef);
+        }
+
+        private static string ComputeEnclosingTypeName(MetadataReader reader, TypeDefinition typeDef)
+        {
+            var enclosingTypes = new List<string>() { reader.GetString(typeDef.Name) };
             TypeDefinition parentTypeDef = typeDef;
             while (parentTypeDef.IsNested)
             {
-                parentTypeDef = this.mdReader.GetTypeDefinition(parentTypeDef.GetDeclaringType());
-                enclosingTypes.Add(this.mdReader.GetString(parentTypeDef.Name));
+                parentTypeDef = reader.GetTypeDefinition(parentTypeDef.GetDeclaringType());
+                enclosingTypes.Add(reader.GetString(parentTypeDef.Name));
             }
 
             enclosingTypes.Reverse();
             string name = string.Join('+', enclosingTypes);
             if (!parentTypeDef.Namespace.IsNil)
             {
-                name = $"{this.mdReader.GetString(parentTypeDef.Namespace)}{Type.Delimiter}{name}";
+                name = $"{reader.GetString(parentTypeDef.Namespace)}{Type.Delimiter}{name}";
             }
 
             return name;
@@ -444,22 +1049,6 @@ namespace DNNE
             return !string.IsNullOrEmpty(declCode);
         }
 
-        private Scope GetTypeOSPlatformScope(MethodDefinition methodDef)
-        {
-            TypeDefinitionHandle typeDefHandle = methodDef.GetDeclaringType();
-            if (this.typePlatformScenarios.TryGetValue(typeDefHandle, out Scope scope))
-            {
-                return scope;
-            }
-
-            TypeDefinition typeDef = this.mdReader.GetTypeDefinition(typeDefHandle);
-            var typeScope = this.GetOSPlatformScope(typeDef.GetCustomAttributes());
-
-            // Record and return the scenarios.
-            this.typePlatformScenarios.Add(typeDefHandle, typeScope);
-            return typeScope;
-        }
-
         private Scope GetOSPlatformScope(CustomAttributeHandleCollection attrs)
         {
             var supported = new List<OSPlatform>();
@@ -579,6 +1168,15 @@ namespace DNNE
             return reader.StringComparer.Equals(namespaceMaybe, targetNamespace) && reader.StringComparer.Equals(nameMaybe, targetName);
         }
 
+        // Results of scanning a single type for exports.
+        private sealed class TypeScan
+        {
+            public readonly List<ExportedMethod> ExportedMethods = new List<ExportedMethod>();
+            public readonly List<ExportedData> ExportedData = new List<ExportedData>();
+            public readonly List<string> AdditionalCodeStatements = new List<string>();
+            public ExceptionDispatchInfo Error;
+        }
+
         private enum KnownType
         {
             Unknown,
@@ -691,11 +1289,70 @@ namespace DNNE
         public IEnumerable<OSPlatform> NoSupport { get; init; }
     }
 
+    internal class ExportedData
+    {
+        public string EnclosingTypeName { get; init; }
+        public string MemberName { get; init; }
+        public string ExportName { get; init; }
+        public PlatformSupport Platforms { get; init; }
+        public string XmlDoc { get; init; }
+
+        // The boxed value of a primitive constant, otherwise null.
+        public object Constant { get; init; }
+
+        // The contents of read-only data when not a constant.
+        public ImmutableArray<byte> Data { get; init; }
+
+        // Write the data as hexadecimal bytes, 16 to a line, for an array initializer in C or Rust.
+        // Data may be tens of megabytes, so each line is written from a reused buffer.
+        public void WriteData(TextWriter writer) => WriteBytes(writer, Data.AsSpan());
+
+        public static void WriteBytes(TextWriter writer, ReadOnlySpan<byte> data)
+        {
+            const string Digits = "0123456789abcdef";
+            const int BytesPerLine = 16;
+            var line = new char[4 + (BytesPerLine * 6)];
+            for (int i = 0; i < data.Length; i += BytesPerLine)
+            {
+                int length = 0;
+                line[length++] = ' ';
+                line[length++] = ' ';
+                line[length++] = ' ';
+                line[length++] = ' ';
+                for (int j = i; j < Math.Min(i + BytesPerLine, data.Length); ++j)
+                {
+                    line[length++] = '0';
+                    line[length++] = 'x';
+                    line[length++] = Digits[data[j] >> 4];
+                    line[length++] = Digits[data[j] & 0xf];
+                    line[length++] = ',';
+                    line[length++] = ' ';
+                }
+
+                // Drop the trailing space.
+                writer.WriteLine(line, 0, length - 1);
+            }
+        }
+
+        // Floating-point literals require a decimal point or exponent in C and Rust.
+        public static string FormatFloatingPoint(string value)
+        {
+            return value.IndexOfAny(new[] { '.', 'E', 'e' }) < 0 ? $"{value}.0" : value;
+        }
+    }
+
     internal class ExportedMethod
     {
+        public MethodDefinitionHandle Handle { get; init; }
         public ExportType Type { get; init; }
         public string EnclosingTypeName { get; init; }
         public string MethodName { get; init; }
+
+        // Type and method the export is bound to. These differ from the enclosing type and
+        // method for a DNNE.ExportAttribute method with a generated trampoline.
+        public string BindingTypeName { get; init; }
+        public string BindingMethodName { get; init; }
+
         public string ExportName { get; init; }
         public SignatureCallingConvention CallingConvention { get; init; }
         public PlatformSupport Platforms { get; init; }
@@ -703,5 +1360,18 @@ namespace DNNE
         public string XmlDoc { get; init; }
         public ImmutableArray<string> ArgumentTypes { get; init; }
         public ImmutableArray<string> ArgumentNames { get; init; }
+
+        // Arguments and return value passed to the managed function by address.
+        public ImmutableArray<bool> ArgumentsByAddress { get; init; }
+        public bool ReturnByAddress { get; init; }
+
+        // Opcode used to record calls in a command buffer, or 0 if calls can't be recorded.
+        public int CommandOpcode { get; init; }
+
+        // Number of results cached by the native export, or 0 if results aren't cached.
+        public int PureCacheSize { get; init; }
+
+        // Index used to dispatch calls in the shared server process, or 0 if calls always run in process.
+        public int RemoteIndex { get; init; }
     }
 }
@@ -36,8 +36,16 @@ namespace DNNE
 
                 var parsed = Parse(args);
 
-                using (var g = new Generator(parsed.AssemblyPath, parsed.XmlDocFile, parsed.Language))
+                using (var g = new Generator(parsed.AssemblyPath, parsed.XmlDocFile, parsed.Language) { Vector256Avx = parsed.Vector256Avx })
                 {
+                    // Verification of precompiled code replaces source generation.
+                    if (!string.IsNullOrWhiteSpace(parsed.ReadyToRunImagePath))
+                    {
+                        int missing = g.VerifyReadyToRun(parsed.ReadyToRunImagePath, Console.Out);
+                        Console.WriteLine($"ReadyToRun verification of '{parsed.ReadyToRunImagePath}' found {missing} export(s) without precompiled code.");
+                        return;
+                    }
+
                     if (string.IsNullOrWhiteSpace(parsed.OutputPath))
                     {
                         g.Emit(Console.Out);
@@ -47,6 +55,18 @@ namespace DNNE
                         g.Emit(parsed.OutputPath);
                         Console.WriteLine($"Generated exports written to '{parsed.OutputPath}'.");
                     }
+
+                    if (!string.IsNullOrWhiteSpace(parsed.TrimmerDescriptorPath))
+                    {
+                        g.EmitTrimmerDescriptor(parsed.TrimmerDescriptorPath);
+                        Console.WriteLine($"Trimmer descriptor written to '{parsed.TrimmerDescriptorPath}'.");
+                    }
+
+                    if (!string.IsNullOrWhiteSpace(parsed.EmbeddedSourcePath))
+                    {
+                        g.EmitEmbeddedAssembly(parsed.EmbeddedSourcePath, parsed.RuntimeConfigPath);
+                        Console.WriteLine($"Embedded assembly source written to '{parsed.EmbeddedSourcePath}'.");
+                    }
                 }
             }
             catch (ParseException pe)
@@ -64,7 +84,12 @@ namespace DNNE
             public string AssemblyPath { get; set; }
             public string OutputPath { get; set; }
             public string XmlDocFile { get; set; }
+            public string TrimmerDescriptorPath { get; set; }
+            public string ReadyToRunImagePath { get; set; }
+            public string EmbeddedSourcePath { get; set; }
+            public string RuntimeConfigPath { get; set; }
             public Generator.OutputLanguage Language { get; set; } = Generator.OutputLanguage.C99;
+            public bool Vector256Avx { get; set; }
         }
 
         class ParseException : Exception
@@ -137,6 +162,54 @@ namespace DNNE
                         parsed.XmlDocFile = arg;
                         break;
                     }
+                    case "t":
+                    {
+                        if ((i + 1) == args.Length)
+                        {
+                            throw new ParseException(flag, "Missing trimmer descriptor file");
+                        }
+                        arg = args[++i];
+                        parsed.TrimmerDescriptorPath = arg;
+                        break;
+                    }
+                    case "r":
+                    {
+                        if ((i + 1) == args.Length)
+                        {
+                            throw new ParseException(flag, "Missing ReadyToRun image");
+                        }
+                        arg = args[++i];
+                        if (!File.Exists(arg))
+                        {
+                            throw new ParseException(arg, "ReadyToRun image not found.");
+                        }
+                        parsed.ReadyToRunImagePath = arg;
+                        break;
+                    }
+                    case "e":
+                    {
+                        if ((i + 1) == args.Length)
+                        {
+                            throw new ParseException(flag, "Missing embedded assembly source file");
+                        }
+                        arg = args[++i];
+                        parsed.EmbeddedSourcePath = arg;
+                        break;
+                    }
+                    case "c":
+                    {
+                        if ((i + 1) == args.Length)
+                        {
+                            throw new ParseException(flag, "Missing runtimeconfig.json file");
+                        }
+                        arg = args[++i];
+                        if (!File.Exists(arg))
+                        {
+                            throw new ParseException(arg, "Runtimeconfig.json file not found.");
+                        }
+                        parsed.RuntimeConfigPath = arg;
+                        break;
+                    }
                     case "l":
                     {
                         if ((i + 1) == args.Length)
@@ -152,11 +225,26 @@ namespace DNNE
                         };
                         break;
                     }
+                    case "v":
+                    {
+                        if ((i + 1) == args.Length)
+                        {
+                            throw new ParseException(flag, "Missing vector ABI");
+                        }
+                        arg = args[++i];
+                        parsed.Vector256Avx = arg.ToLowerInvariant() switch
+                        {
+                            "portable" => false,
+                            "avx" => true,
+                            _ => throw new ParseException(arg, "Unsupported vector ABI."),
+                        };
+                        break;
+                    }
                     case "?":
                     case "help":
                     {
                         throw new ParseException(flag,
-@"Syntax: dnne-gen [-o <filepath> | -l <language> | -?]+ <path_to_assembly>
+@"Syntax: dnne-gen [-o <filepath> | -d <xmldocfile> | -t <filepath> | -r <r2rimage> | -e <filepath> | -c <runtimeconfig> | -l <language> | -v <abi> | -?]+ <path_to_assembly>
     -o <filepath>   : The output file for the generated source.
                         The last value is used. If file exists,
                         it will be overwritten.
@@ -166,8 +254,24 @@ namespace DNNE
                         This can be activated project properties.
                         If supplied the comments from the functions
                         are added to the output header file.
+    -t <filepath>   : The output file for an ILLink descriptor that
+                        preserves the exported methods when the
+                        assembly is trimmed.
+    -r <r2rimage>   : Verify the exports have precompiled code in
+                        the ReadyToRun image of the assembly instead
+                        of generating source. A warning is written
+                        for each export that will be JIT compiled.
+    -e <filepath>   : The output file for C source that embeds the
+                        assembly in the native binary. Compile it
+                        with DNNE_EMBED_ASSEMBLY defined.
+    -c <runtimeconfig> : The runtimeconfig.json file to embed with
+                        the assembly. Requires -e.
     -l <language>   : The output language for generated source.
                         Supported: c99 (default), rust.
+    -v <abi>        : How 256-bit vectors are passed by C99 exports.
+                        Supported: portable (default), avx.
+                        With avx the generated header requires
+                        AVX to be enabled in every consumer.
     -?              : This message.
 ");
                     }
@@ -176,6 +280,11 @@ namespace DNNE
                 }
             }
 
+            if (parsed.RuntimeConfigPath != null && string.IsNullOrWhiteSpace(parsed.EmbeddedSourcePath))
+            {
+                throw new ParseException("c", "Embedding the runtimeconfig.json file requires -e.");
+            }
+
             return parsed;
         }
     }
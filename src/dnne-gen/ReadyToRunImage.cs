@@ -0,0 +1,303 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+using System.Buffers.Binary;
+using System.IO;
+using System.Reflection.PortableExecutable;
+using System.Text;
+
+namespace DNNE
+{
+    /// <summary>
+    /// Minimal reader for the precompiled code in a ReadyToRun image.
+    /// </summary>
+    /// <remarks>
+    /// Only the method entry points of non-generic methods are inspected.
+    /// See https://github.com/dotnet/runtime/blob/main/docs/design/coreclr/botr/readytorun-format.md
+    /// </remarks>
+    internal sealed class ReadyToRunImage
+    {
+        private const uint ReadyToRunSignature = 0x00525452; // 'RTR'
+        private const uint FlagComponent = 0x20;
+
+        private const uint SectionMethodDefEntryPoints = 103;
+        private const uint SectionComponentAssemblies = 115;
+        private const uint SectionOwnerCompositeExecutable = 116;
+        private const uint SectionManifestAssemblyMvids = 118;
+
+        private const int NativeArrayBlockSize = 16;
+
+        private readonly string imagePath;
+        private readonly byte[] image;
+        private readonly PEHeaders headers;
+        private readonly int coreHeaderOffset;
+        private readonly int methodEntryPointsBase;
+        private readonly int methodEntryPointsCount;
+        private readonly int methodEntryPointsIndexSize;
+
+        /// <summary>
+        /// The image that contains the precompiled code.
+        /// </summary>
+        /// <remarks>
+        /// For a component of a composite image this is the composite image.
+        /// </remarks>
+        public string CodeImagePath => this.imagePath;
+
+        private ReadyToRunImage(string imagePath, byte[] image, PEHeaders headers, int coreHeaderOffset)
+        {
+            this.imagePath = imagePath;
+            this.image = image;
+            this.headers = headers;
+            this.coreHeaderOffset = coreHeaderOffset;
+            this.methodEntryPointsBase = -1;
+
+            if (!TryFindSection(coreHeaderOffset, SectionMethodDefEntryPoints, out int offset, out _))
+            {
+                return;
+            }
+
+            offset = DecodeUnsigned(offset, out uint val);
+            this.methodEntryPointsBase = offset;
+            this.methodEntryPointsCount = (int)(val >> 2);
+            this.methodEntryPointsIndexSize = (int)(val & 3);
+        }
+
+        /// <summary>
+        /// Load the ReadyToRun code for the module with the supplied MVID.
+        /// </summary>
+        /// <param name="imagePath">ReadyToRun image or component of a composite image</param>
+        /// <param name="mvid">MVID of the module</param>
+        /// <returns>The image or null if the image contains no precompiled code.</returns>
+        public static ReadyToRunImage Load(string imagePath, Guid mvid)
+        {
+            byte[] image = File.ReadAllBytes(imagePath);
+            PEHeaders headers;
+            using (var peReader = new PEReader(new MemoryStream(image)))
+            {
+                headers = peReader.PEHeaders;
+            }
+
+            DirectoryEntry nativeHeader = headers.CorHeader?.ManagedNativeHeaderDirectory ?? default;
+            if (nativeHeader.Size == 0
+                || !TryGetOffset(headers, nativeHeader.RelativeVirtualAddress, out int headerOffset)
+                || BinaryPrimitives.ReadUInt32LittleEndian(image.AsSpan(headerOffset)) != ReadyToRunSignature)
+            {
+                return null;
+            }
+
+            // READYTORUN_HEADER is the signature and the major and minor versions
+            // followed by the READYTORUN_CORE_HEADER.
+            int coreHeaderOffset = headerOffset + 8;
+            var r2r = new ReadyToRunImage(imagePath, image, headers, coreHeaderOffset);
+
+            uint flags = BinaryPrimitives.ReadUInt32LittleEndian(image.AsSpan(coreHeaderOffset));
+            if ((flags & FlagComponent) == 0)
+            {
+                return r2r;
+            }
+
+            // A component of a composite image points at the image with the code.
+            if (!r2r.TryFindSection(coreHeaderOffset, SectionOwnerCompositeExecutable, out int nameOffset, out int nameLength))
+            {
+                return null;
+            }
+
+            string compositeName = Encoding.UTF8.GetString(image, nameOffset, nameLength).TrimEnd('\0');
+            string compositePath = Path.Combine(Path.GetDirectoryName(imagePath), compositeName);
+            if (!File.Exists(compositePath))
+            {
+                throw new GeneratorException(imagePath, $"Composite image '{compositePath}' not found.");
+            }
+
+            return LoadComponent(compositePath, mvid);
+        }
+
+        private static ReadyToRunImage LoadComponent(string compositePath, Guid mvid)
+        {
+            ReadyToRunImage composite = Load(compositePath, mvid);
+            if (composite == null)
+            {
+                return null;
+            }
+
+            // Components are identified by their position in the MVID table.
+            if (!composite.TryFindSection(composite.coreHeaderOffset, SectionManifestAssemblyMvids, out int mvidsOffset, out int mvidsLength)
+                || !composite.TryFindSection(composite.coreHeaderOffset, SectionComponentAssemblies, out int componentsOffset, out _))
+            {
+                return null;
+            }
+
+            const int MvidSize = 16;
+            for (int i = 0; i < mvidsLength / MvidSize; ++i)
+            {
+                var componentMvid = new Guid(composite.image.AsSpan(mvidsOffset + (i * MvidSize), MvidSize));
+                if (componentMvid != mvid)
+                {
+                    continue;
+                }
+
+                // READYTORUN_COMPONENT_ASSEMBLIES_ENTRY is the COR header and
+                // the READYTORUN_CORE_HEADER directories of the component.
+                const int EntrySize = 16;
+                uint componentHeaderRva = BinaryPrimitives.ReadUInt32LittleEndian(composite.image.AsSpan(componentsOffset + (i * EntrySize) + 8));
+                if (!TryGetOffset(composite.headers, (int)componentHeaderRva, out int componentHeaderOffset))
+                {
+                    return null;
+                }
+
+                return new ReadyToRunImage(compositePath, composite.image, composite.headers, componentHeaderOffset);
+            }
+
+            return null;
+        }
+
+        /// <summary>
+        /// Determine if the method has precompiled code in the image.
+        /// </summary>
+        /// <param name="methodDefRowId">Row in the MethodDef table</param>
+        /// <returns>True if precompiled code exists, otherwise false.</returns>
+        public bool HasMethodEntryPoint(int methodDefRowId)
+        {
+            if (this.methodEntryPointsBase < 0)
+            {
+                return false;
+            }
+
+            // Method entry points are stored in a NativeArray indexed by RID - 1.
+            // The array is a sequence of blocks, each a binary tree over the block's
+            // indices. See NativeFormatReader.h in dotnet/runtime.
+            uint index = (uint)methodDefRowId - 1;
+            if (index >= (uint)this.methodEntryPointsCount)
+            {
+                return false;
+            }
+
+            int blockOffset = this.methodEntryPointsBase;
+            int offset = this.methodEntryPointsIndexSize switch
+            {
+                0 => this.image[blockOffset + (int)(index / NativeArrayBlockSize)],
+                1 => BinaryPrimitives.ReadUInt16LittleEndian(this.image.AsSpan(blockOffset + (2 * (int)(index / NativeArrayBlockSize)))),
+                _ => (int)BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(blockOffset + (4 * (int)(index / NativeArrayBlockSize)))),
+            };
+            offset += blockOffset;
+
+            for (uint bit = NativeArrayBlockSize >> 1; bit > 0; bit >>= 1)
+            {
+                int next = DecodeUnsigned(offset, out uint val);
+                if ((index & bit) != 0)
+                {
+                    if ((val & 2) != 0)
+                    {
+                        offset += (int)(val >> 2);
+                        continue;
+                    }
+                }
+                else
+                {
+                    if ((val & 1) != 0)
+                    {
+                        offset = next;
+                        continue;
+                    }
+                }
+
+                // Check for a leaf node that matches the index.
+                return (val & 3) == 0 && (val >> 2) == (index & (NativeArrayBlockSize - 1));
+            }
+
+            return true;
+        }
+
+        private bool TryFindSection(int coreHeaderOffset, uint type, out int offset, out int size)
+        {
+            // READYTORUN_CORE_HEADER is the flags and section count followed
+            // by the READYTORUN_SECTION entries (type and directory).
+            uint count = BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(coreHeaderOffset + 4));
+            int sectionOffset = coreHeaderOffset + 8;
+            for (uint i = 0; i < count; ++i, sectionOffset += 12)
+            {
+                if (BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(sectionOffset)) != type)
+                {
+                    continue;
+                }
+
+                int rva = (int)BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(sectionOffset + 4));
+                size = (int)BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(sectionOffset + 8));
+                return TryGetOffset(this.headers, rva, out offset);
+            }
+
+            offset = 0;
+            size = 0;
+            return false;
+        }
+
+        private int DecodeUnsigned(int offset, out uint value)
+        {
+            uint val = this.image[offset];
+            if ((val & 1) == 0)
+            {
+                value = val >> 1;
+                return offset + 1;
+            }
+            else if ((val & 2) == 0)
+            {
+                value = (val >> 2) | ((uint)this.image[offset + 1] << 6);
+                return offset + 2;
+            }
+            else if ((val & 4) == 0)
+            {
+                value = (val >> 3)
+                    | ((uint)this.image[offset + 1] << 5)
+                    | ((uint)this.image[offset + 2] << 13);
+                return offset + 3;
+            }
+            else if ((val & 8) == 0)
+            {
+                value = (val >> 4)
+                    | ((uint)this.image[offset + 1] << 4)
+                    | ((uint)this.image[offset + 2] << 12)
+                    | ((uint)this.image[offset + 3] << 20);
+                return offset + 4;
+            }
+            else if ((val & 16) == 0)
+            {
+                value = BinaryPrimitives.ReadUInt32LittleEndian(this.image.AsSpan(offset + 1));
+                return offset + 5;
+            }
+
+            throw new GeneratorException(this.imagePath, "Invalid ReadyToRun image.");
+        }
+
+        private static bool TryGetOffset(PEHeaders headers, int rva, out int offset)
+        {
+            foreach (SectionHeader section in headers.SectionHeaders)
+            {
+                if (rva >= section.VirtualAddress && rva < section.VirtualAddress + section.SizeOfRawData)
+                {
+                    offset = rva - section.VirtualAddress + section.PointerToRawData;
+                    return true;
+                }
+            }
+
+            offset = 0;
+            return false;
+        }
+    }
+}
@@ -19,8 +19,8 @@
 
 using System;
 using System.Collections.Generic;
-using System.Collections.Specialized;
 using System.Diagnostics;
+using System.Globalization;
 using System.IO;
 using System.Linq;
 using System.Runtime.InteropServices;
@@ -54,7 +54,7 @@ namespace DNNE
         private static string SafeRustIdentifier(string name)
             => s_rustKeywords.Contains(name) ? $"r#{name}" : name;
 
-        public static void Emit(TextWriter outputStream, string assemblyName, IEnumerable<ExportedMethod> exports, IEnumerable<string> additionalCodeStatements)
+        public static void Emit(TextWriter outputStream, string assemblyName, IEnumerable<ExportedMethod> exports, IEnumerable<ExportedData> data, IEnumerable<string> additionalCodeStatements)
         {
             // Emit preamble
             outputStream.WriteLine(
@@ -98,20 +98,20 @@ $@"
 // String constants
 //");
             int count = 1;
-            var map = new StringDictionary();
+            var map = new Dictionary<string, string>(StringComparer.Ordinal);
             foreach (var method in exports)
             {
-                if (map.ContainsKey(method.EnclosingTypeName))
+                if (map.ContainsKey(method.BindingTypeName))
                 {
                     continue;
                 }
 
                 string id = $"T{count++}_NAME";
-                var typeNameWithAssembly = $"{method.EnclosingTypeName}, {assemblyName}";
+                var typeNameWithAssembly = $"{method.BindingTypeName}, {assemblyName}";
                 outputStream.WriteLine(
 $@"
 const {id}: &[u8] = b""{typeNameWithAssembly}\0"";");
-                map.Add(method.EnclosingTypeName, id);
+                map.Add(method.BindingTypeName, id);
             }
 
             // Emit exports
@@ -137,19 +137,38 @@ const {id}: &[u8] = b""{typeNameWithAssembly}\0"";");
                 {
                     var argName = SafeRustIdentifier(export.ArgumentNames[i] ?? $"arg{i}");
                     declsig.AppendFormat("{0}{1}: {2}", delim, argName, export.ArgumentTypes[i]);
-                    callsig.AppendFormat("{0}{1}", delim, argName);
-                    typesig.AppendFormat("{0}{1}", delim, export.ArgumentTypes[i]);
+                    if (export.ArgumentsByAddress[i])
+                    {
+                        // The managed function accepts the argument by address.
+                        callsig.AppendFormat("{0}core::ptr::addr_of!({1}) as *mut _", delim, argName);
+                        typesig.AppendFormat("{0}*mut {1}", delim, export.ArgumentTypes[i]);
+                    }
+                    else
+                    {
+                        callsig.AppendFormat("{0}{1}", delim, argName);
+                        typesig.AppendFormat("{0}{1}", delim, export.ArgumentTypes[i]);
+                    }
                     delim = ", ";
                 }
 
                 // Return type handling
                 bool isVoid = export.ReturnType == "c_void";
                 string returnAnnotation = isVoid ? "" : $" -> {export.ReturnType}";
-                string fnReturnAnnotation = isVoid ? "" : $" -> {export.ReturnType}";
+                string fnReturnAnnotation = isVoid || export.ReturnByAddress ? "" : $" -> {export.ReturnType}";
+                string callManagedFunction = $"f({callsig})";
+                if (export.ReturnByAddress)
+                {
+                    // The managed function writes the return value through the last argument.
+                    typesig.AppendFormat("{0}*mut {1}", delim, export.ReturnType);
+                    callManagedFunction =
+$@"let mut dnne_ret = core::mem::MaybeUninit::<{export.ReturnType}>::uninit();
+    f({callsig}{delim}dnne_ret.as_mut_ptr());
+    dnne_ret.assume_init()";
+                }
 
                 string callConv = s_typeProvider.MapCallConv(export.CallingConvention);
 
-                string classNameConstant = map[export.EnclosingTypeName];
+                string classNameConstant = map[export.BindingTypeName];
                 Debug.Assert(!string.IsNullOrEmpty(classNameConstant));
 
                 // Generate the acquire managed function based on the export type.
@@ -166,20 +185,49 @@ $@"        let method_name = b""{export.MethodName}\0"".as_ptr();
                 {
                     Debug.Assert(export.Type == ExportType.UnmanagedCallersOnly);
                     acquireManagedFunction =
-$@"        let method_name = b""{export.MethodName}\0"".as_ptr();
+$@"        let method_name = b""{export.BindingMethodName}\0"".as_ptr();
         let new_ptr = get_fast_callable_managed_function({classNameConstant}.as_ptr(), method_name);";
                 }
 
                 string ptrName = $"{export.ExportName}_ptr";
 
+                // A pure export returns a cached result, if there is one, before calling the
+                // managed function. The arguments form the key and each is converted to a u64.
+                string pureCache = string.Empty;
+                string pureLookup = string.Empty;
+                if (export.PureCacheSize != 0)
+                {
+                    string cacheName = $"{export.ExportName}_cache";
+                    int keyCount = Math.Max(1, export.ArgumentTypes.Length);
+                    string key = export.ArgumentTypes.Length == 0
+                        ? "0u64"
+                        : string.Join(", ", export.ArgumentTypes.Select((t, i) => ToCacheWord(SafeRustIdentifier(export.ArgumentNames[i] ?? $"arg{i}"), t)));
+                    int words = export.PureCacheSize * (3 + keyCount);
+                    pureCache =
+$@"
+{cfgLine}static {cacheName}: [core::sync::atomic::AtomicU64; {words}] = [crate::platform::PURE_CACHE_WORD; {words}];
+";
+                    pureLookup =
+$@"    let dnne_key = [{key}];
+    let dnne_epoch = match crate::platform::pure_cache_lookup(&{cacheName}, &dnne_key) {{
+        Ok(dnne_value) => return {FromCacheWord("dnne_value", export.ReturnType)},
+        Err(dnne_epoch) => dnne_epoch,
+    }};
+";
+                    callManagedFunction =
+$@"let dnne_ret = {callManagedFunction};
+    crate::platform::pure_cache_store(&{cacheName}, &dnne_key, {ToCacheWord("dnne_ret", export.ReturnType)}, dnne_epoch);
+    dnne_ret";
+                }
+
                 // Emit export
                 outputStream.WriteLine(
 $@"
 // Computed from {export.EnclosingTypeName}{Type.Delimiter}{export.MethodName}{export.XmlDoc}
 {cfgLine}static {ptrName}: AtomicPtr<c_void> = AtomicPtr::new(core::ptr::null_mut());
-
+{pureCache}
 {cfgLine}pub unsafe fn {export.ExportName}({declsig}){returnAnnotation} {{
-    let ptr = {ptrName}.load(Ordering::Acquire);
+{pureLookup}    let ptr = {ptrName}.load(Ordering::Acquire);
     let f: unsafe {callConv} fn({typesig}){fnReturnAnnotation} = if !ptr.is_null() {{
         core::mem::transmute(ptr)
     }} else {{
@@ -187,9 +235,98 @@ $@"
         {ptrName}.store(new_ptr, Ordering::Release);
         core::mem::transmute(new_ptr)
     }};
-    f({callsig})
+    {callManagedFunction}
 }}");
             }
+
+            // Emit exported data
+            if (data.Any())
+            {
+                outputStream.WriteLine(
+@"
+//
+// Exported data
+//");
+            }
+
+            foreach (var item in data)
+            {
+                string cfgGuard = GetPlatformCfg(item.Platforms);
+                string cfgLine = string.IsNullOrEmpty(cfgGuard) ? "" : $"{cfgGuard}\n";
+                if (item.Constant is not null)
+                {
+                    (string type, string value) = FormatConstant(item.Constant);
+                    outputStream.WriteLine(
+$@"
+// Computed from {item.EnclosingTypeName}{Type.Delimiter}{item.MemberName}{item.XmlDoc}
+{cfgLine}pub const {item.ExportName}: {type} = {value};");
+                    continue;
+                }
+
+                outputStream.WriteLine(
+$@"
+// Computed from {item.EnclosingTypeName}{Type.Delimiter}{item.MemberName}{item.XmlDoc}
+{cfgLine}pub static {item.ExportName}: [u8; {item.Data.Length}] = [");
+                item.WriteData(outputStream);
+                outputStream.WriteLine("];");
+            }
+        }
+
+        // Matches PureCachesGenerator.IsCacheableType and C99Emitter.s_pureCacheableTypes.
+        // Pointer-sized integers usually hold addresses, so they aren't cached.
+        private static readonly HashSet<string> s_pureCacheableTypes = new(StringComparer.Ordinal)
+        {
+            "i8", "u8", "i16", "u16", "i32", "u32", "i64", "u64", "f32", "f64",
+        };
+
+        // Results are cached by value, so values with identity such as pointers aren't allowed.
+        public static bool IsPureCacheable(ExportedMethod export)
+        {
+            return !export.ReturnByAddress
+                && !export.ArgumentsByAddress.Any(static b => b)
+                && s_pureCacheableTypes.Contains(export.ReturnType)
+                && export.ArgumentTypes.All(static t => s_pureCacheableTypes.Contains(t));
+        }
+
+        // Floating point values are cached by their bits, so -0.0 and 0.0 are distinct keys.
+        private static string ToCacheWord(string value, string type)
+        {
+            return type switch
+            {
+                "f32" => $"{value}.to_bits() as u64",
+                "f64" => $"{value}.to_bits()",
+                _ => $"{value} as u64",
+            };
+        }
+
+        private static string FromCacheWord(string word, string type)
+        {
+            return type switch
+            {
+                "f32" => $"f32::from_bits({word} as u32)",
+                "f64" => $"f64::from_bits({word})",
+                _ => $"{word} as {type}",
+            };
+        }
+
+        private static (string type, string value) FormatConstant(object constant)
+        {
+            return constant switch
+            {
+                bool b => ("bool", b ? "true" : "false"),
+                char c => ("u16", ((int)c).ToString(CultureInfo.InvariantCulture)),
+                sbyte v => ("i8", v.ToString(CultureInfo.InvariantCulture)),
+                byte v => ("u8", v.ToString(CultureInfo.InvariantCulture)),
+                short v => ("i16", v.ToString(CultureInfo.InvariantCulture)),
+                ushort v => ("u16", v.ToString(CultureInfo.InvariantCulture)),
+                int v => ("i32", v.ToString(CultureInfo.InvariantCulture)),
+                uint v => ("u32", v.ToString(CultureInfo.InvariantCulture)),
+                long v => ("i64", v.ToString(CultureInfo.InvariantCulture)),
+                ulong v => ("u64", v.ToString(CultureInfo.InvariantCulture)),
+                float v => ("f32", ExportedData.FormatFloatingPoint(v.ToString("R", CultureInfo.InvariantCulture))),
+                double v => ("f64", ExportedData.FormatFloatingPoint(v.ToString("R", CultureInfo.InvariantCulture))),
+                _ => throw new NotSupportedException($"Unknown constant type: {constant.GetType()}"),
+            };
         }
 
         private static string GetPlatformCfg(in PlatformSupport platformSupport)
@@ -0,0 +1,86 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Xml;
+
+namespace DNNE
+{
+    /// <summary>
+    /// Emits an ILLink descriptor that preserves the exported methods when the assembly is trimmed.
+    /// </summary>
+    /// <remarks>
+    /// Exports are resolved by name at run time so the trimmer is unable to discover them.
+    /// See https://learn.microsoft.com/dotnet/core/deploying/trimming/trimming-options#descriptor-format
+    /// </remarks>
+    internal static class TrimmerDescriptorEmitter
+    {
+        public static void Emit(TextWriter outputStream, string assemblyName, IEnumerable<ExportedMethod> exports, IEnumerable<string> helperTypes)
+        {
+            var settings = new XmlWriterSettings()
+            {
+                Indent = true,
+                OmitXmlDeclaration = true,
+            };
+
+            using var writer = XmlWriter.Create(outputStream, settings);
+            writer.WriteComment(" Auto-generated by dnne-gen ");
+            writer.WriteStartElement("linker");
+            writer.WriteStartElement("assembly");
+            writer.WriteAttributeString("fullname", assemblyName);
+
+            foreach (var type in exports.GroupBy(e => e.BindingTypeName))
+            {
+                // Nested types are delimited with '/' in descriptors.
+                string typeName = type.Key.Replace('+', '/');
+
+                writer.WriteStartElement("type");
+                writer.WriteAttributeString("fullname", typeName);
+                foreach (var export in type)
+                {
+                    writer.WriteStartElement("method");
+                    writer.WriteAttributeString("name", export.BindingMethodName);
+                    writer.WriteEndElement();
+                }
+                writer.WriteEndElement();
+
+                // Exports that aren't UnmanagedCallersOnly are bound through a delegate type.
+                foreach (var export in type.Where(e => e.Type == ExportType.Export))
+                {
+                    writer.WriteStartElement("type");
+                    writer.WriteAttributeString("fullname", $"{typeName}/{export.MethodName}Delegate");
+                    writer.WriteEndElement();
+                }
+            }
+
+            // Helpers called by the platform layer are preserved in their entirety.
+            foreach (var helperType in helperTypes)
+            {
+                writer.WriteStartElement("type");
+                writer.WriteAttributeString("fullname", helperType);
+                writer.WriteEndElement();
+            }
+
+            writer.WriteEndElement();
+            writer.WriteEndElement();
+        }
+    }
+}
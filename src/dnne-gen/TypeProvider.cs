@@ -18,7 +18,9 @@
 // SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 using System;
+using System.Collections.Generic;
 using System.Collections.Immutable;
+using System.Diagnostics;
 using System.Reflection.Metadata;
 using System.Text;
 
@@ -34,8 +36,19 @@ namespace DNNE
 
     internal abstract class TypeProviderBase : ISignatureTypeProvider<string, UnusedGenericContext>
     {
+        // Placeholders for the generic System.Runtime.Intrinsics vector types, replaced when instantiated.
+        private const string Vector128Placeholder = "/* Vector128 */";
+        private const string Vector256Placeholder = "/* Vector256 */";
+
+        private readonly IReadOnlyDictionary<TypeDefinitionHandle, string> handleTypes;
         private PrimitiveTypeCode? lastUnsupportedPrimitiveType;
 
+        /// <param name="handleTypes">Native names of the handle types defined in the assembly</param>
+        protected TypeProviderBase(IReadOnlyDictionary<TypeDefinitionHandle, string> handleTypes)
+        {
+            this.handleTypes = handleTypes;
+        }
+
         public string GetArrayType(string elementType, ArrayShape shape)
         {
             throw new NotSupportedTypeException(elementType);
@@ -70,7 +83,16 @@ namespace DNNE
 
         public string GetGenericInstantiation(string genericType, ImmutableArray<string> typeArguments)
         {
-            throw new NotSupportedTypeException($"Generic - {genericType}");
+            int bits = genericType switch
+            {
+                Vector128Placeholder => 128,
+                Vector256Placeholder => 256,
+                _ => throw new NotSupportedTypeException($"Generic - {genericType}"),
+            };
+
+            Debug.Assert(typeArguments.Length == 1);
+            return MapVectorType(bits, typeArguments[0])
+                ?? throw new NotSupportedTypeException($"Vector{bits} - {typeArguments[0]}");
         }
 
         public string GetGenericMethodParameter(UnusedGenericContext genericContext, int index)
@@ -127,11 +149,29 @@ namespace DNNE
 
         public string GetTypeFromDefinition(MetadataReader reader, TypeDefinitionHandle handle, byte rawTypeKind)
         {
+            if (this.handleTypes != null && this.handleTypes.TryGetValue(handle, out string handleType))
+            {
+                return handleType;
+            }
+
             return SupportNonPrimitiveTypes(rawTypeKind);
         }
 
         public string GetTypeFromReference(MetadataReader reader, TypeReferenceHandle handle, byte rawTypeKind)
         {
+            TypeReference typeRef = reader.GetTypeReference(handle);
+            if (reader.StringComparer.Equals(typeRef.Namespace, "System.Runtime.Intrinsics"))
+            {
+                if (reader.StringComparer.Equals(typeRef.Name, "Vector128`1"))
+                {
+                    return Vector128Placeholder;
+                }
+                else if (reader.StringComparer.Equals(typeRef.Name, "Vector256`1"))
+                {
+                    return Vector256Placeholder;
+                }
+            }
+
             return SupportNonPrimitiveTypes(rawTypeKind);
         }
 
@@ -145,8 +185,34 @@ namespace DNNE
         protected abstract string FormatPointerType(string elementType);
         protected abstract string FormatFunctionPointerComment(string returnType, string callConv, string args);
 
+        /// <summary>
+        /// Map a SIMD vector to the native vector type.
+        /// </summary>
+        /// <param name="bits">Size of the vector in bits</param>
+        /// <param name="elementType">Native element type</param>
+        /// <returns>The native vector type or null if the element type isn't supported.</returns>
+        protected abstract string MapVectorType(int bits, string elementType);
+
         internal abstract string MapCallConv(SignatureCallingConvention callConv);
 
+        /// <summary>
+        /// Declare the native type of a handle generated for <c>DNNE.HandleAttribute</c>.
+        /// </summary>
+        /// <remarks>
+        /// The managed handle is a struct with a single 64-bit field, so the native type has the same layout.
+        /// </remarks>
+        internal abstract string GetHandleTypeDeclaration(string name);
+
+        /// <summary>
+        /// Get the type a native pointer type points at.
+        /// </summary>
+        internal abstract string GetPointeeType(string pointerType);
+
+        /// <summary>
+        /// Determine if the native type is a SIMD vector type.
+        /// </summary>
+        internal abstract bool IsVectorType(string type);
+
         private static string SupportNonPrimitiveTypes(byte rawTypeKind)
         {
             // See https://docs.microsoft.com/dotnet/framework/unmanaged-api/metadata/corelementtype-enumeration
@@ -162,10 +228,39 @@ namespace DNNE
 
     internal class C99TypeProvider : TypeProviderBase
     {
+        public C99TypeProvider(IReadOnlyDictionary<TypeDefinitionHandle, string> handleTypes = null)
+            : base(handleTypes)
+        {
+        }
+
+        internal override string GetHandleTypeDeclaration(string name)
+        {
+            // A distinct struct type per handle so handles of different types can't be mixed up.
+            return $"typedef struct {name} {{ uint64_t opaque; }} {name};";
+        }
+
         protected override string GetCharTypeName() => "DNNE_WCHAR";
 
         protected override string FormatPointerType(string elementType) => elementType + "*";
 
+        internal override string GetPointeeType(string pointerType) => pointerType.Substring(0, pointerType.Length - 1);
+
+        internal override bool IsVectorType(string type) => type.StartsWith("dnne_m128") || type.StartsWith("dnne_m256");
+
+        protected override string MapVectorType(int bits, string elementType)
+        {
+            // See the SIMD vector types in dnne.h.
+            string suffix = elementType switch
+            {
+                "float" => string.Empty,
+                "double" => "d",
+                "int8_t" or "uint8_t" or "int16_t" or "uint16_t" or "int32_t" or "uint32_t" or "int64_t" or "uint64_t" => "i",
+                _ => null,
+            };
+
+            return suffix is null ? null : $"dnne_m{bits}{suffix}";
+        }
+
         protected override string FormatFunctionPointerComment(string returnType, string callConv, string args)
         {
             return $"/* {returnType}({callConv} *)({args}) */ ";
@@ -208,10 +303,53 @@ namespace DNNE
 
     internal class RustTypeProvider : TypeProviderBase
     {
+        public RustTypeProvider(IReadOnlyDictionary<TypeDefinitionHandle, string> handleTypes = null)
+            : base(handleTypes)
+        {
+        }
+
+        internal override string GetHandleTypeDeclaration(string name)
+        {
+            // The field is private so the handle can only be obtained from an export.
+            return
+$@"#[repr(C)]
+#[allow(non_camel_case_types)]
+#[derive(Clone, Copy, Debug, PartialEq, Eq, Hash)]
+pub struct {name} {{
+    opaque: u64,
+}}
+
+impl {name} {{
+    pub const NULL: {name} = {name} {{ opaque: 0 }};
+
+    pub fn is_null(&self) -> bool {{
+        self.opaque == 0
+    }}
+}}";
+        }
+
         protected override string GetCharTypeName() => "u16";
 
         protected override string FormatPointerType(string elementType) => "*mut " + elementType;
 
+        internal override string GetPointeeType(string pointerType) => pointerType.Substring("*mut ".Length);
+
+        internal override bool IsVectorType(string type) => type.StartsWith("crate::platform::M128") || type.StartsWith("crate::platform::M256");
+
+        protected override string MapVectorType(int bits, string elementType)
+        {
+            // See the SIMD vector types in platform.rs.
+            string suffix = elementType switch
+            {
+                "f32" => string.Empty,
+                "f64" => "d",
+                "i8" or "u8" or "i16" or "u16" or "i32" or "u32" or "i64" or "u64" => "i",
+                _ => null,
+            };
+
+            return suffix is null ? null : $"crate::platform::M{bits}{suffix}";
+        }
+
         protected override string FormatFunctionPointerComment(string returnType, string callConv, string args)
         {
             var retType = returnType == "c_void" ? "()" : returnType;
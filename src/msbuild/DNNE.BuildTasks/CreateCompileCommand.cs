@@ -84,6 +84,24 @@ namespace DNNE.BuildTasks
         // Optional
         public bool IsSelfContained { get; set; } = false;
 
+        // Optional
+        public bool EnableUsdtProbes { get; set; } = false;
+
+        // Optional
+        public bool EnableTracing { get; set; } = false;
+
+        // Optional
+        public bool EagerBinding { get; set; } = false;
+
+        // Optional
+        public bool LinkNetHost { get; set; } = true;
+
+        // Optional
+        public string EmbeddedSource { get; set; }
+
+        // Optional
+        public bool OutOfProcess { get; set; } = false;
+
         // Optional
         public string AssemblyVersion { get; set; }
 
@@ -128,6 +146,10 @@ namespace DNNE.BuildTasks
         [Output]
         public string CommandArguments { get; set; }
 
+        // Arguments to build the host executable for out-of-process dispatch, otherwise empty.
+        [Output]
+        public string RemoteHostCommandArguments { get; set; }
+
         public override bool Execute()
         {
             Log.LogMessage(DevImportance,
@@ -138,6 +160,7 @@ DNNE Native Compilation:
     PlatformPath:   {PlatformPath}
     Source:         {Source}
     ExportsDefFile: {ExportsDefFile}
+    EmbeddedSource: {EmbeddedSource}
     OutputName:     {OutputName}
     OutputPath:     {OutputPath}
 
@@ -157,11 +180,46 @@ Native Build:
                     throw new NotSupportedException("Rust language is not supported when targeting .NET Framework. Use a .NET (Core) target framework instead.");
                 }
 
+                if (IsSelfContained)
+                {
+                    Log.LogWarning("Self-contained runtime activation is not supported for Rust output. The generated crate will use framework-dependent activation.");
+                }
+
+                if (!string.IsNullOrEmpty(EmbeddedSource))
+                {
+                    Log.LogWarning("Embedding the assembly is not supported for Rust output. The generated crate will load the assembly next to the native binary.");
+                }
+
+                if (OutOfProcess)
+                {
+                    Log.LogWarning("Out-of-process dispatch is not supported for Rust output. The generated crate will run exports in the calling process.");
+                }
+
+                if (EnableTracing)
+                {
+                    Log.LogWarning("Timeline tracing is not supported for Rust output. The generated crate will not record export calls.");
+                }
+
                 // Rust: generate a Cargo crate instead of compiling.
                 Rust.GenerateCrate(this);
             }
             else if (Language.Equals("c99", StringComparison.OrdinalIgnoreCase))
             {
+                if (!string.IsNullOrEmpty(EmbeddedSource) && (IsTargetingNetFramework || IsSelfContained))
+                {
+                    throw new NotSupportedException("Embedding the assembly is not supported when targeting .NET Framework or with a self-contained runtime.");
+                }
+
+                if (OutOfProcess && !RuntimeInformation.IsOSPlatform(OSPlatform.Linux))
+                {
+                    throw new NotSupportedException("Out-of-process dispatch is only supported on Linux.");
+                }
+
+                if (EnableTracing && RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
+                {
+                    Log.LogWarning("Timeline tracing is not supported on Windows. The native binary will not record export calls.");
+                }
+
                 if (RuntimeInformation.IsOSPlatform(OSPlatform.Windows))
                 {
                     Windows.ConstructCommandLine(this, out command, out commandArguments);
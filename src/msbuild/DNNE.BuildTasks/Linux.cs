@@ -19,6 +19,8 @@
 
 using Microsoft.Build.Framework;
 
+using System.IO;
+
 namespace DNNE.BuildTasks
 {
     public class Linux
@@ -27,6 +29,13 @@ namespace DNNE.BuildTasks
         {
             export.Report(MessageImportance.Low, $"Building for Linux");
             macOS.ConstructClangCommandLine(export, out command, out commandArguments);
+
+            // The server for out-of-process dispatch is started with a host executable
+            // deployed next to the native binary, see dnne_remote_host.c.
+            if (export.OutOfProcess)
+            {
+                export.RemoteHostCommandArguments = $"-O2 -o \"{Path.Combine(export.OutputPath, "dnne-remote-host")}\" \"{Path.Combine(export.PlatformPath, "dnne_remote_host.c")}\" -ldl";
+            }
         }
     }
 }
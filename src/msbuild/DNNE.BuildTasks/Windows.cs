@@ -96,8 +96,12 @@ namespace DNNE.BuildTasks
             else
             {
                 compileAsFlag = "/TC";
-                hostLib = $"\"{Path.Combine(export.NetHostPath, "libnethost.lib")}\"";
                 platformTU = Path.Combine(export.PlatformPath, "platform.c");
+
+                // The self-contained runtime is located without nethost.
+                hostLib = export.IsSelfContained
+                    ? string.Empty
+                    : $"\"{Path.Combine(export.NetHostPath, "libnethost.lib")}\"";
             }
 
             // Create arguments
@@ -134,6 +138,14 @@ namespace DNNE.BuildTasks
                 compilerFlags.Append($"/D DNNE_TARGET_NET_FRAMEWORK ");
             }
 
+            // The assembly is loaded from the embedded source, see init_dotnet().
+            string embeddedSource = string.Empty;
+            if (!string.IsNullOrEmpty(export.EmbeddedSource))
+            {
+                compilerFlags.Append($"/D DNNE_EMBED_ASSEMBLY ");
+                embeddedSource = $"\"{export.EmbeddedSource}\"";
+            }
+
             compilerFlags.Append($"/I \"{vcIncDir}\" /I \"{export.PlatformPath}\" /I \"{export.NetHostPath}\" ");
 
             foreach (var incPath in vcvarsallIncludePaths)
@@ -182,7 +194,7 @@ namespace DNNE.BuildTasks
             }
 
             command = compilerPath;
-            commandArguments = $"{compilerFlags} \"{export.Source}\" \"{platformTU}\" /link {linkerFlags}";
+            commandArguments = $"{compilerFlags} \"{export.Source}\" \"{platformTU}\" {embeddedSource} /link {linkerFlags}";
         }
 
         private static string GetVcvarsallInfo(string vcArch, string findVcvarsallPath)
@@ -37,6 +37,10 @@ namespace DNNE.BuildTasks
         {
             bool isDebug = IsDebug(export.Configuration);
 
+            // The self-contained runtime is located without nethost and
+            // hostfxr can otherwise be searched for by the platform layer.
+            bool linkNetHost = !export.IsSelfContained && export.LinkNetHost;
+
             // Create arguments
             var compilerFlags = new StringBuilder();
             SetConfigurationBasedFlags(isDebug, ref compilerFlags);
@@ -50,7 +54,48 @@ namespace DNNE.BuildTasks
                 compilerFlags.Append($"-D DNNE_SELF_CONTAINED_RUNTIME ");
             }
 
-            compilerFlags.Append($"-I \"{export.PlatformPath}\" -I \"{export.NetHostPath}\" ");
+            // Probes are only emitted for ELF targets, see dnne_sdt.h.
+            if (export.EnableUsdtProbes)
+            {
+                compilerFlags.Append($"-D DNNE_USDT_PROBES ");
+            }
+
+            // Export calls are recorded for dnne_trace_dump(), see platform.c.
+            if (export.EnableTracing)
+            {
+                compilerFlags.Append($"-D DNNE_TRACING ");
+            }
+
+            // Search for hostfxr in the platform layer, see find_hostfxr().
+            if (!export.IsSelfContained && !export.LinkNetHost)
+            {
+                compilerFlags.Append($"-D DNNE_NO_NETHOST ");
+            }
+
+            // Eager binding requires GNU indirect functions, see the generated source.
+            if (export.EagerBinding)
+            {
+                compilerFlags.Append($"-D DNNE_EAGER_BINDING ");
+            }
+
+            // The assembly is loaded from the embedded source, see init_dotnet().
+            if (!string.IsNullOrEmpty(export.EmbeddedSource))
+            {
+                compilerFlags.Append($"-D DNNE_EMBED_ASSEMBLY ");
+            }
+
+            // Exports are dispatched to a shared server process, see dnne_remote_call().
+            if (export.OutOfProcess)
+            {
+                compilerFlags.Append($"-D DNNE_OUT_OF_PROCESS -pthread ");
+            }
+
+            compilerFlags.Append($"-I \"{export.PlatformPath}\" ");
+
+            if (linkNetHost)
+            {
+                compilerFlags.Append($"-I \"{export.NetHostPath}\" ");
+            }
 
             // Add user defined inc paths last - these will be searched last on clang.
             // https://clang.llvm.org/docs/ClangCommandLineReference.html#include-path-management
@@ -67,8 +112,16 @@ namespace DNNE.BuildTasks
             }
 
             compilerFlags.Append($"\"{export.Source}\" \"{Path.Combine(export.PlatformPath, "platform.c")}\" ");
-            compilerFlags.Append($"-lstdc++ ");
-            compilerFlags.Append($"\"{Path.Combine(export.NetHostPath, "libnethost.a")}\" ");
+            if (!string.IsNullOrEmpty(export.EmbeddedSource))
+            {
+                compilerFlags.Append($"\"{export.EmbeddedSource}\" ");
+            }
+
+            if (linkNetHost)
+            {
+                compilerFlags.Append($"-lstdc++ ");
+                compilerFlags.Append($"\"{Path.Combine(export.NetHostPath, "libnethost.a")}\" ");
+            }
 
             if (!string.IsNullOrEmpty(export.UserDefinedLinkerFlags))
             {
@@ -20,6 +20,9 @@
 #ifndef __SRC_PLATFORM_DNNE_H__
 #define __SRC_PLATFORM_DNNE_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
 // Define our platform
 #ifdef _WIN32
     #define DNNE_WINDOWS
@@ -71,13 +74,223 @@
 //
 #define DNNE_SUCCESS 0
 
+// Failure code (E_OUTOFMEMORY) returned when memory could not be allocated.
+#define DNNE_E_OUTOFMEMORY ((int)0x8007000E)
+
+// Failure code (E_NOTIMPL) returned when a feature isn't enabled in the native binary
+// or isn't supported on the current platform.
+#define DNNE_E_NOTIMPL ((int)0x80004001)
+
 enum failure_type
 {
     failure_load_runtime = 1,
     failure_load_export,
+
+    // An export marked with DNNE.RemoteExportAttribute threw an exception in the shared
+    // server process. The error code is the HRESULT of the exception.
+    failure_remote_export,
 };
 typedef void (DNNE_CALLTYPE* failure_fn)(enum failure_type type, int error_code);
 
+// Opaque arena used to return variable-sized results from exports.
+typedef struct dnne_arena dnne_arena;
+
+// Opaque buffer of recorded export calls, see DNNE.CommandExportAttribute.
+typedef struct dnne_command_buffer dnne_command_buffer;
+
+// Number of GC generations reported by dnne_get_runtime_metrics().
+// Generations 0, 1 and 2, followed by the large and pinned object heaps.
+#define DNNE_GC_GENERATION_COUNT 5
+
+// Snapshot of managed runtime metrics. See dnne_get_runtime_metrics().
+// Values that aren't available on the target framework are reported as 0.
+struct dnne_runtime_metrics
+{
+    // Size of the structure in bytes. Must be set by the caller,
+    // fields beyond the supplied size are not written.
+    uint32_t size;
+
+    // Keeps the following fields at the same offsets on every ABI, including those
+    // that only align 64-bit integers to 4 bytes (for example, 32-bit x86 System V).
+    uint32_t reserved;
+
+    // GC heap size in bytes, in total and per generation, as of the last collection.
+    uint64_t gc_heap_size_bytes;
+    uint64_t gc_generation_size_bytes[DNNE_GC_GENERATION_COUNT];
+
+    // Bytes allocated over the lifetime of the process.
+    uint64_t gc_total_allocated_bytes;
+
+    // Number of collections of generations 0, 1 and 2.
+    uint64_t gc_collection_count[3];
+
+    // Total time the runtime was paused for collections.
+    uint64_t gc_total_pause_duration_ns;
+
+    // Methods compiled by the JIT, their IL size and the time spent compiling.
+    uint64_t jit_compiled_method_count;
+    uint64_t jit_compiled_il_bytes;
+    uint64_t jit_compilation_time_ns;
+
+    // Thread pool threads, queued work items and completed work items.
+    uint64_t thread_pool_thread_count;
+    uint64_t thread_pool_pending_work_item_count;
+    uint64_t thread_pool_completed_work_item_count;
+};
+
+enum dnne_gc_event_type
+{
+    dnne_gc_event_start = 1,
+    dnne_gc_event_end,
+
+    // A full blocking collection is approaching, sent before it starts.
+    dnne_gc_event_approach,
+};
+
+enum dnne_gc_kind
+{
+    dnne_gc_kind_blocking = 0,
+    dnne_gc_kind_background,
+    dnne_gc_kind_foreground,
+};
+
+// GC notification. See dnne_register_gc_callback().
+struct dnne_gc_event
+{
+    // Size of the structure in bytes.
+    uint32_t size;
+
+    // Value of enum dnne_gc_event_type.
+    int32_t type;
+
+    // Generation being collected and the runtime's reason for the collection.
+    int32_t generation;
+    int32_t reason;
+
+    // Value of enum dnne_gc_kind. Only blocking and foreground collections pause managed code
+    // for their entire duration, background collections pause it briefly.
+    int32_t kind;
+
+    // Index of the collection, matches the start and end of a collection. For an approach,
+    // the index of the last collection, the approaching collection has a greater index.
+    uint64_t index;
+
+    // Time managed code was paused for the collection. Only set when the collection ends.
+    uint64_t pause_duration_ns;
+};
+typedef void (DNNE_CALLTYPE* dnne_gc_callback)(const struct dnne_gc_event* evt, void* user);
+
+// Entry in the table of exports. See dnne_enumerate_exports().
+struct dnne_export
+{
+    const char* name;
+
+    // Address of the export, or NULL if it isn't defined for the current platform.
+    void* address;
+
+    // 64-bit FNV-1a hash of the export's C signature with whitespace collapsed,
+    // for example "int32_t(int32_t,int32_t)". The generated header defines the
+    // same value as DNNE_SIGNATURE_HASH_<export>.
+    uint64_t signature_hash;
+};
+
+// Completion of an asynchronous export, see DNNE.AsyncExportAttribute.
+// The caller owns the structure and initializes it with dnne_completion_init() or
+// dnne_completion_init_event() before passing it to the {export}_begin function.
+// It must remain valid until the result is collected with the {export}_end function,
+// which must only be called once the completion has been signaled.
+// The {export}_begin function returns a failure code, and the completion is never
+// signaled, if the completion isn't initialized (the method isn't called) or if the
+// method returns a null task.
+struct dnne_completion;
+typedef void (DNNE_CALLTYPE* dnne_completion_callback)(struct dnne_completion* completion, void* user);
+struct dnne_completion
+{
+    // Must remain the first field. The managed export signals completion by calling through it.
+    void (DNNE_CALLTYPE_CDECL* signal)(struct dnne_completion* completion);
+    dnne_completion_callback callback;
+    void* user;
+    intptr_t event;
+
+    // Managed operation in progress, released when the result is collected.
+    void* state;
+};
+
+// SIMD vector types used for Vector128<T> and Vector256<T> in export signatures.
+// The definitions depend only on the target architecture and on macros fixed when
+// the native binary is built, never on the instruction set the including code is
+// compiled for, so the native binary and its consumers always agree on how vectors
+// are passed.
+//
+// 128-bit vectors use the baseline vector registers of x64 and Arm64 and are passed
+// in registers under the platform calling convention. On other architectures a
+// portable definition with the same size and alignment is used and vectors are
+// passed in memory.
+//
+// 256-bit vectors use the portable definition unless DNNE_VECTOR256_AVX is defined.
+// The generated header defines it when the native binary is built with
+// DnneVector256Abi set to 'avx', in which case every consumer must also be compiled
+// with AVX enabled.
+#ifdef _MSC_VER
+    #define DNNE_ALIGN(n) __declspec(align(n))
+#else
+    #define DNNE_ALIGN(n) __attribute__((aligned(n)))
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+    #define DNNE_NATIVE_M128
+    #if defined(__GNUC__) || defined(__clang__)
+        // Same definitions as the compiler's __m128 types, without requiring the intrinsic headers.
+        typedef float dnne_m128 __attribute__((__vector_size__(16), __may_alias__));
+        typedef double dnne_m128d __attribute__((__vector_size__(16), __may_alias__));
+        typedef long long dnne_m128i __attribute__((__vector_size__(16), __may_alias__));
+    #elif defined(_M_X64)
+        #include <emmintrin.h>
+        typedef __m128 dnne_m128;
+        typedef __m128d dnne_m128d;
+        typedef __m128i dnne_m128i;
+    #else
+        #include <arm_neon.h>
+        typedef float32x4_t dnne_m128;
+        typedef float64x2_t dnne_m128d;
+        typedef int32x4_t dnne_m128i;
+    #endif
+#else
+    typedef struct DNNE_ALIGN(16) dnne_m128 { float f32[4]; } dnne_m128;
+    typedef struct DNNE_ALIGN(16) dnne_m128d { double f64[2]; } dnne_m128d;
+    typedef struct DNNE_ALIGN(16) dnne_m128i { long long i64[2]; } dnne_m128i;
+#endif
+
+#ifdef DNNE_VECTOR256_AVX
+    #if !defined(__x86_64__) && !defined(_M_X64)
+        #error DNNE_VECTOR256_AVX is only supported on x64.
+    #elif !defined(__AVX__)
+        #error The native binary passes 256-bit vectors in AVX registers. Compile with AVX enabled (for example, -mavx or /arch:AVX).
+    #endif
+    #define DNNE_NATIVE_M256
+    #if defined(__GNUC__) || defined(__clang__)
+        typedef float dnne_m256 __attribute__((__vector_size__(32), __may_alias__));
+        typedef double dnne_m256d __attribute__((__vector_size__(32), __may_alias__));
+        typedef long long dnne_m256i __attribute__((__vector_size__(32), __may_alias__));
+    #else
+        #include <immintrin.h>
+        typedef __m256 dnne_m256;
+        typedef __m256d dnne_m256d;
+        typedef __m256i dnne_m256i;
+    #endif
+#else
+    typedef struct DNNE_ALIGN(32) dnne_m256 { float f32[8]; } dnne_m256;
+    typedef struct DNNE_ALIGN(32) dnne_m256d { double f64[4]; } dnne_m256d;
+    typedef struct DNNE_ALIGN(32) dnne_m256i { long long i64[4]; } dnne_m256i;
+#endif
+
+// Declares exported data without defining it.
+#ifdef __cplusplus
+    #define DNNE_EXTERN_DATA extern "C"
+#else
+    #define DNNE_EXTERN_DATA extern
+#endif
+
 #ifdef __cplusplus
     #define DNNE_EXTERN_C extern "C"
     DNNE_EXTERN_C
@@ -95,6 +308,8 @@ DNNE_API void DNNE_CALLTYPE set_failure_callback(failure_fn cb);
 // The runtime is lazily loaded whenever the first export is called. This function
 // preloads the runtime independent of calling any export and avoids the startup
 // cost associated with calling an export for the first time.
+// When the native binary is built with DNNE_EAGER_BINDING, every export is also
+// bound so callers that resolve an export afterwards call it directly.
 // If the runtime fails to load, dnne_abort() will be called.
 DNNE_API void DNNE_CALLTYPE preload_runtime(void);
 
@@ -105,6 +320,151 @@ DNNE_API void DNNE_CALLTYPE preload_runtime(void);
 // If the runtime fails to load, an error code will be returned.
 DNNE_API int DNNE_CALLTYPE try_preload_runtime(void);
 
+// Run the server for out-of-process dispatch.
+// Only defined when the native binary is built with DNNE_OUT_OF_PROCESS. Called by the
+// dnne-remote-host executable, which is started by the first client. Serves calls to
+// exports marked with DNNE.RemoteExportAttribute until the process exits and only
+// returns if the server fails to start.
+DNNE_API int DNNE_CALLTYPE dnne_remote_server_main(void);
+
+// Create an arena for returning variable-sized results from exports.
+// Memory is handed out from chunks of at least chunk_size bytes. A chunk_size
+// of 0 selects the default. Returns NULL if the arena could not be allocated.
+DNNE_API dnne_arena* DNNE_CALLTYPE dnne_arena_create(size_t chunk_size);
+
+// Allocate size bytes from the arena with the supplied alignment.
+// The alignment must be a power of two; 0 selects pointer alignment.
+// Each thread allocates from its own chunk so this function can be called
+// concurrently. Returns NULL if memory could not be allocated.
+DNNE_API void* DNNE_CALLTYPE dnne_arena_alloc(dnne_arena* arena, size_t size, size_t align);
+
+// Release all allocations made from the arena in a single operation.
+// Chunks are retained for reuse. Must not be called concurrently with
+// any other use of the arena.
+DNNE_API void DNNE_CALLTYPE dnne_arena_reset(dnne_arena* arena);
+
+// Release the arena and all of its memory.
+// Must not be called concurrently with any other use of the arena.
+DNNE_API void DNNE_CALLTYPE dnne_arena_destroy(dnne_arena* arena);
+
+// Create a buffer for recording calls to exports marked with DNNE.CommandExportAttribute.
+// Calls are recorded with the generated {export}_record functions. The buffer initially has
+// room for capacity 8 byte slots and grows as needed, a capacity of 0 selects the default.
+// The {export}_record functions return DNNE_SUCCESS, or DNNE_E_OUTOFMEMORY if the buffer
+// could not grow, in which case the call isn't recorded.
+// Returns NULL if the buffer could not be allocated.
+DNNE_API dnne_command_buffer* DNNE_CALLTYPE dnne_command_buffer_create(size_t capacity);
+
+// Remove all recorded calls from the buffer. The memory is retained for reuse.
+DNNE_API void DNNE_CALLTYPE dnne_command_buffer_reset(dnne_command_buffer* buffer);
+
+// Release the buffer and all of its memory.
+DNNE_API void DNNE_CALLTYPE dnne_command_buffer_destroy(dnne_command_buffer* buffer);
+
+// Make the recorded calls in order with a single transition into the runtime.
+// Return values are written to the result pointers supplied when the calls were recorded.
+// The buffer isn't reset, so the same calls can be submitted again. A buffer must not be
+// recorded into or submitted concurrently with any other use of it.
+// Returns DNNE_SUCCESS, or a failure code if the runtime could not be loaded or a call
+// threw an exception. Calls after the one that threw aren't made.
+DNNE_API int DNNE_CALLTYPE dnne_submit(dnne_command_buffer* buffer);
+
+// Name the exports in the perf map the runtime writes when DOTNET_PerfMapEnabled is 1 or 3.
+// For each entry the runtime has written for the code of a resolved export, an entry with
+// the same address and size is appended with the export name before the runtime's symbol.
+// If path is NULL, the runtime's '/tmp/perf-<pid>.map' is used, or the directory in
+// DOTNET_PerfMapJitDumpPath. Each entry is written with a single write under an advisory
+// lock. Calling again adds entries only for code written by the runtime since the last call.
+// Returns DNNE_SUCCESS, DNNE_E_NOTIMPL if the runtime perf map is not enabled or not
+// supported on the current platform, or another failure code if the file could not be written.
+DNNE_API int DNNE_CALLTYPE dnne_write_perf_map(const char* path);
+
+// Write the timeline of export calls and runtime activation as a Chrome trace.
+// Only available when the native binary is built with DNNE_TRACING. The most recent
+// records of each thread are written as JSON that can be opened in Perfetto or
+// chrome://tracing. If path is NULL, the default '/tmp/dnne-trace-<pid>.json' is used.
+// The ring of a thread that has exited is reused by the next thread that makes a call.
+// Returns DNNE_SUCCESS, DNNE_E_NOTIMPL if tracing is not enabled or not supported on the
+// current platform, or another failure code if the file could not be written.
+DNNE_API int DNNE_CALLTYPE dnne_trace_dump(const char* path);
+
+// Get a snapshot of managed runtime metrics.
+// The size field of metrics must be set by the caller. The runtime isn't loaded
+// by this function, so the metrics are only available after an export has been
+// called or the runtime has been preloaded. The snapshot is cheap enough to take
+// periodically (for example, every second).
+// Returns DNNE_SUCCESS, or a failure code if the runtime isn't loaded or the
+// metrics are not supported on the current platform.
+DNNE_API int DNNE_CALLTYPE dnne_get_runtime_metrics(struct dnne_runtime_metrics* metrics);
+
+// Register a callback for the start and end of each managed GC, and the approach of a
+// full blocking GC.
+// The runtime is loaded if it hasn't been already. Only a single callback is registered,
+// registering a callback replaces the previous one and a NULL callback unregisters it.
+// Once registering returns, the previous callback isn't running on another thread and
+// won't be called again.
+// The start and end are post-hoc: they are delivered asynchronously on a runtime thread,
+// typically within tens of milliseconds of the event, so the start of a collection is
+// usually reported after the collection has completed.
+// The approach is announced by the GC when the allocations in generation 2 or the large
+// object heap near the point that triggers a full blocking collection, and is delivered
+// before the collection starts, on a dedicated thread. Induced collections aren't announced,
+// and neither are background collections, so the approach is only sent when concurrent GC
+// is disabled (System.GC.Concurrent set to false). The callback should return quickly.
+// Returns DNNE_SUCCESS, or a failure code if the runtime could not be loaded or
+// notifications are not supported on the current platform.
+DNNE_API int DNNE_CALLTYPE dnne_register_gc_callback(dnne_gc_callback cb, void* user);
+
+// Prepare the calling thread to call exports.
+// The first export called on a thread attaches the thread to the runtime and creates
+// its managed state, which can take tens of microseconds. Call this function when a
+// thread is created, for example by a thread pool, so the first export it calls
+// doesn't pay that cost. The runtime is loaded if it hasn't been already.
+// Returns DNNE_SUCCESS, or a failure code if the runtime could not be loaded or
+// thread preparation is not supported on the current platform.
+DNNE_API int DNNE_CALLTYPE dnne_prepare_current_thread(void);
+
+// Release the state created by dnne_prepare_current_thread() that can be released early.
+// Call this function before a prepared thread exits. The runtime doesn't support detaching
+// a thread, it releases the thread's managed state when the thread exits.
+// Returns DNNE_SUCCESS, or a failure code if thread preparation is not supported on
+// the current platform.
+DNNE_API int DNNE_CALLTYPE dnne_release_current_thread(void);
+
+// Invalidate the results cached by exports marked with DNNE.PureAttribute.
+// Calls that begin afterwards don't return an earlier result. Managed code can
+// instead call the generated DNNE.PureCaches.Invalidate() method.
+DNNE_API void DNNE_CALLTYPE dnne_invalidate_pure_caches(void);
+
+// Find an export by name.
+// The lookup uses a perfect hash table generated at build time, so it doesn't allocate
+// and takes constant time. If signature_hash isn't NULL, it is set to the signature
+// hash of the export. See struct dnne_export.
+// When exports are bound eagerly, an export bound by preload_runtime() is returned as
+// the managed function, matching the address the dynamic linker resolves afterwards.
+// Returns the address of the export, or NULL if it doesn't exist.
+DNNE_API void* DNNE_CALLTYPE dnne_find_export(const char* name, uint64_t* signature_hash);
+
+// Get the table of exports.
+// If exports isn't NULL, it is set to the read-only table. The table is in hash order
+// and includes exports that aren't defined for the current platform. The addresses are
+// fixed when the binary is loaded, so when exports are bound eagerly they are the stubs
+// that call the bound managed functions; use dnne_find_export() for the bound address.
+// Returns the number of entries in the table.
+DNNE_API size_t DNNE_CALLTYPE dnne_enumerate_exports(const struct dnne_export** exports);
+
+// Initialize a completion that calls cb when an asynchronous export completes.
+// The callback is called on the thread that completes the managed operation, or on the
+// calling thread before the {export}_begin function returns if it completes synchronously.
+// The {export}_end function can be called from the callback.
+DNNE_API void DNNE_CALLTYPE dnne_completion_init(struct dnne_completion* completion, dnne_completion_callback cb, void* user);
+
+// Initialize a completion that signals an event when an asynchronous export completes.
+// On Windows, event is an event HANDLE that is set. Otherwise, event is a file descriptor,
+// typically from eventfd(), that an 8-byte count of 1 is written to, so completions can
+// be waited on with epoll or similar alongside other I/O.
+DNNE_API void DNNE_CALLTYPE dnne_completion_init_event(struct dnne_completion* completion, intptr_t event);
+
 // Users can override DNNE's rude-abort behavior by providing their own dnne_abort() at link time.
 // It is expected this function will not return. If it does return, the behavior is undefined.
 extern DNNE_API void dnne_abort(enum failure_type type, int error_code);
@@ -0,0 +1,66 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Host for the server process used by out-of-process dispatch, see DNNE_OUT_OF_PROCESS.
+// Started by the first client with the path of the native binary. The server is
+// detached from the client so it outlives it and is never left as its zombie.
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef int (*dnne_remote_server_main_fn)(void);
+
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        fprintf(stderr, "Usage: %s <native binary>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        perror("fork");
+        return EXIT_FAILURE;
+    }
+
+    if (pid > 0)
+        return EXIT_SUCCESS;
+
+    void* h = dlopen(argv[1], RTLD_NOW | RTLD_LOCAL);
+    if (h == NULL)
+    {
+        fprintf(stderr, "Failed to load '%s': %s\n", argv[1], dlerror());
+        return EXIT_FAILURE;
+    }
+
+    dnne_remote_server_main_fn server_main = (dnne_remote_server_main_fn)dlsym(h, "dnne_remote_server_main");
+    if (server_main == NULL)
+    {
+        fprintf(stderr, "'%s' wasn't built with DNNE_OUT_OF_PROCESS: %s\n", argv[1], dlerror());
+        return EXIT_FAILURE;
+    }
+
+    int rc = server_main();
+    fprintf(stderr, "Out-of-process server failed to start: 0x%08x\n", rc);
+    return EXIT_FAILURE;
+}
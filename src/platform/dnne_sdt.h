@@ -0,0 +1,123 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Minimal USDT (SystemTap Statically Defined Tracing) probe support.
+//
+// The probes emit the same ELF notes as <sys/sdt.h> so they are discoverable by
+// perf, bpftrace, bcc, and SystemTap without requiring the systemtap-sdt-dev
+// package at build time. An inactive probe is a single nop instruction.
+//
+// Probes are only emitted when DNNE_USDT_PROBES is defined and the target is ELF.
+// In all other cases the probe macros expand to nothing and their arguments are
+// not evaluated.
+//
+// Arguments are passed as 'long' values, integral or pointer arguments only.
+
+#ifndef __SRC_PLATFORM_DNNE_SDT_H__
+#define __SRC_PLATFORM_DNNE_SDT_H__
+
+#if defined(DNNE_USDT_PROBES) && defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+
+#define DNNE_SDT_ENABLED 1
+
+#if defined(__LP64__) || defined(_LP64)
+    #define _DNNE_SDT_ASM_ADDR ".8byte"
+    #define _DNNE_SDT_ARG_SIZE "-8"
+#else
+    #define _DNNE_SDT_ASM_ADDR ".4byte"
+    #define _DNNE_SDT_ARG_SIZE "-4"
+#endif
+
+// Allow the compiler to place the argument in a register, in memory, or as an immediate.
+// ARM32 assemblers reject the offsettable memory constraint, fall back to a general operand.
+#if defined(__arm__)
+    #define _DNNE_SDT_ARG_CONSTRAINT "g"
+#else
+    #define _DNNE_SDT_ARG_CONSTRAINT "nor"
+#endif
+
+#define _DNNE_SDT_ARG(n) _DNNE_SDT_ARG_SIZE "@%" #n
+#define _DNNE_SDT_ARGFMT0 ""
+#define _DNNE_SDT_ARGFMT1 _DNNE_SDT_ARG(0)
+#define _DNNE_SDT_ARGFMT2 _DNNE_SDT_ARGFMT1 " " _DNNE_SDT_ARG(1)
+#define _DNNE_SDT_ARGFMT3 _DNNE_SDT_ARGFMT2 " " _DNNE_SDT_ARG(2)
+#define _DNNE_SDT_ARGFMT4 _DNNE_SDT_ARGFMT3 " " _DNNE_SDT_ARG(3)
+#define _DNNE_SDT_ARGFMT5 _DNNE_SDT_ARGFMT4 " " _DNNE_SDT_ARG(4)
+#define _DNNE_SDT_ARGFMT6 _DNNE_SDT_ARGFMT5 " " _DNNE_SDT_ARG(5)
+
+#define _DNNE_SDT_IN(a) _DNNE_SDT_ARG_CONSTRAINT ((long)(a))
+
+// The note layout is defined by https://sourceware.org/systemtap/wiki/UserSpaceProbeImplementation
+// The semaphore address is always 0, the probes are always armed by patching the nop.
+#define _DNNE_SDT_PROBE(provider, name, argfmt, ...) \
+    __asm__ __volatile__ ( \
+        "990: nop\n" \
+        ".pushsection .note.stapsdt,\"\",\"note\"\n" \
+        ".balign 4\n" \
+        ".4byte 992f-991f, 994f-993f, 3\n" \
+        "991: .asciz \"stapsdt\"\n" \
+        "992: .balign 4\n" \
+        "993: " _DNNE_SDT_ASM_ADDR " 990b\n" \
+        _DNNE_SDT_ASM_ADDR " _.stapsdt.base\n" \
+        _DNNE_SDT_ASM_ADDR " 0\n" \
+        ".asciz \"" #provider "\"\n" \
+        ".asciz \"" #name "\"\n" \
+        ".asciz \"" argfmt "\"\n" \
+        "994: .balign 4\n" \
+        ".popsection\n" \
+        ".ifndef _.stapsdt.base\n" \
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n" \
+        ".weak _.stapsdt.base\n" \
+        ".hidden _.stapsdt.base\n" \
+        "_.stapsdt.base: .space 1\n" \
+        ".size _.stapsdt.base, 1\n" \
+        ".popsection\n" \
+        ".endif\n" \
+        : : __VA_ARGS__)
+
+#define DNNE_SDT_PROBE0(provider, name) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT0, )
+#define DNNE_SDT_PROBE1(provider, name, a1) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT1, _DNNE_SDT_IN(a1))
+#define DNNE_SDT_PROBE2(provider, name, a1, a2) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT2, _DNNE_SDT_IN(a1), _DNNE_SDT_IN(a2))
+#define DNNE_SDT_PROBE3(provider, name, a1, a2, a3) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT3, _DNNE_SDT_IN(a1), _DNNE_SDT_IN(a2), _DNNE_SDT_IN(a3))
+#define DNNE_SDT_PROBE4(provider, name, a1, a2, a3, a4) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT4, _DNNE_SDT_IN(a1), _DNNE_SDT_IN(a2), _DNNE_SDT_IN(a3), _DNNE_SDT_IN(a4))
+#define DNNE_SDT_PROBE5(provider, name, a1, a2, a3, a4, a5) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT5, _DNNE_SDT_IN(a1), _DNNE_SDT_IN(a2), _DNNE_SDT_IN(a3), _DNNE_SDT_IN(a4), _DNNE_SDT_IN(a5))
+#define DNNE_SDT_PROBE6(provider, name, a1, a2, a3, a4, a5, a6) \
+    _DNNE_SDT_PROBE(provider, name, _DNNE_SDT_ARGFMT6, _DNNE_SDT_IN(a1), _DNNE_SDT_IN(a2), _DNNE_SDT_IN(a3), _DNNE_SDT_IN(a4), _DNNE_SDT_IN(a5), _DNNE_SDT_IN(a6))
+
+#else
+
+#define DNNE_SDT_ENABLED 0
+
+#define DNNE_SDT_PROBE0(provider, name)
+#define DNNE_SDT_PROBE1(provider, name, a1)
+#define DNNE_SDT_PROBE2(provider, name, a1, a2)
+#define DNNE_SDT_PROBE3(provider, name, a1, a2, a3)
+#define DNNE_SDT_PROBE4(provider, name, a1, a2, a3, a4)
+#define DNNE_SDT_PROBE5(provider, name, a1, a2, a3, a4, a5)
+#define DNNE_SDT_PROBE6(provider, name, a1, a2, a3, a4, a5, a6)
+
+#endif // !DNNE_USDT_PROBES
+
+#endif // __SRC_PLATFORM_DNNE_SDT_H__
@@ -17,23 +17,48 @@
 // OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
 // SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
+// Needed for dladdr() in non-macOS scenarios. Defined before any
+// system header is included, including those included by dnne.h.
+#if !defined(_WIN32) && !defined(__APPLE__) && !defined(_GNU_SOURCE)
+    #define _GNU_SOURCE
+#endif
+
 #include "dnne.h"
+#include "dnne_sdt.h"
 
 // Must define the assembly name
 #ifndef DNNE_ASSEMBLY_NAME
     #error Target assembly name must be defined. Set 'DNNE_ASSEMBLY_NAME'.
 #endif
 
-// Include the official nethost API and indicate
-// consumption should be as a static library.
-#define NETHOST_USE_AS_STATIC
-#include <nethost.h>
+#if defined(DNNE_NO_NETHOST) && defined(DNNE_WINDOWS)
+    #error Locating hostfxr without nethost is not supported on Windows.
+#endif
+
+#if defined(DNNE_EMBED_ASSEMBLY) && defined(DNNE_SELF_CONTAINED_RUNTIME)
+    #error Embedding the assembly is not supported with a self-contained runtime.
+#endif
 
-// Needed for dladdr() in non-macOS scenarios
-#if !defined(DNNE_WINDOWS) && !defined(DNNE_OSX) && !defined(_GNU_SOURCE)
-    #define _GNU_SOURCE
+#if defined(DNNE_OUT_OF_PROCESS) && !defined(DNNE_LINUX)
+    #error Out-of-process dispatch is only supported on Linux.
 #endif
 
+#if defined(DNNE_SELF_CONTAINED_RUNTIME) || defined(DNNE_NO_NETHOST)
+    // The self-contained runtime is deployed next to this image and
+    // DNNE_NO_NETHOST searches for hostfxr directly, so nethost isn't
+    // needed to locate it. Define the type it would provide.
+    #ifdef DNNE_WINDOWS
+        typedef wchar_t char_t;
+    #else
+        typedef char char_t;
+    #endif
+#else
+    // Include the official nethost API and indicate
+    // consumption should be as a static library.
+    #define NETHOST_USE_AS_STATIC
+    #include <nethost.h>
+#endif // !DNNE_SELF_CONTAINED_RUNTIME && !DNNE_NO_NETHOST
+
 #include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -56,7 +81,10 @@ enum hostfxr_delegate_type
     hdt_winrt_activation,
     hdt_com_register,
     hdt_com_unregister,
-    hdt_load_assembly_and_get_function_pointer
+    hdt_load_assembly_and_get_function_pointer,
+    hdt_get_function_pointer,
+    hdt_load_assembly,
+    hdt_load_assembly_bytes
 };
 
 typedef int32_t(HOSTFXR_CALLTYPE* hostfxr_main_fn)(const int argc, const char_t** argv);
@@ -136,6 +164,24 @@ typedef int (CORECLR_DELEGATE_CALLTYPE *load_assembly_and_get_function_pointer_f
 // Signature of delegate returned by load_assembly_and_get_function_pointer_fn when delegate_type_name == null (default)
 typedef int (CORECLR_DELEGATE_CALLTYPE* component_entry_point_fn)(void* arg, int32_t arg_size_in_bytes);
 
+typedef int (CORECLR_DELEGATE_CALLTYPE *get_function_pointer_fn)(
+    const char_t *type_name          /* Assembly qualified type name */,
+    const char_t *method_name        /* Public static method name compatible with delegateType */,
+    const char_t *delegate_type_name /* Assembly qualified delegate type name or null,
+                                        or UNMANAGEDCALLERSONLY_METHOD if the method is marked with
+                                        the UnmanagedCallersOnlyAttribute. */,
+    void         *load_context       /* Extensibility parameter (currently unused and must be 0) */,
+    void         *reserved           /* Extensibility parameter (currently unused and must be 0) */,
+    /*out*/ void **delegate          /* Pointer where to store the function pointer result */);
+
+typedef int (CORECLR_DELEGATE_CALLTYPE *load_assembly_bytes_fn)(
+    const void *assembly_bytes      /* Bytes of the assembly to load */,
+    size_t     assembly_bytes_len   /* Byte length of the assembly to load */,
+    const void *symbols_bytes       /* Optional. Bytes of the symbols for the assembly */,
+    size_t     symbols_bytes_len    /* Optional. Byte length of the symbols for the assembly */,
+    void       *load_context        /* Extensibility parameter (currently unused and must be 0) */,
+    void       *reserved            /* Extensibility parameter (currently unused and must be 0) */);
+
 #endif // __CORECLR_DELEGATES_H__
 
 //
@@ -163,7 +209,9 @@ typedef volatile long dnne_lock_handle;
 #include <Windows.h>
 
 #define DNNE_NORETURN __declspec(noreturn)
+#define DNNE_THREAD_LOCAL __declspec(thread)
 #define DNNE_DIR_SEPARATOR L'\\'
+#define DNNE_HOSTFXR_FILENAME L"hostfxr.dll"
 
 static void* load_library(const char_t* path)
 {
@@ -230,6 +278,41 @@ static void exit_lock(dnne_lock_handle* lock)
     InterlockedExchange(lock, DNNE_LOCK_OPEN);
 }
 
+static long interlocked_increment(volatile long* value)
+{
+    return InterlockedIncrement(value);
+}
+
+static uint64_t interlocked_increment64(volatile uint64_t* value)
+{
+    return (uint64_t)InterlockedIncrement64((volatile LONG64*)value);
+}
+
+static bool interlocked_compare_exchange64(volatile uint64_t* value, uint64_t expected, uint64_t desired)
+{
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)value, (LONG64)desired, (LONG64)expected) == expected;
+}
+
+static uint64_t load_acquire64(volatile uint64_t* value)
+{
+    return (uint64_t)InterlockedCompareExchange64((volatile LONG64*)value, 0, 0);
+}
+
+static void store_release64(volatile uint64_t* value, uint64_t v)
+{
+    (void)InterlockedExchange64((volatile LONG64*)value, (LONG64)v);
+}
+
+static void acquire_fence(void)
+{
+    MemoryBarrier();
+}
+
+static void release_fence(void)
+{
+    MemoryBarrier();
+}
+
 #else
 
 #include <dlfcn.h>
@@ -237,10 +320,54 @@ static void exit_lock(dnne_lock_handle* lock)
 #include <string.h>
 #include <sched.h>
 #include <errno.h>
+#include <stdio.h>
+#include <unistd.h>
 
 #define DNNE_NORETURN __attribute__((__noreturn__))
+#define DNNE_THREAD_LOCAL __thread
 #define DNNE_DIR_SEPARATOR '/'
 
+#ifdef DNNE_OSX
+    #define DNNE_HOSTFXR_FILENAME "libhostfxr.dylib"
+#else
+    #define DNNE_HOSTFXR_FILENAME "libhostfxr.so"
+#endif
+
+#ifdef DNNE_NO_NETHOST
+#include <dirent.h>
+#include <sys/stat.h>
+#endif // DNNE_NO_NETHOST
+
+#ifdef __linux__
+// Used to append to the runtime's perf map.
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#endif // __linux__
+
+#ifdef DNNE_OUT_OF_PROCESS
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#endif // DNNE_OUT_OF_PROCESS
+
+#ifdef DNNE_TRACING
+#include <pthread.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#endif // DNNE_TRACING
+
 static void* load_library(const char_t* path)
 {
     assert(path != NULL);
@@ -327,6 +454,71 @@ static void exit_lock(dnne_lock_handle* lock)
 #endif // !__arm__
 }
 
+static long interlocked_increment(volatile long* value)
+{
+#ifdef __arm__
+    return __sync_add_and_fetch(value, 1);
+#else
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+#endif // !__arm__
+}
+
+static uint64_t interlocked_increment64(volatile uint64_t* value)
+{
+#ifdef __arm__
+    return __sync_add_and_fetch(value, 1);
+#else
+    return __atomic_add_fetch(value, 1, __ATOMIC_SEQ_CST);
+#endif // !__arm__
+}
+
+static bool interlocked_compare_exchange64(volatile uint64_t* value, uint64_t expected, uint64_t desired)
+{
+#ifdef __arm__
+    return __sync_bool_compare_and_swap(value, expected, desired);
+#else
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+#endif // !__arm__
+}
+
+static uint64_t load_acquire64(volatile uint64_t* value)
+{
+#ifdef __arm__
+    return __sync_val_compare_and_swap(value, 0, 0);
+#else
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif // !__arm__
+}
+
+static void store_release64(volatile uint64_t* value, uint64_t v)
+{
+#ifdef __arm__
+    uint64_t curr = *value;
+    while (!__sync_bool_compare_and_swap(value, curr, v))
+        curr = *value;
+#else
+    __atomic_store_n(value, v, __ATOMIC_RELEASE);
+#endif // !__arm__
+}
+
+static void acquire_fence(void)
+{
+#ifdef __arm__
+    __sync_synchronize();
+#else
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#endif // !__arm__
+}
+
+static void release_fence(void)
+{
+#ifdef __arm__
+    __sync_synchronize();
+#else
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+#endif // !__arm__
+}
+
 #ifdef __clang__
 #pragma clang diagnostic pop
 #endif // __clang__
@@ -418,17 +610,364 @@ static int get_current_dir_filepath(int32_t buffer_len, char_t* buffer, int32_t
     return DNNE_SUCCESS;
 }
 
+#ifdef DNNE_EMBED_ASSEMBLY
+
+// Defined in the source generated by 'dnne-gen -e'. The runtimeconfig.json
+// is optional and has a size of zero if it wasn't embedded.
+extern const uint8_t dnne_embedded_assembly[];
+extern const size_t dnne_embedded_assembly_size;
+extern const uint8_t dnne_embedded_runtimeconfig[];
+extern const size_t dnne_embedded_runtimeconfig_size;
+
+#define DNNE_RUNTIMECONFIG_SUFFIX ".runtimeconfig.json"
+
+// hostfxr only reads the runtimeconfig.json from a file, so the embedded copy
+// is written to a uniquely named file in the temporary directory. The directory
+// is local, unlike the directory of this image which may be on a network share.
+static int write_embedded_runtimeconfig(int32_t buffer_len, char_t* buffer, const char_t** result)
+{
+    assert(buffer != NULL && result != NULL);
+
+#ifdef DNNE_WINDOWS
+    wchar_t temp_dir[DNNE_MAX_PATH];
+    DWORD temp_dir_len = GetTempPathW(DNNE_ARRAY_SIZE(temp_dir), temp_dir);
+    if (temp_dir_len == 0 || temp_dir_len >= DNNE_ARRAY_SIZE(temp_dir))
+        return (-1);
+
+    HANDLE file = INVALID_HANDLE_VALUE;
+    for (DWORD attempt = 0; file == INVALID_HANDLE_VALUE; ++attempt)
+    {
+        int len = _snwprintf(buffer, buffer_len, L"%ls%ls.%lx.%lx" DNNE_STR(DNNE_RUNTIMECONFIG_SUFFIX),
+            temp_dir, DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)), GetCurrentProcessId(), GetTickCount() + attempt);
+        if (len < 0 || len >= buffer_len)
+            return (-1);
+
+        // Never replace an existing file.
+        file = CreateFileW(buffer, GENERIC_WRITE, 0, NULL, CREATE_NEW, FILE_ATTRIBUTE_TEMPORARY, NULL);
+        if (file == INVALID_HANDLE_VALUE && GetLastError() != ERROR_FILE_EXISTS)
+            return (int)GetLastError();
+    }
+
+    DWORD written = 0;
+    BOOL success = WriteFile(file, dnne_embedded_runtimeconfig, (DWORD)dnne_embedded_runtimeconfig_size, &written, NULL);
+    success = CloseHandle(file) && success && written == dnne_embedded_runtimeconfig_size;
+    if (!success)
+    {
+        (void)DeleteFileW(buffer);
+        return (-1);
+    }
+#else
+    const char* temp_dir = getenv("TMPDIR");
+    if (temp_dir == NULL || temp_dir[0] == '\0')
+        temp_dir = "/tmp";
+
+    int len = snprintf(buffer, (size_t)buffer_len, "%s/%s.XXXXXX" DNNE_RUNTIMECONFIG_SUFFIX, temp_dir, DNNE_TOSTRING(DNNE_ASSEMBLY_NAME));
+    if (len < 0 || len >= buffer_len)
+        return (-1);
+
+    int fd = mkstemps(buffer, sizeof(DNNE_RUNTIMECONFIG_SUFFIX) - 1);
+    if (fd < 0)
+        return (-1);
+
+    const uint8_t* data = dnne_embedded_runtimeconfig;
+    size_t remaining = dnne_embedded_runtimeconfig_size;
+    while (remaining != 0)
+    {
+        ssize_t written = write(fd, data, remaining);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            (void)close(fd);
+            (void)unlink(buffer);
+            return (-1);
+        }
+
+        data += written;
+        remaining -= (size_t)written;
+    }
+
+    if (close(fd) != 0)
+    {
+        (void)unlink(buffer);
+        return (-1);
+    }
+#endif // !DNNE_WINDOWS
+
+    *result = buffer;
+    return DNNE_SUCCESS;
+}
+
+static void delete_embedded_runtimeconfig(const char_t* path)
+{
+#ifdef DNNE_WINDOWS
+    (void)DeleteFileW(path);
+#else
+    (void)unlink(path);
+#endif
+}
+
+#endif // DNNE_EMBED_ASSEMBLY
+
+#ifdef DNNE_NO_NETHOST
+
+// Architecture names used by the DOTNET_ROOT_<ARCH> environment variable
+// and the /etc/dotnet/install_location_<arch> file.
+#if defined(__x86_64__)
+    #define DNNE_ARCH_NAME_UPPER "X64"
+    #define DNNE_ARCH_NAME_LOWER "x64"
+#elif defined(__aarch64__)
+    #define DNNE_ARCH_NAME_UPPER "ARM64"
+    #define DNNE_ARCH_NAME_LOWER "arm64"
+#elif defined(__i386__)
+    #define DNNE_ARCH_NAME_UPPER "X86"
+    #define DNNE_ARCH_NAME_LOWER "x86"
+#elif defined(__arm__)
+    #define DNNE_ARCH_NAME_UPPER "ARM"
+    #define DNNE_ARCH_NAME_LOWER "arm"
+#elif defined(__loongarch64)
+    #define DNNE_ARCH_NAME_UPPER "LOONGARCH64"
+    #define DNNE_ARCH_NAME_LOWER "loongarch64"
+#elif defined(__riscv) && __riscv_xlen == 64
+    #define DNNE_ARCH_NAME_UPPER "RISCV64"
+    #define DNNE_ARCH_NAME_LOWER "riscv64"
+#elif defined(__s390x__)
+    #define DNNE_ARCH_NAME_UPPER "S390X"
+    #define DNNE_ARCH_NAME_LOWER "s390x"
+#elif defined(__powerpc64__)
+    #define DNNE_ARCH_NAME_UPPER "PPC64LE"
+    #define DNNE_ARCH_NAME_LOWER "ppc64le"
+#else
+    #error Unknown architecture for DNNE_NO_NETHOST.
+#endif
+
+// Matches the error returned by nethost (i.e., CoreHostLibMissingFailure).
+#define DNNE_E_HOSTFXR_NOT_FOUND ((int)0x80008083)
+
+#if defined(DNNE_OSX) || defined(DNNE_FREEBSD)
+    #define DNNE_DEFAULT_INSTALL_LOCATION "/usr/local/share/dotnet"
+#else
+    #define DNNE_DEFAULT_INSTALL_LOCATION "/usr/share/dotnet"
+#endif
+
+static bool file_exists(const char* path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// Compare dot separated identifiers using semantic version precedence.
+// Numeric identifiers are compared numerically and sort before others.
+static int compare_version_identifiers(const char* l, const char* r)
+{
+    while (*l != '\0' && *r != '\0')
+    {
+        size_t l_len = strcspn(l, ".");
+        size_t r_len = strcspn(r, ".");
+        bool l_num = strspn(l, "0123456789") == l_len;
+        bool r_num = strspn(r, "0123456789") == r_len;
+
+        int c;
+        if (l_num && r_num)
+        {
+            unsigned long lv = strtoul(l, NULL, 10);
+            unsigned long rv = strtoul(r, NULL, 10);
+            c = (lv > rv) - (lv < rv);
+        }
+        else if (l_num != r_num)
+        {
+            c = l_num ? -1 : 1;
+        }
+        else
+        {
+            c = strncmp(l, r, l_len < r_len ? l_len : r_len);
+            if (c == 0)
+                c = (l_len > r_len) - (l_len < r_len);
+        }
+
+        if (c != 0)
+            return c;
+
+        l += l_len + (l[l_len] == '.');
+        r += r_len + (r[r_len] == '.');
+    }
+
+    return (*l != '\0') - (*r != '\0');
+}
+
+struct fxr_version
+{
+    unsigned long parts[3];
+    char prerelease[64];
+};
+
+// Parse a "major.minor.patch[-prerelease][+build]" version.
+static bool parse_version(const char* str, struct fxr_version* version)
+{
+    char* end = (char*)str;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (i != 0)
+        {
+            if (*end != '.')
+                return false;
+            ++end;
+        }
+
+        const char* start = end;
+        version->parts[i] = strtoul(start, &end, 10);
+        if (end == start || *start < '0' || *start > '9')
+            return false;
+    }
+
+    version->prerelease[0] = '\0';
+    if (*end == '-')
+    {
+        size_t len = strcspn(end + 1, "+");
+        if (len == 0 || len >= sizeof(version->prerelease))
+            return false;
+
+        memcpy(version->prerelease, end + 1, len);
+        version->prerelease[len] = '\0';
+        end += len + 1;
+    }
+
+    return *end == '\0' || *end == '+';
+}
+
+static int compare_versions(const struct fxr_version* l, const struct fxr_version* r)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        if (l->parts[i] != r->parts[i])
+            return (l->parts[i] > r->parts[i]) ? 1 : -1;
+    }
+
+    // A release has higher precedence than a prerelease.
+    if (l->prerelease[0] == '\0' || r->prerelease[0] == '\0')
+        return (l->prerelease[0] == '\0') - (r->prerelease[0] == '\0');
+
+    return compare_version_identifiers(l->prerelease, r->prerelease);
+}
+
+// Find the hostfxr in the highest version directory under <dotnet_root>/host/fxr.
+static int find_latest_hostfxr(const char* dotnet_root, int32_t buffer_len, char_t* buffer)
+{
+    char fxr_dir[DNNE_MAX_PATH];
+    int len = snprintf(fxr_dir, sizeof(fxr_dir), "%s/host/fxr", dotnet_root);
+    if (len < 0 || len >= (int)sizeof(fxr_dir))
+        return DNNE_E_HOSTFXR_NOT_FOUND;
+
+    DIR* dir = opendir(fxr_dir);
+    if (dir == NULL)
+        return DNNE_E_HOSTFXR_NOT_FOUND;
+
+    bool found = false;
+    struct fxr_version latest;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        struct fxr_version version;
+        if (!parse_version(entry->d_name, &version)
+            || (found && compare_versions(&version, &latest) <= 0))
+        {
+            continue;
+        }
+
+        // Only consider versions that contain hostfxr.
+        char path[DNNE_MAX_PATH];
+        len = snprintf(path, sizeof(path), "%s/%s/" DNNE_HOSTFXR_FILENAME, fxr_dir, entry->d_name);
+        if (len < 0 || len >= buffer_len || len >= (int)sizeof(path) || !file_exists(path))
+            continue;
+
+        memcpy(buffer, path, len + 1);
+        latest = version;
+        found = true;
+    }
+    (void)closedir(dir);
+
+    return found ? DNNE_SUCCESS : DNNE_E_HOSTFXR_NOT_FOUND;
+}
+
+// Read the registered install location from the first line of a file.
+static bool read_install_location(const char* path, char* location, size_t location_len)
+{
+    FILE* file = fopen(path, "r");
+    if (file == NULL)
+        return false;
+
+    bool found = fgets(location, (int)location_len, file) != NULL;
+    (void)fclose(file);
+    if (!found)
+        return false;
+
+    location[strcspn(location, "\r\n")] = '\0';
+    return location[0] != '\0';
+}
+
+// Locate hostfxr using the same search order as nethost's get_hostfxr_path():
+//  1) The directory containing this image and the assembly (i.e., an app-local runtime).
+//  2) The DOTNET_ROOT_<ARCH> or DOTNET_ROOT environment variable.
+//  3) The install location registered in /etc/dotnet/install_location_<arch>
+//     or /etc/dotnet/install_location.
+//  4) The default install location.
+// The first .NET root found is used, even if it doesn't contain hostfxr.
+static int find_hostfxr(int32_t buffer_len, char_t* buffer)
+{
+    const char_t hostfxr_filename[] = DNNE_HOSTFXR_FILENAME;
+    const char_t* app_local_path = NULL;
+    int rc = get_current_dir_filepath(buffer_len, buffer, DNNE_ARRAY_SIZE(hostfxr_filename), hostfxr_filename, &app_local_path);
+    if (!is_failure(rc) && file_exists(app_local_path))
+        return DNNE_SUCCESS;
+
+    const char* dotnet_root = getenv("DOTNET_ROOT_" DNNE_ARCH_NAME_UPPER);
+    if (dotnet_root == NULL || dotnet_root[0] == '\0')
+        dotnet_root = getenv("DOTNET_ROOT");
+    if (dotnet_root != NULL && dotnet_root[0] != '\0')
+        return find_latest_hostfxr(dotnet_root, buffer_len, buffer);
+
+    char location[DNNE_MAX_PATH];
+    if (read_install_location("/etc/dotnet/install_location_" DNNE_ARCH_NAME_LOWER, location, sizeof(location))
+        || read_install_location("/etc/dotnet/install_location", location, sizeof(location)))
+    {
+        return find_latest_hostfxr(location, buffer_len, buffer);
+    }
+
+    return find_latest_hostfxr(DNNE_DEFAULT_INSTALL_LOCATION, buffer_len, buffer);
+}
+
+#endif // DNNE_NO_NETHOST
+
 // Globals to hold hostfxr exports
 
+#ifdef DNNE_SELF_CONTAINED_RUNTIME
 static hostfxr_initialize_for_dotnet_command_line_fn init_self_contained_fptr;
+#else
 static hostfxr_initialize_for_runtime_config_fn init_fptr;
+#endif // !DNNE_SELF_CONTAINED_RUNTIME
 static hostfxr_get_runtime_delegate_fn get_delegate_fptr;
 static hostfxr_close_fn close_fptr;
 
 static int load_hostfxr(const char_t* assembly_path)
 {
-    // Discover the path to hostfxr.
     char_t buffer[DNNE_MAX_PATH];
+#ifdef DNNE_SELF_CONTAINED_RUNTIME
+    // Use the app-local hostfxr, there is no need to probe for an install.
+    (void)assembly_path;
+    const char_t hostfxr_filename[] = DNNE_HOSTFXR_FILENAME;
+    const char_t* hostfxr_path = NULL;
+    int rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(hostfxr_filename), hostfxr_filename, &hostfxr_path);
+    if (is_failure(rc))
+        return rc;
+#elif defined(DNNE_NO_NETHOST)
+    // The assembly is deployed next to this image, where an app-local hostfxr is searched for.
+    (void)assembly_path;
+    int rc = find_hostfxr(DNNE_ARRAY_SIZE(buffer), buffer);
+    if (is_failure(rc))
+        return rc;
+#else
+    // Discover the path to hostfxr.
     size_t buffer_size = DNNE_ARRAY_SIZE(buffer);
     struct get_hostfxr_parameters params;
     params.size = sizeof(params);
@@ -437,20 +976,35 @@ static int load_hostfxr(const char_t* assembly_path)
     int rc = get_hostfxr_path(buffer, &buffer_size, &params);
     if (is_failure(rc))
         return rc;
+#endif // !DNNE_SELF_CONTAINED_RUNTIME
 
     // Load hostfxr and get desired exports.
     void* lib = load_library(buffer);
+    if (lib == NULL)
+        return (-1);
+
+#ifdef DNNE_SELF_CONTAINED_RUNTIME
     init_self_contained_fptr = (hostfxr_initialize_for_dotnet_command_line_fn)get_export(lib, "hostfxr_initialize_for_dotnet_command_line");
+    if (init_self_contained_fptr == NULL)
+        return (-1);
+#else
     init_fptr = (hostfxr_initialize_for_runtime_config_fn)get_export(lib, "hostfxr_initialize_for_runtime_config");
+    if (init_fptr == NULL)
+        return (-1);
+#endif // !DNNE_SELF_CONTAINED_RUNTIME
     get_delegate_fptr = (hostfxr_get_runtime_delegate_fn)get_export(lib, "hostfxr_get_runtime_delegate");
     close_fptr = (hostfxr_close_fn)get_export(lib, "hostfxr_close");
 
-    assert(init_self_contained_fptr && init_fptr && get_delegate_fptr && close_fptr);
+    assert(get_delegate_fptr && close_fptr);
     return DNNE_SUCCESS;
 }
 
 // Globals to hold runtime exports
+#ifdef DNNE_EMBED_ASSEMBLY
+static get_function_pointer_fn volatile get_managed_export_fptr;
+#else
 static load_assembly_and_get_function_pointer_fn volatile get_managed_export_fptr;
+#endif // !DNNE_EMBED_ASSEMBLY
 
 static int init_dotnet(const char_t* assembly_path)
 {
@@ -458,34 +1012,86 @@ static int init_dotnet(const char_t* assembly_path)
     int rc;
 
 #ifdef DNNE_SELF_CONTAINED_RUNTIME
-    // Self-contained scenario support is experimental and relies upon the application scenario
-    // entry-point. The logic here is to trick the hosting API into initializing as an application
-    // but call the "load assembly and get delegate" instead of "run main". This has impact
-    // on the TPA make-up and hence assembly loading in general since the TPA populates the default ALC.
+    // The hosting API only supports self-contained activation through the application
+    // entry-point. The runtime is initialized as if the assembly were an application but
+    // "load assembly and get delegate" is called instead of "run main". The assembly's
+    // deps.json therefore describes the TPA and hence the default ALC.
+    // This image is supplied as the host and its directory as the root of the runtime so
+    // hostfxr resolves everything app-local instead of inspecting the host process.
+    char_t host_path[DNNE_MAX_PATH];
+    char_t dotnet_root[DNNE_MAX_PATH];
+    const char_t* dotnet_root_path = NULL;
+    int32_t written = 0;
+    rc = get_this_image_path(DNNE_ARRAY_SIZE(host_path), host_path, &written);
+    if (is_failure(rc))
+        return rc;
+
+    // An empty filename results in the directory of this image.
+    const char_t empty_filename[] = DNNE_STR("");
+    rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(dotnet_root), dotnet_root, DNNE_ARRAY_SIZE(empty_filename), empty_filename, &dotnet_root_path);
+    if (is_failure(rc))
+        return rc;
+
+    hostfxr_initialize_parameters params;
+    params.size = sizeof(params);
+    params.host_path = host_path;
+    params.dotnet_root = dotnet_root_path;
     config_path = assembly_path;
 #else
     char_t buffer[DNNE_MAX_PATH];
-    const char_t config_filename[] = DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)) DNNE_STR(".runtimeconfig.json");
-    rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(config_filename), config_filename, &config_path);
+#ifdef DNNE_EMBED_ASSEMBLY
+    if (dnne_embedded_runtimeconfig_size != 0)
+    {
+        rc = write_embedded_runtimeconfig(DNNE_ARRAY_SIZE(buffer), buffer, &config_path);
+    }
+    else
+#endif // DNNE_EMBED_ASSEMBLY
+    {
+        const char_t config_filename[] = DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)) DNNE_STR(".runtimeconfig.json");
+        rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(config_filename), config_filename, &config_path);
+    }
     if (is_failure(rc))
         return rc;
 #endif
 
     // Load .NET runtime
-    void* load_assembly_and_get_function_pointer = NULL;
     hostfxr_handle cxt = NULL;
 #ifdef DNNE_SELF_CONTAINED_RUNTIME
-    rc = init_self_contained_fptr(1, &config_path, NULL, &cxt);
+    rc = init_self_contained_fptr(1, &config_path, &params, &cxt);
 #else
     rc = init_fptr(config_path, NULL, &cxt);
 #endif
+#ifdef DNNE_EMBED_ASSEMBLY
+    // The runtimeconfig.json is only read during initialization.
+    if (dnne_embedded_runtimeconfig_size != 0)
+        delete_embedded_runtimeconfig(config_path);
+#endif // DNNE_EMBED_ASSEMBLY
+    if (is_failure(rc))
+    {
+        close_fptr(cxt);
+        return rc;
+    }
+
+#ifdef DNNE_EMBED_ASSEMBLY
+    // Load the embedded assembly once, exports are then resolved
+    // by their assembly qualified type name (requires .NET 8+).
+    void* load_assembly_bytes = NULL;
+    void* get_function_pointer = NULL;
+    rc = get_delegate_fptr(cxt, hdt_load_assembly_bytes, &load_assembly_bytes);
+    if (!is_failure(rc))
+        rc = get_delegate_fptr(cxt, hdt_get_function_pointer, &get_function_pointer);
+    if (!is_failure(rc))
+        rc = ((load_assembly_bytes_fn)load_assembly_bytes)(dnne_embedded_assembly, dnne_embedded_assembly_size, NULL, 0, NULL, NULL);
     if (is_failure(rc))
     {
         close_fptr(cxt);
         return rc;
     }
 
+    get_managed_export_fptr = (get_function_pointer_fn)get_function_pointer;
+#else
     // Get the load assembly function pointer
+    void* load_assembly_and_get_function_pointer = NULL;
     rc = get_delegate_fptr(
         cxt,
         hdt_load_assembly_and_get_function_pointer,
@@ -497,31 +1103,337 @@ static int init_dotnet(const char_t* assembly_path)
     }
 
     get_managed_export_fptr = (load_assembly_and_get_function_pointer_fn)load_assembly_and_get_function_pointer;
+#endif // !DNNE_EMBED_ASSEMBLY
     return DNNE_SUCCESS;
 }
 
-#define IF_FAILURE_RETURN_OR_ABORT(ret_maybe, type, rc, lock) \
-{ \
-    if (is_failure(rc)) \
-    { \
-        exit_lock(lock); \
-        if (ret_maybe) \
-        { \
-            *ret_maybe = rc; \
-            return; \
-        } \
-        noreturn_failure(type, rc); \
-    } \
-}
+//
+// Timeline tracing
+//
+// The entry and return of each export, and the phases of runtime activation, are
+// recorded with a timestamp counter value in a ring buffer owned by the calling
+// thread. Only the owning thread writes to a ring, so recording takes no locks.
+// Rings are never released, the records of exited threads are kept for the dump.
+//
 
-dnne_lock_handle _prepare_lock = DNNE_LOCK_OPEN;
+// Events are export ids, or one of the phases below, with the high bit set for the end.
+#define DNNE_TRACE_END_FLAG UINT32_C(0x80000000)
+#define DNNE_TRACE_PREPARE_RUNTIME UINT32_C(0x7fffff01)
+#define DNNE_TRACE_LOAD_HOSTFXR UINT32_C(0x7fffff02)
+#define DNNE_TRACE_INIT_RUNTIME UINT32_C(0x7fffff03)
+#define DNNE_TRACE_RESOLVE_EXPORT UINT32_C(0x7fffff04)
 
-static void prepare_runtime(int* ret)
-{
+#if defined(DNNE_TRACING) && !defined(DNNE_WINDOWS)
+
+// Number of records kept per thread, must be a power of two.
+#ifndef DNNE_TRACE_RING_SIZE
+    #define DNNE_TRACE_RING_SIZE 8192
+#endif
+
+struct trace_record
+{
+    uint64_t timestamp;
+    uint32_t event;
+};
+
+struct trace_ring
+{
+    struct trace_ring* next;
+    uint64_t thread_id;
+
+    // Set when the owning thread exits so the ring can be reused. Protected by the trace lock.
+    bool exited;
+
+    // Number of records written. Only written by the owning thread.
+    uint64_t head;
+    struct trace_record records[DNNE_TRACE_RING_SIZE];
+};
+
+// Defined in the generated source, indexed by export id.
+DNNE_EXTERN_DATA __attribute__((visibility("hidden"))) const uint32_t dnne_trace_export_count;
+DNNE_EXTERN_DATA __attribute__((visibility("hidden"))) const char* const dnne_trace_export_names[];
+
+static struct trace_ring* trace_rings;
+static dnne_lock_handle _trace_lock = DNNE_LOCK_OPEN;
+static DNNE_THREAD_LOCAL struct trace_ring* trace_thread_ring;
+
+// The destructor of the key marks the ring of an exiting thread for reuse.
+static pthread_key_t trace_ring_key;
+static pthread_once_t trace_ring_key_once = PTHREAD_ONCE_INIT;
+
+// Timestamp counter and clock values when the first ring was created,
+// used to convert timestamps when the trace is written.
+static uint64_t trace_start_timestamp;
+static uint64_t trace_start_ns;
+
+static uint64_t trace_clock_ns(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t trace_timestamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return trace_clock_ns();
+#endif
+}
+
+static uint64_t trace_thread_id(void)
+{
+#if defined(__linux__)
+    return (uint64_t)syscall(SYS_gettid);
+#elif defined(__APPLE__)
+    uint64_t tid = 0;
+    (void)pthread_threadid_np(NULL, &tid);
+    return tid;
+#else
+    return (uint64_t)(uintptr_t)pthread_self();
+#endif
+}
+
+static void trace_release_ring(void* value)
+{
+    struct trace_ring* ring = (struct trace_ring*)value;
+
+    // The records are kept, and written by a dump, until another thread takes the ring.
+    enter_lock(&_trace_lock);
+    ring->exited = true;
+    exit_lock(&_trace_lock);
+
+    trace_thread_ring = NULL;
+}
+
+static void trace_create_ring_key(void)
+{
+    (void)pthread_key_create(&trace_ring_key, trace_release_ring);
+}
+
+static struct trace_ring* trace_create_ring(void)
+{
+    (void)pthread_once(&trace_ring_key_once, trace_create_ring_key);
+
+    uint64_t thread_id = trace_thread_id();
+
+    // Reuse the ring of an exited thread so threads that come and go don't grow the memory used.
+    // A dump holds the lock, so it never sees the ring while it is being reset.
+    struct trace_ring* ring = NULL;
+    enter_lock(&_trace_lock);
+    for (struct trace_ring* r = trace_rings; r != NULL; r = r->next)
+    {
+        if (r->exited)
+        {
+            ring = r;
+            ring->exited = false;
+            ring->thread_id = thread_id;
+            __atomic_store_n(&ring->head, 0, __ATOMIC_RELAXED);
+            break;
+        }
+    }
+    exit_lock(&_trace_lock);
+
+    if (ring == NULL)
+    {
+        // Tracing is best effort, an allocation failure only omits the thread's records.
+        ring = (struct trace_ring*)calloc(1, sizeof(struct trace_ring));
+        if (ring == NULL)
+            return NULL;
+
+        ring->thread_id = thread_id;
+
+        enter_lock(&_trace_lock);
+        if (trace_rings == NULL)
+        {
+            trace_start_ns = trace_clock_ns();
+            trace_start_timestamp = trace_timestamp();
+        }
+        ring->next = trace_rings;
+        trace_rings = ring;
+        exit_lock(&_trace_lock);
+    }
+
+    (void)pthread_setspecific(trace_ring_key, ring);
+    trace_thread_ring = ring;
+    return ring;
+}
+
+// Called by the generated exports.
+void dnne_trace_event(uint32_t event)
+{
+    struct trace_ring* ring = trace_thread_ring;
+    if (ring == NULL)
+    {
+        ring = trace_create_ring();
+        if (ring == NULL)
+            return;
+    }
+
+    // The slot of the oldest record is only overwritten once the previous
+    // head is visible, so a dump can detect records that were overwritten.
+    uint64_t head = ring->head;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    struct trace_record* record = &ring->records[head & (DNNE_TRACE_RING_SIZE - 1)];
+    record->timestamp = trace_timestamp();
+    record->event = event;
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+#define DNNE_TRACE_BEGIN(event) dnne_trace_event(event)
+#define DNNE_TRACE_END(event) dnne_trace_event((event) | DNNE_TRACE_END_FLAG)
+#define DNNE_TRACE_PREPARE_THREAD() (void)(trace_thread_ring != NULL || trace_create_ring() != NULL)
+
+static const char* trace_event_name(uint32_t event, const char** category)
+{
+    *category = "runtime";
+    switch (event)
+    {
+    case DNNE_TRACE_PREPARE_RUNTIME:
+        return "prepare_runtime";
+    case DNNE_TRACE_LOAD_HOSTFXR:
+        return "load_hostfxr";
+    case DNNE_TRACE_INIT_RUNTIME:
+        return "init_runtime";
+    case DNNE_TRACE_RESOLVE_EXPORT:
+        return "resolve_export";
+    }
+
+    *category = "export";
+    if (event < dnne_trace_export_count)
+        return dnne_trace_export_names[event];
+
+    return NULL;
+}
+
+static void trace_write_ring(FILE* file, const struct trace_ring* ring, struct trace_record* copy, double ns_per_tick)
+{
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t start = head > DNNE_TRACE_RING_SIZE ? head - DNNE_TRACE_RING_SIZE : 0;
+    for (uint64_t i = start; i < head; ++i)
+        copy[i & (DNNE_TRACE_RING_SIZE - 1)] = ring->records[i & (DNNE_TRACE_RING_SIZE - 1)];
+
+    // Records the owning thread may have overwritten during the copy are dropped.
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint64_t current = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    if (current >= start + DNNE_TRACE_RING_SIZE)
+        start = current - DNNE_TRACE_RING_SIZE + 1;
+
+    uint32_t depth = 0;
+    for (uint64_t i = start; i < head; ++i)
+    {
+        const struct trace_record* record = &copy[i & (DNNE_TRACE_RING_SIZE - 1)];
+        bool end = (record->event & DNNE_TRACE_END_FLAG) != 0;
+
+        // The beginning of the oldest calls may have been overwritten.
+        if (end && depth == 0)
+            continue;
+
+        const char* category;
+        const char* name = trace_event_name(record->event & ~DNNE_TRACE_END_FLAG, &category);
+        if (name == NULL)
+            continue;
+
+        depth = end ? depth - 1 : depth + 1;
+
+        // Chrome trace timestamps are in microseconds.
+        double ts = (double)(int64_t)(record->timestamp - trace_start_timestamp) * ns_per_tick / 1000.0;
+        (void)fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%ld,\"tid\":%llu}",
+            name, category, end ? 'E' : 'B', ts, (long)getpid(), (unsigned long long)ring->thread_id);
+    }
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_trace_dump(const char* path)
+{
+    char default_path[64];
+    if (path == NULL)
+    {
+        (void)snprintf(default_path, DNNE_ARRAY_SIZE(default_path), "/tmp/dnne-trace-%ld.json", (long)getpid());
+        path = default_path;
+    }
+
+    struct trace_record* copy = (struct trace_record*)malloc(sizeof(struct trace_record) * DNNE_TRACE_RING_SIZE);
+    if (copy == NULL)
+        return -1;
+
+    FILE* file = fopen(path, "w");
+    if (file == NULL)
+    {
+        free(copy);
+        return -1;
+    }
+
+    // The process is named after the assembly so traces of several binaries can be merged.
+    (void)fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%ld,\"args\":{\"name\":\"%s\"}}",
+        (long)getpid(), DNNE_TOSTRING(DNNE_ASSEMBLY_NAME));
+
+    enter_lock(&_trace_lock);
+
+    // Calibrate the timestamp counter against the clock over the life of the trace.
+    double ns_per_tick = 1.0;
+    uint64_t elapsed_ns = trace_clock_ns() - trace_start_ns;
+    uint64_t elapsed_ticks = trace_timestamp() - trace_start_timestamp;
+    if (trace_rings != NULL && elapsed_ns != 0 && elapsed_ticks != 0)
+        ns_per_tick = (double)elapsed_ns / (double)elapsed_ticks;
+
+    for (struct trace_ring* ring = trace_rings; ring != NULL; ring = ring->next)
+        trace_write_ring(file, ring, copy, ns_per_tick);
+
+    exit_lock(&_trace_lock);
+
+    (void)fprintf(file, "\n]}\n");
+    free(copy);
+    return fclose(file) == 0 ? DNNE_SUCCESS : -1;
+}
+
+#else
+
+#define DNNE_TRACE_BEGIN(event)
+#define DNNE_TRACE_END(event)
+#define DNNE_TRACE_PREPARE_THREAD()
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_trace_dump(const char* path)
+{
+    // The native binary wasn't built with tracing, or tracing isn't supported on Windows.
+    (void)path;
+    return DNNE_E_NOTIMPL;
+}
+
+#endif // DNNE_TRACING && !DNNE_WINDOWS
+
+#define IF_FAILURE_RETURN_OR_ABORT(ret_maybe, type, rc, lock) \
+{ \
+    if (is_failure(rc)) \
+    { \
+        DNNE_SDT_PROBE1(dnne, runtime__prepare__done, rc); \
+        DNNE_TRACE_END(DNNE_TRACE_PREPARE_RUNTIME); \
+        exit_lock(lock); \
+        if (ret_maybe) \
+        { \
+            *ret_maybe = rc; \
+            return; \
+        } \
+        noreturn_failure(type, rc); \
+    } \
+}
+
+dnne_lock_handle _prepare_lock = DNNE_LOCK_OPEN;
+
+static void prepare_runtime(int* ret)
+{
     // Lock and check if the needed export was already acquired.
     enter_lock(&_prepare_lock);
     if (!get_managed_export_fptr)
     {
+        DNNE_SDT_PROBE0(dnne, runtime__prepare__start);
+        DNNE_TRACE_BEGIN(DNNE_TRACE_PREPARE_RUNTIME);
+
         char_t buffer[DNNE_MAX_PATH];
         const char_t assembly_filename[] = DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)) DNNE_STR(".dll");
         const char_t* assembly_path = NULL;
@@ -529,79 +1441,1675 @@ static void prepare_runtime(int* ret)
         IF_FAILURE_RETURN_OR_ABORT(ret, failure_load_runtime, rc, &_prepare_lock);
 
         // Load HostFxr and get exported hosting functions.
+        DNNE_TRACE_BEGIN(DNNE_TRACE_LOAD_HOSTFXR);
         rc = load_hostfxr(assembly_path);
+        DNNE_TRACE_END(DNNE_TRACE_LOAD_HOSTFXR);
         IF_FAILURE_RETURN_OR_ABORT(ret, failure_load_runtime, rc, &_prepare_lock);
 
         // Initialize and start the runtime.
+        DNNE_TRACE_BEGIN(DNNE_TRACE_INIT_RUNTIME);
         rc = init_dotnet(assembly_path);
+        DNNE_TRACE_END(DNNE_TRACE_INIT_RUNTIME);
         IF_FAILURE_RETURN_OR_ABORT(ret, failure_load_runtime, rc, &_prepare_lock);
 
         assert(get_managed_export_fptr != NULL);
+        DNNE_SDT_PROBE1(dnne, runtime__prepare__done, rc);
+        DNNE_TRACE_END(DNNE_TRACE_PREPARE_RUNTIME);
     }
     exit_lock(&_prepare_lock);
 }
 
-DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE preload_runtime(void)
+#ifdef DNNE_OUT_OF_PROCESS
+
+//
+// Out-of-process dispatch
+//
+// Exports marked with DNNE.RemoteExportAttribute are dispatched to a single server
+// process that hosts a warm runtime. The server is started by the first client and
+// shares a segment of slots with every client of the same binary. A client copies
+// the arguments into a free slot, rings the doorbell and spins, then sleeps, until
+// the server writes the result back. Other exports run in the calling process.
+//
+
+// Defined in the source generated by dnne-gen.
+DNNE_EXTERN_DATA __attribute__((visibility("hidden"))) const uint64_t dnne_remote_abi;
+
+// Implemented by the DNNE.RemoteExports type generated into the assembly.
+// Returns 0, or the HRESULT of the exception thrown by the export.
+typedef int (DNNE_CALLTYPE* remote_dispatch_fn)(int32_t index, void* payload);
+static remote_dispatch_fn remote_dispatch_fptr;
+
+static int resolve_platform_helper(const char_t* dotnet_type, const char_t* dotnet_type_method, void** func);
+
+#define DNNE_REMOTE_MAGIC UINT64_C(0x31304d4552454e44)
+#define DNNE_REMOTE_SLOT_COUNT 64
+// dnne-gen rejects remote exports whose arguments and return value don't fit.
+// Must match C99Emitter.RemotePayloadSize in dnne-gen.
+#define DNNE_REMOTE_PAYLOAD_SIZE 240
+#define DNNE_REMOTE_SERVER_THREADS 4
+#define DNNE_REMOTE_SPIN_COUNT 4000
+#define DNNE_REMOTE_START_TIMEOUT_MS 30000
+#define DNNE_REMOTE_HOST_FILENAME "dnne-remote-host"
+
+// Process ids are below 2^22 on Linux, the start time is stored above them.
+#define DNNE_REMOTE_PID_BITS 22
+
+enum remote_slot_state
 {
-    prepare_runtime(NULL);
+    remote_slot_free = 0,
+    remote_slot_claimed,
+    remote_slot_request,
+    remote_slot_running,
+    remote_slot_response,
+
+    // The server exited while running the request.
+    remote_slot_abandoned,
+};
+
+struct remote_slot
+{
+    // Value of enum remote_slot_state, waited on by the client.
+    uint32_t state;
+    uint32_t client_waiting;
+    uint32_t index;
+
+    // Returned by the managed dispatcher.
+    int32_t result;
+
+    // Token of the process that claimed the slot, 0 while it is claimed or released.
+    uint64_t client;
+
+    // Arguments of the export followed by its return value.
+    uint64_t payload[DNNE_REMOTE_PAYLOAD_SIZE / sizeof(uint64_t)];
+} __attribute__((aligned(64)));
+
+struct remote_segment
+{
+    // Written last by the server once it is ready for requests.
+    uint64_t magic;
+    uint64_t abi;
+    uint64_t server;
+    uint32_t ready;
+
+    // Incremented for each request, waited on by idle server threads.
+    uint32_t doorbell;
+    uint32_t sleeping_servers;
+    uint32_t next_slot;
+
+    struct remote_slot slots[DNNE_REMOTE_SLOT_COUNT];
+};
+
+static struct remote_segment* remote_segment;
+static uint64_t remote_process_token;
+static bool remote_server;
+static int32_t remote_spin_count;
+static dnne_lock_handle _remote_lock = DNNE_LOCK_OPEN;
+
+static int futex_wait(uint32_t* addr, uint32_t expected, const struct timespec* timeout)
+{
+    // The segment is shared between processes so the private futex operations can't be used.
+    return (int)syscall(SYS_futex, addr, FUTEX_WAIT, expected, timeout, NULL, 0);
 }
 
-DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE try_preload_runtime(void)
+static void futex_wake(uint32_t* addr, int count)
 {
-    int ret = DNNE_SUCCESS;
-    prepare_runtime(&ret);
-    return ret;
+    (void)syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
 }
 
-void* get_callable_managed_function(
-    const char_t* dotnet_type,
-    const char_t* dotnet_type_method,
-    const char_t* dotnet_delegate_type)
+static void cpu_relax(void)
 {
-    assert(dotnet_type && dotnet_type_method);
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
 
-    // Store the current error state to reset it when
-    // we exit this function. This being done because this
-    // API is an implementation detail of the export but
-    // can result in side-effects during export resolution.
-    int curr_error = get_current_error();
+// Returns the start time of the process in clock ticks after boot, or 0 if it isn't known.
+static uint64_t get_process_start_time(pid_t pid)
+{
+    char path[32];
+    (void)snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return 0;
+
+    char buffer[1024];
+    ssize_t len;
+    while ((len = read(fd, buffer, sizeof(buffer) - 1)) < 0 && errno == EINTR)
+        ;
+    close(fd);
+    if (len <= 0)
+        return 0;
+    buffer[len] = '\0';
+
+    // The command name may contain spaces, the start time is the 20th field after it.
+    const char* field = strrchr(buffer, ')');
+    for (int32_t i = 0; i < 20 && field != NULL; ++i)
+        field = strchr(field + 1, ' ');
+
+    return field != NULL ? strtoull(field + 1, NULL, 10) : 0;
+}
 
-    // Check if the runtime has already been prepared.
-    if (!get_managed_export_fptr)
+// A process is identified by its id and start time, so a process that
+// reuses the id of one that exited isn't mistaken for it.
+static uint64_t get_process_token(pid_t pid)
+{
+    return (get_process_start_time(pid) << DNNE_REMOTE_PID_BITS) | (uint64_t)pid;
+}
+
+static bool is_process_alive(uint64_t token)
+{
+    pid_t pid = (pid_t)(token & ((UINT64_C(1) << DNNE_REMOTE_PID_BITS) - 1));
+    if (pid <= 0)
+        return false;
+
+    uint64_t start_time = get_process_start_time(pid);
+    if (start_time != 0)
+        return start_time == (token >> DNNE_REMOTE_PID_BITS);
+
+    // Without procfs only the id can be checked.
+    return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+// Opens the segment file and maps it, unless it was already mapped.
+static int open_remote_segment(struct remote_segment** segment)
+{
+    // The name includes the ABI of the exports so mismatched builds of
+    // the same assembly never share a server.
+    char path[DNNE_MAX_PATH];
+    int len = snprintf(path, sizeof(path), "/dev/shm/dnne.%s.%016llx.%u",
+        DNNE_TOSTRING(DNNE_ASSEMBLY_NAME), (unsigned long long)dnne_remote_abi, (unsigned)getuid());
+    if (len < 0 || len >= (int)sizeof(path))
+        return -1;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+    if (fd < 0)
+        return -1;
+
+    // Don't trust a segment created by another user.
+    struct stat st;
+    if (fstat(fd, &st) != 0
+        || st.st_uid != getuid()
+        || (st.st_size < (off_t)sizeof(struct remote_segment) && ftruncate(fd, sizeof(struct remote_segment)) != 0))
     {
-        prepare_runtime(NULL);
-        assert(get_managed_export_fptr != NULL);
+        close(fd);
+        return -1;
+    }
+
+    if (*segment == NULL)
+    {
+        void* addr = mmap(NULL, sizeof(struct remote_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED)
+        {
+            close(fd);
+            return -1;
+        }
+
+        *segment = (struct remote_segment*)addr;
+    }
+
+    return fd;
+}
+
+// A child process keeps the segment mapped but must claim slots with its own token.
+static void reset_remote_process_token(void)
+{
+    __atomic_store_n(&remote_process_token, 0, __ATOMIC_RELAXED);
+}
+
+static uint64_t get_remote_process_token(void)
+{
+    uint64_t token = __atomic_load_n(&remote_process_token, __ATOMIC_RELAXED);
+    if (token == 0)
+    {
+        token = get_process_token(getpid());
+        __atomic_store_n(&remote_process_token, token, __ATOMIC_RELAXED);
     }
 
+    return token;
+}
+
+static void init_remote_process(void)
+{
+    // Spinning only helps when the other process can run at the same time.
+    remote_spin_count = sysconf(_SC_NPROCESSORS_ONLN) > 1 ? DNNE_REMOTE_SPIN_COUNT : 0;
+
+    static bool registered;
+    if (!registered)
+        registered = pthread_atfork(NULL, NULL, reset_remote_process_token) == 0;
+}
+
+static bool is_remote_server_ready(struct remote_segment* segment)
+{
+    return __atomic_load_n(&segment->magic, __ATOMIC_ACQUIRE) == DNNE_REMOTE_MAGIC
+        && segment->abi == dnne_remote_abi
+        && is_process_alive(__atomic_load_n(&segment->server, __ATOMIC_ACQUIRE));
+}
+
+static int start_remote_server(struct remote_segment* segment)
+{
+    char_t image_path[DNNE_MAX_PATH];
+    int32_t written = 0;
+    int rc = get_this_image_path(DNNE_ARRAY_SIZE(image_path), image_path, &written);
+    if (is_failure(rc))
+        return rc;
+
     char_t buffer[DNNE_MAX_PATH];
-    const char_t assembly_filename[] = DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)) DNNE_STR(".dll");
-    const char_t* assembly_path = NULL;
-    int rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(assembly_filename), assembly_filename, &assembly_path);
+    const char_t host_filename[] = DNNE_REMOTE_HOST_FILENAME;
+    const char_t* host_path = NULL;
+    rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(host_filename), host_filename, &host_path);
     if (is_failure(rc))
-        noreturn_failure(failure_load_export, rc);
+        return rc;
 
-    // Function pointer to managed function
-    void* func = NULL;
-    rc = get_managed_export_fptr(
-        assembly_path,
-        dotnet_type,
-        dotnet_type_method,
-        dotnet_delegate_type,
-        NULL,
-        &func);
+    __atomic_store_n(&segment->magic, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&segment->server, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&segment->ready, 0, __ATOMIC_SEQ_CST);
 
-    if (is_failure(rc))
-        noreturn_failure(failure_load_export, rc);
+    posix_spawnattr_t attr;
+    if (posix_spawnattr_init(&attr) != 0)
+        return -1;
 
-    // Now that the export has been resolved, reset
-    // the error state to hide this implementation detail.
-    set_current_error(curr_error);
-    return func;
+    posix_spawn_file_actions_t actions;
+    if (posix_spawn_file_actions_init(&actions) != 0)
+    {
+        (void)posix_spawnattr_destroy(&attr);
+        return -1;
+    }
+
+    // Don't let signals sent to the client's process group reach the server and don't
+    // hold the client's standard streams open, they may be pipes read by its parent.
+    (void)posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID);
+    (void)posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    (void)posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    (void)posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+    char* argv[] = { (char*)host_path, image_path, NULL };
+    pid_t pid;
+    rc = posix_spawn(&pid, host_path, &actions, &attr, argv, environ);
+    (void)posix_spawn_file_actions_destroy(&actions);
+    (void)posix_spawnattr_destroy(&attr);
+    if (rc != 0)
+        return -1;
+
+    // The host detaches the server and exits, so the server is never left
+    // as a zombie of this process. The host is reaped automatically if
+    // SIGCHLD is ignored.
+    int status = 0;
+    while ((rc = waitpid(pid, &status, 0)) < 0 && errno == EINTR)
+        ;
+    if (rc == pid && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+        return -1;
+
+    for (int32_t waited = 0; __atomic_load_n(&segment->ready, __ATOMIC_ACQUIRE) == 0; waited += 10)
+    {
+        uint64_t server = __atomic_load_n(&segment->server, __ATOMIC_ACQUIRE);
+        if (waited >= DNNE_REMOTE_START_TIMEOUT_MS
+            || (server != 0 && !is_process_alive(server)))
+        {
+            return -1;
+        }
+
+        struct timespec timeout = { 0, 10 * 1000 * 1000 };
+        (void)futex_wait(&segment->ready, 0, &timeout);
+    }
+
+    return is_remote_server_ready(segment) ? DNNE_SUCCESS : -1;
 }
 
-void* get_fast_callable_managed_function(
-    const char_t* dotnet_type,
-    const char_t* dotnet_type_method)
+static int connect_remote_server(void)
 {
-    return get_callable_managed_function(dotnet_type, dotnet_type_method, UNMANAGEDCALLERSONLY_METHOD);
+    struct remote_segment* segment = remote_segment;
+    int fd = open_remote_segment(&segment);
+    if (fd < 0)
+        return -1;
+
+    int rc = DNNE_SUCCESS;
+    if (!is_remote_server_ready(segment))
+    {
+        // Only one client starts the server, the others wait for the lock
+        // and then find it ready.
+        while ((rc = flock(fd, LOCK_EX)) != 0 && errno == EINTR)
+            ;
+
+        if (rc == 0 && !is_remote_server_ready(segment))
+            rc = start_remote_server(segment);
+
+        (void)flock(fd, LOCK_UN);
+    }
+
+    close(fd);
+    if (is_failure(rc))
+    {
+        if (segment != remote_segment)
+            (void)munmap(segment, sizeof(*segment));
+        return rc;
+    }
+
+    init_remote_process();
+    __atomic_store_n(&remote_segment, segment, __ATOMIC_RELEASE);
+    return DNNE_SUCCESS;
+}
+
+static void prepare_remote(int* ret)
+{
+    enter_lock(&_remote_lock);
+    if (!remote_segment || !is_remote_server_ready(remote_segment))
+    {
+        int rc = connect_remote_server();
+        if (is_failure(rc))
+        {
+            exit_lock(&_remote_lock);
+            if (ret)
+            {
+                *ret = rc;
+                return;
+            }
+            noreturn_failure(failure_load_runtime, rc);
+        }
+    }
+    exit_lock(&_remote_lock);
+}
+
+static struct remote_slot* claim_remote_slot(struct remote_segment* segment)
+{
+    for (;;)
+    {
+        uint32_t start = __atomic_fetch_add(&segment->next_slot, 1, __ATOMIC_RELAXED);
+        for (uint32_t i = 0; i < DNNE_REMOTE_SLOT_COUNT; ++i)
+        {
+            struct remote_slot* slot = &segment->slots[(start + i) % DNNE_REMOTE_SLOT_COUNT];
+            uint32_t expected = remote_slot_free;
+            if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) == remote_slot_free
+                && __atomic_compare_exchange_n(&slot->state, &expected, remote_slot_claimed, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            {
+                __atomic_store_n(&slot->client, get_remote_process_token(), __ATOMIC_RELEASE);
+                return slot;
+            }
+        }
+
+        // All slots are in use. Reclaim those held by clients that exited, whether
+        // or not the server has run the request.
+        for (uint32_t i = 0; i < DNNE_REMOTE_SLOT_COUNT; ++i)
+        {
+            struct remote_slot* slot = &segment->slots[i];
+            uint32_t state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+            if (state != remote_slot_claimed && state != remote_slot_response && state != remote_slot_abandoned)
+                continue;
+
+            uint64_t client = __atomic_load_n(&slot->client, __ATOMIC_ACQUIRE);
+            if (client == 0 || is_process_alive(client))
+                continue;
+
+            // Clearing the token first means only one client reclaims the slot, and
+            // not after it was released and claimed again by another client.
+            if (__atomic_compare_exchange_n(&slot->client, &client, 0, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+                __atomic_store_n(&slot->state, remote_slot_free, __ATOMIC_RELEASE);
+        }
+
+        (void)sched_yield();
+    }
+}
+
+static void wait_remote_response(struct remote_segment* segment, struct remote_slot* slot)
+{
+    for (int32_t spin = 0; spin < remote_spin_count; ++spin)
+    {
+        if (__atomic_load_n(&slot->state, __ATOMIC_ACQUIRE) == remote_slot_response)
+            return;
+        cpu_relax();
+    }
+
+    // The server checks for a waiting client after it writes the response.
+    __atomic_store_n(&slot->client_waiting, 1, __ATOMIC_SEQ_CST);
+    for (;;)
+    {
+        uint32_t state = __atomic_load_n(&slot->state, __ATOMIC_SEQ_CST);
+        if (state == remote_slot_response)
+            return;
+
+        // The result of the export will never be available.
+        if (state == remote_slot_abandoned)
+            noreturn_failure(failure_load_runtime, -1);
+
+        // If the server exited, a new one runs the pending requests
+        // and abandons those that were running.
+        struct timespec timeout = { 1, 0 };
+        if (futex_wait(&slot->state, state, &timeout) != 0
+            && errno == ETIMEDOUT
+            && !is_process_alive(__atomic_load_n(&segment->server, __ATOMIC_ACQUIRE)))
+        {
+            prepare_remote(NULL);
+        }
+    }
+}
+
+// Called by the generated export stubs. Returns 0 if the export should run
+// in the calling process, otherwise the result has been written to the payload.
+__attribute__((visibility("hidden"))) int dnne_remote_call(uint32_t index, void* payload, size_t payload_size)
+{
+    if (remote_server)
+        return 0;
+
+    assert(payload_size <= DNNE_REMOTE_PAYLOAD_SIZE);
+
+    struct remote_segment* segment = __atomic_load_n(&remote_segment, __ATOMIC_ACQUIRE);
+    if (segment == NULL)
+    {
+        prepare_remote(NULL);
+        segment = __atomic_load_n(&remote_segment, __ATOMIC_ACQUIRE);
+    }
+
+    // Like an in-process call, the error state of the caller isn't changed.
+    int err = get_current_error();
+
+    struct remote_slot* slot = claim_remote_slot(segment);
+    memcpy(slot->payload, payload, payload_size);
+    slot->index = index;
+    slot->client_waiting = 0;
+    __atomic_store_n(&slot->state, remote_slot_request, __ATOMIC_SEQ_CST);
+
+    __atomic_add_fetch(&segment->doorbell, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&segment->sleeping_servers, __ATOMIC_SEQ_CST) != 0)
+        futex_wake(&segment->doorbell, 1);
+
+    wait_remote_response(segment, slot);
+    memcpy(payload, slot->payload, payload_size);
+    int32_t result = slot->result;
+    __atomic_store_n(&slot->client, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->state, remote_slot_free, __ATOMIC_RELEASE);
+
+    // The export threw, the caller is failed like it would be in process.
+    if (result != 0)
+        noreturn_failure(failure_remote_export, result);
+
+    set_current_error(err);
+    return 1;
+}
+
+static void remote_server_loop(struct remote_segment* segment)
+{
+    for (;;)
+    {
+        uint32_t doorbell = __atomic_load_n(&segment->doorbell, __ATOMIC_SEQ_CST);
+        bool dispatched = false;
+        for (uint32_t i = 0; i < DNNE_REMOTE_SLOT_COUNT; ++i)
+        {
+            struct remote_slot* slot = &segment->slots[i];
+            uint32_t expected = remote_slot_request;
+            if (__atomic_load_n(&slot->state, __ATOMIC_RELAXED) != remote_slot_request
+                || !__atomic_compare_exchange_n(&slot->state, &expected, remote_slot_running, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            {
+                continue;
+            }
+
+            slot->result = remote_dispatch_fptr((int32_t)slot->index, slot->payload);
+
+            __atomic_store_n(&slot->state, remote_slot_response, __ATOMIC_SEQ_CST);
+            if (__atomic_load_n(&slot->client_waiting, __ATOMIC_SEQ_CST) != 0)
+                futex_wake(&slot->state, 1);
+
+            dispatched = true;
+        }
+
+        if (dispatched)
+            continue;
+
+        for (int32_t spin = 0; spin < remote_spin_count; ++spin)
+        {
+            if (__atomic_load_n(&segment->doorbell, __ATOMIC_RELAXED) != doorbell)
+                break;
+            cpu_relax();
+        }
+
+        // A client wakes a server thread after it rings the doorbell if any are sleeping.
+        __atomic_add_fetch(&segment->sleeping_servers, 1, __ATOMIC_SEQ_CST);
+        (void)futex_wait(&segment->doorbell, doorbell, NULL);
+        __atomic_sub_fetch(&segment->sleeping_servers, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+static void* remote_server_thread(void* segment)
+{
+    remote_server_loop((struct remote_segment*)segment);
+    return NULL;
+}
+
+// Run by the dnne-remote-host executable. Only returns if the server fails to start.
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_remote_server_main(void)
+{
+    remote_server = true;
+    init_remote_process();
+
+    struct remote_segment* segment = NULL;
+    int fd = open_remote_segment(&segment);
+    if (fd < 0)
+        return -1;
+    close(fd);
+
+    // Servers are started by clients holding the segment lock, this only
+    // guards against starting one by hand.
+    if (is_remote_server_ready(segment))
+        return -1;
+
+    // Let the starting client detect the server exiting during startup.
+    __atomic_store_n(&segment->server, get_remote_process_token(), __ATOMIC_SEQ_CST);
+
+    int rc = DNNE_SUCCESS;
+    prepare_runtime(&rc);
+    if (is_failure(rc))
+        return rc;
+
+    void* func = NULL;
+    rc = resolve_platform_helper(
+        DNNE_STR("DNNE.RemoteExports, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+        DNNE_STR("Dispatch"),
+        &func);
+    if (is_failure(rc))
+        return rc;
+
+    remote_dispatch_fptr = (remote_dispatch_fn)func;
+
+    // Pending requests sent to a previous server are run by this one. Those
+    // it was running when it exited will never complete.
+    for (uint32_t i = 0; i < DNNE_REMOTE_SLOT_COUNT; ++i)
+    {
+        struct remote_slot* slot = &segment->slots[i];
+        uint32_t expected = remote_slot_running;
+        if (__atomic_compare_exchange_n(&slot->state, &expected, remote_slot_abandoned, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            futex_wake(&slot->state, 1);
+    }
+
+    segment->sleeping_servers = 0;
+    segment->abi = dnne_remote_abi;
+
+    for (int32_t i = 0; i < DNNE_REMOTE_SERVER_THREADS; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, remote_server_thread, segment) == 0)
+            (void)pthread_detach(thread);
+    }
+
+    __atomic_store_n(&segment->magic, DNNE_REMOTE_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&segment->ready, 1, __ATOMIC_RELEASE);
+    futex_wake(&segment->ready, INT_MAX);
+
+    remote_server_loop(segment);
+    return DNNE_SUCCESS;
+}
+
+#endif // DNNE_OUT_OF_PROCESS
+
+#if defined(DNNE_EAGER_BINDING) && defined(__ELF__) && defined(__GLIBC__)
+// Defined by the generated source when exports are bound eagerly.
+extern void dnne_bind_exports(void) __attribute__((weak));
+
+static void bind_exports(void)
+{
+    if (dnne_bind_exports != NULL)
+        dnne_bind_exports();
+}
+#else
+static void bind_exports(void)
+{
+}
+#endif // !DNNE_EAGER_BINDING
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE preload_runtime(void)
+{
+#ifdef DNNE_OUT_OF_PROCESS
+    // Clients only need the server, it hosts the runtime.
+    if (!remote_server)
+    {
+        prepare_remote(NULL);
+        return;
+    }
+#endif // DNNE_OUT_OF_PROCESS
+    prepare_runtime(NULL);
+    bind_exports();
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE try_preload_runtime(void)
+{
+    int ret = DNNE_SUCCESS;
+#ifdef DNNE_OUT_OF_PROCESS
+    if (!remote_server)
+    {
+        prepare_remote(&ret);
+        return ret;
+    }
+#endif // DNNE_OUT_OF_PROCESS
+    prepare_runtime(&ret);
+    if (ret == DNNE_SUCCESS)
+        bind_exports();
+    return ret;
+}
+
+//
+// Resolved export tracking
+//
+
+#ifndef DNNE_WINDOWS
+
+struct resolved_export
+{
+    struct resolved_export* next;
+    void* func;
+    const char* name;
+};
+
+static struct resolved_export* resolved_exports;
+static dnne_lock_handle _resolved_exports_lock = DNNE_LOCK_OPEN;
+
+static void record_resolved_export(const char_t* dotnet_type, const char_t* dotnet_type_method, void* func)
+{
+    // Drop the assembly qualification from the type name.
+    size_t type_len = strcspn(dotnet_type, ",");
+    size_t method_len = strlen(dotnet_type_method);
+
+    // Tracking is best effort, an allocation failure only omits the entry.
+    struct resolved_export* entry = (struct resolved_export*)malloc(sizeof(*entry) + type_len + 2 + method_len + 1);
+    if (entry == NULL)
+        return;
+
+    char* name = (char*)(entry + 1);
+    memcpy(name, dotnet_type, type_len);
+    memcpy(name + type_len, "::", 2);
+    memcpy(name + type_len + 2, dotnet_type_method, method_len + 1);
+
+    entry->func = func;
+    entry->name = name;
+
+    enter_lock(&_resolved_exports_lock);
+    entry->next = resolved_exports;
+    resolved_exports = entry;
+    exit_lock(&_resolved_exports_lock);
+}
+
+#ifdef __linux__
+
+// Defined by the generated source, in the order of the table returned by dnne_enumerate_exports().
+// Must match struct dnne_export_binding in the generated source.
+struct export_binding
+{
+    void* volatile* func;
+    int indirect;
+};
+
+DNNE_EXTERN_DATA const struct export_binding dnne_export_bindings[] __attribute__((weak, visibility("hidden")));
+
+// Offset of the first line of the runtime's perf map that hasn't been scanned.
+static off_t perf_map_scanned;
+
+// The runtime only writes its perf map when DOTNET_PerfMapEnabled is 1 (perf map and
+// jitdump) or 3 (perf map only).
+static bool is_runtime_perf_map_enabled(void)
+{
+    const char* value = getenv("DOTNET_PerfMapEnabled");
+    if (value == NULL)
+        value = getenv("COMPlus_PerfMapEnabled");
+    if (value == NULL)
+        return false;
+
+    unsigned long enabled = strtoul(value, NULL, 16);
+    return enabled == 1 || enabled == 3;
+}
+
+// The runtime doesn't open its perf map for appending, so its next write would replace
+// the lines appended after its position. Its descriptor is switched to append mode.
+static void set_perf_map_append(int fd)
+{
+    struct stat map;
+    if (fstat(fd, &map) != 0)
+        return;
+
+    DIR* dir = opendir("/proc/self/fd");
+    if (dir == NULL)
+        return;
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+        int other = atoi(entry->d_name);
+        struct stat st;
+        if (other == fd || entry->d_name[0] == '.' || fstat(other, &st) != 0 || st.st_dev != map.st_dev || st.st_ino != map.st_ino)
+            continue;
+
+        int flags = fcntl(other, F_GETFL);
+        if (flags != -1 && (flags & O_APPEND) == 0)
+            (void)fcntl(other, F_SETFL, flags | O_APPEND);
+    }
+
+    (void)closedir(dir);
+}
+
+// Append an entry naming the export for a line of the runtime's perf map that describes the
+// code of its managed method, for example
+//   '0x7f3a12345680 6a int32 [Assembly] Namespace.Type::Method(int32)[OptimizedTier1]'.
+// perf keeps the longest name of symbols at the same address, so samples are attributed to
+// '<export>[dnne] <runtime name>'.
+static void append_perf_map_entry(int fd, const char* line, size_t len)
+{
+    // Lines appended by this function are skipped.
+    const char* symbol = line;
+    for (int field = 0; field < 2 && symbol != NULL; ++field)
+    {
+        symbol = (const char*)memchr(symbol, ' ', len - (size_t)(symbol - line));
+        if (symbol != NULL)
+            ++symbol;
+    }
+
+    if (symbol == NULL || memmem(symbol, len - (size_t)(symbol - line), "[dnne] ", 7) != NULL)
+        return;
+
+    const struct dnne_export* exports;
+    size_t count = dnne_export_bindings != NULL ? dnne_enumerate_exports(&exports) : 0;
+    for (struct resolved_export* resolved = resolved_exports; resolved != NULL; resolved = resolved->next)
+    {
+        // The runtime names the method with its parameters, 'Namespace.Type::Method('.
+        size_t name_len = strlen(resolved->name);
+        const char* match = (const char*)memmem(symbol, len - (size_t)(symbol - line), resolved->name, name_len);
+        if (match == NULL || match == symbol || match[-1] != ' ' || match[name_len] != '(')
+            continue;
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (dnne_export_bindings[i].func == NULL || *dnne_export_bindings[i].func != resolved->func)
+                continue;
+
+            // A single write, so the line can't interleave with the runtime's writes.
+            char buffer[1024];
+            int written = snprintf(buffer, sizeof(buffer), "%.*s%s[dnne] %.*s\n",
+                (int)(symbol - line), line, exports[i].name, (int)(len - (size_t)(symbol - line)), symbol);
+            if (written > 0 && (size_t)written < sizeof(buffer))
+                (void)write(fd, buffer, (size_t)written);
+        }
+    }
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_write_perf_map(const char* path)
+{
+    // Only the runtime knows where the JIT compiled code of an export is and how large it is.
+    if (!is_runtime_perf_map_enabled())
+        return DNNE_E_NOTIMPL;
+
+    char default_path[DNNE_MAX_PATH];
+    if (path == NULL)
+    {
+        const char* dir = getenv("DOTNET_PerfMapJitDumpPath");
+        if (dir == NULL)
+            dir = getenv("COMPlus_PerfMapJitDumpPath");
+        (void)snprintf(default_path, DNNE_ARRAY_SIZE(default_path), "%s/perf-%ld.map", dir != NULL ? dir : "/tmp", (long)getpid());
+        path = default_path;
+    }
+
+    // The runtime creates the file when it starts.
+    int fd = open(path, O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fd < 0)
+        return -1;
+
+    set_perf_map_append(fd);
+
+    // Serializes the binaries in the process that append to the file.
+    while (flock(fd, LOCK_EX) != 0)
+    {
+        if (errno != EINTR)
+        {
+            (void)close(fd);
+            return -1;
+        }
+    }
+
+    enter_lock(&_resolved_exports_lock);
+
+    // Only complete lines written since the last call are scanned, so entries
+    // are appended once and code compiled later, at a higher tier, is added.
+    char buffer[4096];
+    size_t used = 0;
+    ssize_t len;
+    while ((len = pread(fd, buffer + used, sizeof(buffer) - used, perf_map_scanned + (off_t)used)) > 0)
+    {
+        used += (size_t)len;
+        char* start = buffer;
+        char* end;
+        while ((end = (char*)memchr(start, '\n', used - (size_t)(start - buffer))) != NULL)
+        {
+            append_perf_map_entry(fd, start, (size_t)(end - start));
+            start = end + 1;
+        }
+
+        // A line longer than the buffer is skipped.
+        size_t consumed = start != buffer ? (size_t)(start - buffer) : used == sizeof(buffer) ? used : 0;
+        perf_map_scanned += (off_t)consumed;
+        used -= consumed;
+        memmove(buffer, buffer + consumed, used);
+    }
+
+    exit_lock(&_resolved_exports_lock);
+
+    (void)flock(fd, LOCK_UN);
+    return close(fd) == 0 && len == 0 ? DNNE_SUCCESS : -1;
+}
+
+#else
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_write_perf_map(const char* path)
+{
+    // perf and bpftrace, which read the runtime's perf map, are only available on Linux.
+    (void)path;
+    return DNNE_E_NOTIMPL;
+}
+
+#endif // !__linux__
+
+#else
+
+static void record_resolved_export(const char_t* dotnet_type, const char_t* dotnet_type_method, void* func)
+{
+    (void)dotnet_type;
+    (void)dotnet_type_method;
+    (void)func;
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_write_perf_map(const char* path)
+{
+    // perf maps are not supported on Windows.
+    (void)path;
+    return DNNE_E_NOTIMPL;
+}
+
+#endif // !DNNE_WINDOWS
+
+// Resolve a managed function in a runtime that has already been prepared.
+static int resolve_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    const char_t* dotnet_delegate_type,
+    void** func)
+{
+    assert(get_managed_export_fptr != NULL);
+
+#ifdef DNNE_EMBED_ASSEMBLY
+    DNNE_SDT_PROBE2(dnne, export__resolve__start, dotnet_type, dotnet_type_method);
+    DNNE_TRACE_BEGIN(DNNE_TRACE_RESOLVE_EXPORT);
+
+    // The embedded assembly was loaded by init_dotnet().
+    *func = NULL;
+    int rc = get_managed_export_fptr(
+        dotnet_type,
+        dotnet_type_method,
+        dotnet_delegate_type,
+        NULL,
+        NULL,
+        func);
+#else
+    char_t buffer[DNNE_MAX_PATH];
+    const char_t assembly_filename[] = DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)) DNNE_STR(".dll");
+    const char_t* assembly_path = NULL;
+    int rc = get_current_dir_filepath(DNNE_ARRAY_SIZE(buffer), buffer, DNNE_ARRAY_SIZE(assembly_filename), assembly_filename, &assembly_path);
+    if (is_failure(rc))
+        return rc;
+
+    DNNE_SDT_PROBE2(dnne, export__resolve__start, dotnet_type, dotnet_type_method);
+    DNNE_TRACE_BEGIN(DNNE_TRACE_RESOLVE_EXPORT);
+
+    // Function pointer to managed function
+    *func = NULL;
+    rc = get_managed_export_fptr(
+        assembly_path,
+        dotnet_type,
+        dotnet_type_method,
+        dotnet_delegate_type,
+        NULL,
+        func);
+#endif // !DNNE_EMBED_ASSEMBLY
+
+    DNNE_TRACE_END(DNNE_TRACE_RESOLVE_EXPORT);
+    DNNE_SDT_PROBE4(dnne, export__resolve__done, dotnet_type, dotnet_type_method, *func, rc);
+
+    if (is_failure(rc))
+        return rc;
+
+    record_resolved_export(dotnet_type, dotnet_type_method, *func);
+    return DNNE_SUCCESS;
+}
+
+void* get_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    const char_t* dotnet_delegate_type)
+{
+    assert(dotnet_type && dotnet_type_method);
+
+    // Store the current error state to reset it when
+    // we exit this function. This being done because this
+    // API is an implementation detail of the export but
+    // can result in side-effects during export resolution.
+    int curr_error = get_current_error();
+
+    // Check if the runtime has already been prepared.
+    if (!get_managed_export_fptr)
+    {
+        prepare_runtime(NULL);
+        assert(get_managed_export_fptr != NULL);
+    }
+
+    void* func = NULL;
+    int rc = resolve_managed_function(dotnet_type, dotnet_type_method, dotnet_delegate_type, &func);
+    if (is_failure(rc))
+        noreturn_failure(failure_load_export, rc);
+
+    // Now that the export has been resolved, reset
+    // the error state to hide this implementation detail.
+    set_current_error(curr_error);
+    return func;
+}
+
+void* get_fast_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method)
+{
+    return get_callable_managed_function(dotnet_type, dotnet_type_method, UNMANAGEDCALLERSONLY_METHOD);
+}
+
+// Non-aborting forms of the above, used to bind exports when the binary is loaded.
+// The runtime must have already been prepared.
+int try_get_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    const char_t* dotnet_delegate_type,
+    void** func)
+{
+    assert(dotnet_type && dotnet_type_method && func);
+
+    int curr_error = get_current_error();
+    int rc = resolve_managed_function(dotnet_type, dotnet_type_method, dotnet_delegate_type, func);
+    set_current_error(curr_error);
+    return rc;
+}
+
+int try_get_fast_callable_managed_function(
+    const char_t* dotnet_type,
+    const char_t* dotnet_type_method,
+    void** func)
+{
+    return try_get_callable_managed_function(dotnet_type, dotnet_type_method, UNMANAGEDCALLERSONLY_METHOD, func);
+}
+
+// Resolve a helper generated into the assembly by dnne-analyzers.
+// Unlike exports, a missing helper is reported instead of aborting.
+static int resolve_platform_helper(const char_t* dotnet_type, const char_t* dotnet_type_method, void** func)
+{
+    return try_get_fast_callable_managed_function(dotnet_type, dotnet_type_method, func);
+}
+
+//
+// Runtime metrics
+//
+
+// The managed implementation writes the fields at fixed offsets, the first after the
+// size and reserved fields, with no padding between them.
+typedef char dnne_runtime_metrics_layout_check[
+    (offsetof(struct dnne_runtime_metrics, gc_heap_size_bytes) == 8
+        && sizeof(struct dnne_runtime_metrics) == 8 + 17 * sizeof(uint64_t)) ? 1 : -1];
+
+// Implemented by the DNNE.RuntimeMetrics type generated into the assembly.
+typedef int (DNNE_CALLTYPE* get_runtime_metrics_fn)(struct dnne_runtime_metrics* metrics);
+static get_runtime_metrics_fn volatile get_runtime_metrics_fptr;
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_get_runtime_metrics(struct dnne_runtime_metrics* metrics)
+{
+    if (metrics == NULL || metrics->size < sizeof(metrics->size))
+        return (-1);
+
+    if (get_runtime_metrics_fptr == NULL)
+    {
+        // Reading metrics shouldn't be the reason the runtime is loaded.
+        if (get_managed_export_fptr == NULL)
+            return (-1);
+
+        void* func = NULL;
+        int rc = resolve_platform_helper(
+            DNNE_STR("DNNE.RuntimeMetrics, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+            DNNE_STR("Get"),
+            &func);
+        if (is_failure(rc))
+            return rc;
+
+        get_runtime_metrics_fptr = (get_runtime_metrics_fn)func;
+    }
+
+    return get_runtime_metrics_fptr(metrics);
+}
+
+//
+// GC notifications
+//
+
+// Implemented by the DNNE.GcNotifications type generated into the assembly.
+typedef int (DNNE_CALLTYPE* register_gc_callback_fn)(dnne_gc_callback cb, void* user);
+static register_gc_callback_fn volatile register_gc_callback_fptr;
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_register_gc_callback(dnne_gc_callback cb, void* user)
+{
+    if (register_gc_callback_fptr == NULL)
+    {
+        int rc = DNNE_SUCCESS;
+        prepare_runtime(&rc);
+        if (is_failure(rc))
+            return rc;
+
+        void* func = NULL;
+        rc = resolve_platform_helper(
+            DNNE_STR("DNNE.GcNotifications, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+            DNNE_STR("Register"),
+            &func);
+        if (is_failure(rc))
+            return rc;
+
+        register_gc_callback_fptr = (register_gc_callback_fn)func;
+    }
+
+    return register_gc_callback_fptr(cb, user);
+}
+
+//
+// Thread preparation
+//
+
+// Implemented by the DNNE.CurrentThread type generated into the assembly.
+typedef int (DNNE_CALLTYPE* current_thread_fn)(void);
+static current_thread_fn volatile prepare_current_thread_fptr;
+static current_thread_fn volatile release_current_thread_fptr;
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_prepare_current_thread(void)
+{
+    if (prepare_current_thread_fptr == NULL)
+    {
+        int rc = DNNE_SUCCESS;
+        prepare_runtime(&rc);
+        if (is_failure(rc))
+            return rc;
+
+        void* prepare = NULL;
+        void* release = NULL;
+        rc = resolve_platform_helper(
+            DNNE_STR("DNNE.CurrentThread, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+            DNNE_STR("Prepare"),
+            &prepare);
+        if (is_failure(rc))
+            return rc;
+
+        rc = resolve_platform_helper(
+            DNNE_STR("DNNE.CurrentThread, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+            DNNE_STR("Release"),
+            &release);
+        if (is_failure(rc))
+            return rc;
+
+        release_current_thread_fptr = (current_thread_fn)release;
+        prepare_current_thread_fptr = (current_thread_fn)prepare;
+    }
+
+    // Entering managed code attaches the thread to the runtime.
+    // The helper then initializes the state the runtime creates lazily.
+    DNNE_TRACE_PREPARE_THREAD();
+    return prepare_current_thread_fptr();
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_release_current_thread(void)
+{
+    // No thread has been prepared, so there is nothing to release.
+    if (release_current_thread_fptr == NULL)
+        return DNNE_SUCCESS;
+
+    return release_current_thread_fptr();
+}
+
+//
+// Pure export caches
+//
+// Each pure export has a fixed size cache of entries, each entry is a sequence number,
+// an epoch, the result and the key. The sequence number is odd while the entry is written,
+// so readers never take a lock and detect an entry that changed while it was read.
+// The epoch is owned by the generated DNNE.PureCaches type. Invalidating the caches increments
+// it, and entries cached in an earlier epoch are ignored.
+//
+
+#define DNNE_PURE_ENTRY_SEQ 0
+#define DNNE_PURE_ENTRY_EPOCH 1
+#define DNNE_PURE_ENTRY_VALUE 2
+#define DNNE_PURE_ENTRY_KEY 3
+
+// Implemented by the DNNE.PureCaches type generated into the assembly.
+typedef uint64_t* (DNNE_CALLTYPE* register_pure_caches_fn)(void);
+static uint64_t* volatile pure_cache_epoch;
+static volatile long pure_cache_unavailable;
+
+static void register_pure_caches(void)
+{
+#ifdef DNNE_OUT_OF_PROCESS
+    // The managed side of the caches is in the server, results aren't cached in the caller.
+    pure_cache_unavailable = 1;
+#else
+    if (pure_cache_epoch != NULL || pure_cache_unavailable)
+        return;
+
+    // The runtime has been loaded by the call that is registering the caches.
+    void* func = NULL;
+    int rc = resolve_platform_helper(
+        DNNE_STR("DNNE.PureCaches, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+        DNNE_STR("Register"),
+        &func);
+    if (is_failure(rc))
+    {
+        pure_cache_unavailable = 1;
+        return;
+    }
+
+    pure_cache_epoch = ((register_pure_caches_fn)func)();
+#endif // !DNNE_OUT_OF_PROCESS
+}
+
+// A result is cached in one of two adjacent entries, so two keys that map to the same entry don't evict each other.
+#define DNNE_PURE_CACHE_WAYS 2
+
+static uint32_t pure_cache_index(uint32_t size, uint32_t key_count, const uint64_t* key)
+{
+    uint64_t hash = 0;
+    for (uint32_t i = 0; i < key_count; ++i)
+    {
+        hash = (hash ^ key[i]) * UINT64_C(0x9e3779b97f4a7c15);
+        hash ^= hash >> 32;
+    }
+
+    // Maps the high bits of the hash to [0, size) without a division.
+    return (uint32_t)(((hash >> 32) * size) >> 32);
+}
+
+static volatile uint64_t* pure_cache_entry(uint64_t* entries, uint32_t size, uint32_t key_count, uint32_t index, uint32_t way)
+{
+    index += way;
+    if (index >= size)
+        index -= size;
+
+    return &entries[(size_t)index * (DNNE_PURE_ENTRY_KEY + key_count)];
+}
+
+// Called by the generated pure exports.
+// Returns non-zero if a result was found. Otherwise, epoch is set to the value passed
+// to dnne_pure_cache_store() with the result, or 0 if results can't be cached yet.
+int dnne_pure_cache_lookup(uint64_t* entries, uint32_t size, uint32_t key_count, const uint64_t* key, uint64_t* value, uint64_t* epoch)
+{
+    assert(entries != NULL && size != 0 && key != NULL && value != NULL && epoch != NULL);
+
+    // The caches aren't used until they are registered. A result computed by a call
+    // that started before then may depend on data that was changed and invalidated.
+    uint64_t* current_epoch = pure_cache_epoch;
+    if (current_epoch == NULL)
+    {
+        *epoch = 0;
+        return 0;
+    }
+
+    uint64_t current = load_acquire64(current_epoch);
+    *epoch = current;
+
+    uint32_t index = pure_cache_index(size, key_count, key);
+    for (uint32_t way = 0; way < DNNE_PURE_CACHE_WAYS; ++way)
+    {
+        volatile uint64_t* entry = pure_cache_entry(entries, size, key_count, index, way);
+        uint64_t seq = load_acquire64(&entry[DNNE_PURE_ENTRY_SEQ]);
+        if ((seq & 1) != 0)
+            continue;
+
+        bool match = entry[DNNE_PURE_ENTRY_EPOCH] == current;
+        for (uint32_t i = 0; i < key_count; ++i)
+            match &= entry[DNNE_PURE_ENTRY_KEY + i] == key[i];
+
+        uint64_t result = entry[DNNE_PURE_ENTRY_VALUE];
+        acquire_fence();
+        if (match && entry[DNNE_PURE_ENTRY_SEQ] == seq)
+        {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// Called by the generated pure exports with the epoch from dnne_pure_cache_lookup().
+void dnne_pure_cache_store(uint64_t* entries, uint32_t size, uint32_t key_count, const uint64_t* key, uint64_t value, uint64_t epoch)
+{
+    assert(entries != NULL && size != 0 && key != NULL);
+
+    if (epoch == 0)
+    {
+        register_pure_caches();
+        return;
+    }
+
+    // Prefer an entry that is unused or from an earlier epoch, otherwise the first is replaced.
+    uint32_t index = pure_cache_index(size, key_count, key);
+    volatile uint64_t* entry = pure_cache_entry(entries, size, key_count, index, 0);
+    for (uint32_t way = 1; way < DNNE_PURE_CACHE_WAYS && entry[DNNE_PURE_ENTRY_EPOCH] == epoch; ++way)
+    {
+        volatile uint64_t* other = pure_cache_entry(entries, size, key_count, index, way);
+        if (other[DNNE_PURE_ENTRY_EPOCH] != epoch)
+            entry = other;
+    }
+
+    // If another thread is writing the entry, the result isn't cached. The fence keeps
+    // the writes below from becoming visible before the odd sequence number, so a reader
+    // never matches a partially written entry.
+    uint64_t seq = load_acquire64(&entry[DNNE_PURE_ENTRY_SEQ]);
+    if ((seq & 1) != 0 || !interlocked_compare_exchange64(&entry[DNNE_PURE_ENTRY_SEQ], seq, seq + 1))
+        return;
+
+    release_fence();
+
+    entry[DNNE_PURE_ENTRY_EPOCH] = epoch;
+    entry[DNNE_PURE_ENTRY_VALUE] = value;
+    for (uint32_t i = 0; i < key_count; ++i)
+        entry[DNNE_PURE_ENTRY_KEY + i] = key[i];
+
+    store_release64(&entry[DNNE_PURE_ENTRY_SEQ], seq + 2);
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_invalidate_pure_caches(void)
+{
+    // Nothing has been cached if the caches haven't been registered.
+    uint64_t* current_epoch = pure_cache_epoch;
+    if (current_epoch != NULL)
+        (void)interlocked_increment64(current_epoch);
+}
+
+//
+// Asynchronous export completions
+//
+
+// The completion may be released as soon as it is signaled, so it isn't accessed afterwards.
+static void DNNE_CALLTYPE_CDECL signal_completion_callback(struct dnne_completion* completion)
+{
+    completion->callback(completion, completion->user);
+}
+
+static void DNNE_CALLTYPE_CDECL signal_completion_event(struct dnne_completion* completion)
+{
+#ifdef DNNE_WINDOWS
+    (void)SetEvent((HANDLE)completion->event);
+#else
+    uint64_t count = 1;
+    ssize_t written;
+    do
+    {
+        written = write((int)completion->event, &count, sizeof(count));
+    } while (written < 0 && errno == EINTR);
+#endif
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_completion_init(struct dnne_completion* completion, dnne_completion_callback cb, void* user)
+{
+    assert(completion != NULL && cb != NULL);
+
+    completion->signal = &signal_completion_callback;
+    completion->callback = cb;
+    completion->user = user;
+    completion->event = 0;
+    completion->state = NULL;
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_completion_init_event(struct dnne_completion* completion, intptr_t event)
+{
+    assert(completion != NULL);
+
+    completion->signal = &signal_completion_event;
+    completion->callback = NULL;
+    completion->user = NULL;
+    completion->event = event;
+    completion->state = NULL;
+}
+
+//
+// Arena allocator
+//
+
+#define DNNE_ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define DNNE_ARENA_THREAD_CACHE_SIZE 4
+
+struct dnne_arena_chunk
+{
+    struct dnne_arena_chunk* next;
+    size_t capacity;
+};
+
+// Keep chunk payloads aligned for any fundamental type.
+#define DNNE_ARENA_CHUNK_HEADER_SIZE ((sizeof(struct dnne_arena_chunk) + 15) & ~(size_t)15)
+#define DNNE_ARENA_CHUNK_PAYLOAD(chunk) ((char*)(chunk) + DNNE_ARENA_CHUNK_HEADER_SIZE)
+
+typedef void* (DNNE_CALLTYPE_CDECL* dnne_arena_alloc_fn)(dnne_arena* arena, size_t size, size_t align);
+
+struct dnne_arena
+{
+    // Must remain the first field. The managed DNNE.Arena type
+    // generated by dnne-analyzers allocates by calling through it.
+    dnne_arena_alloc_fn alloc;
+    size_t chunk_size;
+    volatile long epoch;
+    dnne_lock_handle lock;
+    struct dnne_arena_chunk* chunks;
+    struct dnne_arena_chunk* free_chunks;
+};
+
+// Epochs are unique across all arenas. A thread's cached chunk is only used
+// if the epoch matches, so resetting an arena, or destroying it and having
+// its address reused, invalidates the caches of all threads.
+static volatile long arena_epoch_counter;
+
+struct arena_thread_cache
+{
+    dnne_arena* arena;
+    long epoch;
+    char* next;
+    char* end;
+};
+
+static DNNE_THREAD_LOCAL struct arena_thread_cache arena_caches[DNNE_ARENA_THREAD_CACHE_SIZE];
+static DNNE_THREAD_LOCAL uint32_t arena_cache_victim;
+
+static void* arena_bump(struct arena_thread_cache* cache, size_t size, size_t align)
+{
+    uintptr_t curr = ((uintptr_t)cache->next + (align - 1)) & ~(uintptr_t)(align - 1);
+    if (curr > (uintptr_t)cache->end || size > (size_t)((uintptr_t)cache->end - curr))
+        return NULL;
+
+    cache->next = (char*)(curr + size);
+    return (void*)curr;
+}
+
+static struct dnne_arena_chunk* arena_acquire_chunk(dnne_arena* arena, size_t capacity)
+{
+    struct dnne_arena_chunk* chunk = NULL;
+
+    enter_lock(&arena->lock);
+    if (capacity == arena->chunk_size && arena->free_chunks != NULL)
+    {
+        chunk = arena->free_chunks;
+        arena->free_chunks = chunk->next;
+    }
+    exit_lock(&arena->lock);
+
+    if (chunk == NULL)
+    {
+        chunk = (struct dnne_arena_chunk*)malloc(DNNE_ARENA_CHUNK_HEADER_SIZE + capacity);
+        if (chunk == NULL)
+            return NULL;
+
+        chunk->capacity = capacity;
+    }
+
+    enter_lock(&arena->lock);
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    exit_lock(&arena->lock);
+
+    return chunk;
+}
+
+static void* DNNE_CALLTYPE_CDECL arena_alloc(dnne_arena* arena, size_t size, size_t align)
+{
+    assert(arena != NULL);
+
+    if (align == 0)
+        align = sizeof(void*);
+
+    // Alignment must be a power of two.
+    if ((align & (align - 1)) != 0)
+        return NULL;
+
+    // Fast path - bump allocate from this thread's chunk.
+    long epoch = arena->epoch;
+    struct arena_thread_cache* cache = NULL;
+    for (uint32_t i = 0; i < DNNE_ARENA_THREAD_CACHE_SIZE; ++i)
+    {
+        if (arena_caches[i].arena != arena)
+            continue;
+
+        // An entry from before the arena was reset is stale and is replaced below.
+        cache = &arena_caches[i];
+        if (cache->epoch == epoch)
+        {
+            void* mem = arena_bump(cache, size, align);
+            if (mem != NULL)
+                return mem;
+        }
+        break;
+    }
+
+    if (size > SIZE_MAX - DNNE_ARENA_CHUNK_HEADER_SIZE - align)
+        return NULL;
+
+    // Requests that would not fit in a standard chunk get a dedicated one
+    // and leave this thread's current chunk in place.
+    size_t required = size + align;
+    if (required > arena->chunk_size)
+    {
+        struct dnne_arena_chunk* chunk = arena_acquire_chunk(arena, required);
+        if (chunk == NULL)
+            return NULL;
+
+        struct arena_thread_cache tmp = { arena, epoch, DNNE_ARENA_CHUNK_PAYLOAD(chunk), DNNE_ARENA_CHUNK_PAYLOAD(chunk) + required };
+        return arena_bump(&tmp, size, align);
+    }
+
+    struct dnne_arena_chunk* chunk = arena_acquire_chunk(arena, arena->chunk_size);
+    if (chunk == NULL)
+        return NULL;
+
+    // Prefer an unused entry before evicting one. Cached arenas may have been
+    // destroyed by another thread so they must never be dereferenced here.
+    if (cache == NULL)
+    {
+        for (uint32_t i = 0; i < DNNE_ARENA_THREAD_CACHE_SIZE; ++i)
+        {
+            if (arena_caches[i].arena == NULL)
+            {
+                cache = &arena_caches[i];
+                break;
+            }
+        }
+    }
+
+    if (cache == NULL)
+        cache = &arena_caches[arena_cache_victim++ % DNNE_ARENA_THREAD_CACHE_SIZE];
+
+    cache->arena = arena;
+    cache->epoch = epoch;
+    cache->next = DNNE_ARENA_CHUNK_PAYLOAD(chunk);
+    cache->end = cache->next + chunk->capacity;
+
+    void* mem = arena_bump(cache, size, align);
+    assert(mem != NULL);
+    return mem;
+}
+
+DNNE_EXTERN_C DNNE_API dnne_arena* DNNE_CALLTYPE dnne_arena_create(size_t chunk_size)
+{
+    dnne_arena* arena = (dnne_arena*)calloc(1, sizeof(dnne_arena));
+    if (arena == NULL)
+        return NULL;
+
+    arena->alloc = &arena_alloc;
+    arena->chunk_size = chunk_size != 0 ? chunk_size : DNNE_ARENA_DEFAULT_CHUNK_SIZE;
+    arena->epoch = interlocked_increment(&arena_epoch_counter);
+    arena->lock = DNNE_LOCK_OPEN;
+    return arena;
+}
+
+DNNE_EXTERN_C DNNE_API void* DNNE_CALLTYPE dnne_arena_alloc(dnne_arena* arena, size_t size, size_t align)
+{
+    return arena_alloc(arena, size, align);
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_arena_reset(dnne_arena* arena)
+{
+    assert(arena != NULL);
+
+    enter_lock(&arena->lock);
+
+    // Keep standard chunks for reuse and release dedicated ones.
+    struct dnne_arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL)
+    {
+        struct dnne_arena_chunk* next = chunk->next;
+        if (chunk->capacity == arena->chunk_size)
+        {
+            chunk->next = arena->free_chunks;
+            arena->free_chunks = chunk;
+        }
+        else
+        {
+            free(chunk);
+        }
+        chunk = next;
+    }
+
+    arena->chunks = NULL;
+    arena->epoch = interlocked_increment(&arena_epoch_counter);
+    exit_lock(&arena->lock);
+
+    // Other threads see the new epoch. This thread's entries are released now so
+    // they don't hold a slot until the arena is used again.
+    for (uint32_t i = 0; i < DNNE_ARENA_THREAD_CACHE_SIZE; ++i)
+    {
+        if (arena_caches[i].arena == arena)
+            arena_caches[i].arena = NULL;
+    }
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_arena_destroy(dnne_arena* arena)
+{
+    if (arena == NULL)
+        return;
+
+    dnne_arena_reset(arena);
+
+    struct dnne_arena_chunk* chunk = arena->free_chunks;
+    while (chunk != NULL)
+    {
+        struct dnne_arena_chunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    free(arena);
+}
+
+//
+// Command buffers
+//
+
+#define DNNE_COMMAND_BUFFER_DEFAULT_CAPACITY 256
+
+// Each recorded call is a header slot holding the opcode in the low 32 bits and the
+// number of slots that follow in the high 32 bits, then the slots written by the generated {export}_record function.
+struct dnne_command_buffer
+{
+    uint64_t* slots;
+    size_t count;
+    size_t capacity;
+};
+
+// Implemented by the DNNE.CommandBuffer type generated into the assembly.
+typedef int (DNNE_CALLTYPE* submit_commands_fn)(uint64_t* commands, intptr_t count);
+static submit_commands_fn volatile submit_commands_fptr;
+
+// Called by the generated {export}_record functions.
+// Returns the slots following the header, or NULL if the buffer could not grow.
+uint64_t* dnne_command_buffer_append(dnne_command_buffer* buffer, uint32_t opcode, uint32_t slot_count)
+{
+    assert(buffer != NULL && opcode != 0);
+
+    size_t required = buffer->count + 1 + slot_count;
+    if (required > buffer->capacity)
+    {
+        size_t capacity = buffer->capacity * 2;
+        if (capacity < required)
+            capacity = required;
+
+        uint64_t* slots = (uint64_t*)realloc(buffer->slots, capacity * sizeof(uint64_t));
+        if (slots == NULL)
+            return NULL;
+
+        buffer->slots = slots;
+        buffer->capacity = capacity;
+    }
+
+    uint64_t* header = buffer->slots + buffer->count;
+    *header = (uint64_t)opcode | ((uint64_t)slot_count << 32);
+    buffer->count = required;
+    return header + 1;
+}
+
+DNNE_EXTERN_C DNNE_API dnne_command_buffer* DNNE_CALLTYPE dnne_command_buffer_create(size_t capacity)
+{
+    dnne_command_buffer* buffer = (dnne_command_buffer*)calloc(1, sizeof(dnne_command_buffer));
+    if (buffer == NULL)
+        return NULL;
+
+    buffer->capacity = capacity != 0 ? capacity : DNNE_COMMAND_BUFFER_DEFAULT_CAPACITY;
+    buffer->slots = (uint64_t*)malloc(buffer->capacity * sizeof(uint64_t));
+    if (buffer->slots == NULL)
+    {
+        free(buffer);
+        return NULL;
+    }
+
+    return buffer;
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_command_buffer_reset(dnne_command_buffer* buffer)
+{
+    assert(buffer != NULL);
+    buffer->count = 0;
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_command_buffer_destroy(dnne_command_buffer* buffer)
+{
+    if (buffer == NULL)
+        return;
+
+    free(buffer->slots);
+    free(buffer);
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_submit(dnne_command_buffer* buffer)
+{
+    assert(buffer != NULL);
+
+    if (submit_commands_fptr == NULL)
+    {
+        int rc = DNNE_SUCCESS;
+        prepare_runtime(&rc);
+        if (is_failure(rc))
+            return rc;
+
+        void* func = NULL;
+        rc = resolve_platform_helper(
+            DNNE_STR("DNNE.CommandBuffer, ") DNNE_STR(DNNE_TOSTRING(DNNE_ASSEMBLY_NAME)),
+            DNNE_STR("Submit"),
+            &func);
+        if (is_failure(rc))
+            return rc;
+
+        submit_commands_fptr = (submit_commands_fn)func;
+    }
+
+    if (buffer->count == 0)
+        return DNNE_SUCCESS;
+
+    return submit_commands_fptr(buffer->slots, (intptr_t)buffer->count);
 }
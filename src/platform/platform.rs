@@ -29,8 +29,10 @@
 #![allow(non_upper_case_globals)]
 #![allow(non_camel_case_types)]
 
+use core::cell::{Cell, RefCell};
 use core::ffi::c_void;
-use std::sync::atomic::{AtomicPtr, Ordering};
+use std::alloc::{alloc, dealloc, Layout};
+use std::sync::atomic::{AtomicBool, AtomicPtr, AtomicU64, AtomicUsize, Ordering};
 use std::sync::Mutex;
 
 // -----------------------------------------------------------------------
@@ -56,6 +58,60 @@ pub enum FailureType {
 
 pub type FailureFn = Option<fn(FailureType, i32)>;
 
+// SIMD vector types used for Vector128<T> and Vector256<T> in export signatures.
+// The managed function receives vectors by address, so these only need to
+// match the size and alignment of the managed vectors.
+#[cfg(target_arch = "x86_64")]
+pub use core::arch::x86_64::{
+    __m128 as M128, __m128d as M128d, __m128i as M128i, __m256 as M256, __m256d as M256d,
+    __m256i as M256i,
+};
+
+#[cfg(target_arch = "x86")]
+pub use core::arch::x86::{
+    __m128 as M128, __m128d as M128d, __m128i as M128i, __m256 as M256, __m256d as M256d,
+    __m256i as M256i,
+};
+
+#[cfg(target_arch = "aarch64")]
+pub use core::arch::aarch64::{float32x4_t as M128, float64x2_t as M128d, int32x4_t as M128i};
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "x86", target_arch = "aarch64")))]
+mod simd {
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(16))]
+    pub struct M128(pub [f32; 4]);
+
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(16))]
+    pub struct M128d(pub [f64; 2]);
+
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(16))]
+    pub struct M128i(pub [i64; 2]);
+}
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "x86", target_arch = "aarch64")))]
+pub use simd::{M128, M128d, M128i};
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "x86")))]
+mod simd256 {
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(32))]
+    pub struct M256(pub [f32; 8]);
+
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(32))]
+    pub struct M256d(pub [f64; 4]);
+
+    #[derive(Clone, Copy, Debug)]
+    #[repr(C, align(32))]
+    pub struct M256i(pub [i64; 4]);
+}
+
+#[cfg(not(any(target_arch = "x86_64", target_arch = "x86")))]
+pub use simd256::{M256, M256d, M256i};
+
 // -----------------------------------------------------------------------
 // Platform character type
 //
@@ -146,6 +202,7 @@ mod sys {
         fn dlsym(handle: *mut c_void, symbol: *const u8) -> *mut c_void;
         fn dladdr(addr: *const c_void, info: *mut DlInfo) -> i32;
         fn strlen(s: *const u8) -> usize;
+        fn write(fd: i32, buf: *const c_void, count: usize) -> isize;
 
         // errno access
         #[cfg(target_os = "linux")]
@@ -207,6 +264,13 @@ mod sys {
     pub fn set_current_error(err: i32) {
         unsafe { *errno_ptr() = err; }
     }
+
+    /// Writes an 8-byte count of 1 to the file descriptor, typically from eventfd().
+    pub unsafe fn signal_event(event: isize) {
+        const EINTR: i32 = 4;
+        let count: u64 = 1;
+        while write(event as i32, &count as *const u64 as *const c_void, 8) < 0 && get_current_error() == EINTR {}
+    }
 }
 
 #[cfg(windows)]
@@ -228,6 +292,7 @@ mod sys {
         fn GetModuleFileNameW(hModule: HMODULE, lpFilename: *mut u16, nSize: DWORD) -> DWORD;
         fn GetLastError() -> DWORD;
         fn SetLastError(dwErrCode: DWORD);
+        fn SetEvent(hEvent: *mut c_void) -> BOOL;
     }
 
     pub unsafe fn load_library(path: *const u16) -> *mut c_void {
@@ -266,6 +331,11 @@ mod sys {
     pub fn set_current_error(err: i32) {
         unsafe { SetLastError(err as DWORD); }
     }
+
+    /// Sets the event HANDLE.
+    pub unsafe fn signal_event(event: isize) {
+        SetEvent(event as *mut c_void);
+    }
 }
 
 // -----------------------------------------------------------------------
@@ -510,47 +580,25 @@ pub unsafe fn try_preload_runtime() -> Result<(), i32> {
     }
 }
 
-/// Resolve a managed method via its delegate type and return a callable function pointer.
-/// Used for methods marked with `[DNNE.Export]`.
-pub unsafe fn get_callable_managed_function(
+/// Resolve a managed method in a runtime that has already been prepared.
+unsafe fn resolve_managed_function(
     dotnet_type: *const u8,
     dotnet_type_method: *const u8,
     dotnet_delegate_type: *const u8,
-) -> *mut c_void {
-    if dotnet_type.is_null() || dotnet_type_method.is_null() {
-        noreturn_failure(FailureType::LoadExport, -1);
-    }
-
-    // Save current error state — this function is an implementation detail
-    // and should not affect the caller's error state.
-    let saved_error = sys::get_current_error();
-
-    // Ensure the runtime is loaded.
-    if MANAGED_EXPORT_FPTR.load(Ordering::Acquire).is_null() {
-        let rc = prepare_runtime();
-        if is_failure(rc) {
-            noreturn_failure(FailureType::LoadExport, rc);
-        }
-    }
-
+) -> Result<*mut c_void, i32> {
     let get_managed_export: LoadAssemblyAndGetFunctionPointerFn =
         core::mem::transmute(MANAGED_EXPORT_FPTR.load(Ordering::Acquire));
 
     // Build assembly path.
     let mut path_buf = [0 as CharT; MAX_PATH];
-    let written = match sys::get_this_image_path(&mut path_buf) {
-        Ok(w) => w,
-        Err(rc) => noreturn_failure(FailureType::LoadExport, rc),
-    };
+    let written = sys::get_this_image_path(&mut path_buf)?;
 
     let mut asm_filename_buf = [0 as CharT; MAX_PATH];
     let name_len = encode_ascii(ASSEMBLY_NAME, &mut asm_filename_buf);
     encode_ascii(".dll\0", &mut asm_filename_buf[name_len..]);
     let asm_filename_total = name_len + 5;
 
-    if let Err(rc) = build_sibling_path(&mut path_buf, written, &asm_filename_buf[..asm_filename_total]) {
-        noreturn_failure(FailureType::LoadExport, rc);
-    }
+    build_sibling_path(&mut path_buf, written, &asm_filename_buf[..asm_filename_total])?;
 
     // Convert UTF-8 string arguments to CharT.
     // On Unix, CharT = u8 so this is a direct cast.
@@ -578,9 +626,40 @@ pub unsafe fn get_callable_managed_function(
     );
 
     if is_failure(rc) {
-        noreturn_failure(FailureType::LoadExport, rc);
+        return Err(rc);
     }
 
+    Ok(func)
+}
+
+/// Resolve a managed method via its delegate type and return a callable function pointer.
+/// Used for methods marked with `[DNNE.Export]`.
+pub unsafe fn get_callable_managed_function(
+    dotnet_type: *const u8,
+    dotnet_type_method: *const u8,
+    dotnet_delegate_type: *const u8,
+) -> *mut c_void {
+    if dotnet_type.is_null() || dotnet_type_method.is_null() {
+        noreturn_failure(FailureType::LoadExport, -1);
+    }
+
+    // Save current error state — this function is an implementation detail
+    // and should not affect the caller's error state.
+    let saved_error = sys::get_current_error();
+
+    // Ensure the runtime is loaded.
+    if MANAGED_EXPORT_FPTR.load(Ordering::Acquire).is_null() {
+        let rc = prepare_runtime();
+        if is_failure(rc) {
+            noreturn_failure(FailureType::LoadExport, rc);
+        }
+    }
+
+    let func = match resolve_managed_function(dotnet_type, dotnet_type_method, dotnet_delegate_type) {
+        Ok(f) => f,
+        Err(rc) => noreturn_failure(FailureType::LoadExport, rc),
+    };
+
     // Restore saved error state.
     sys::set_current_error(saved_error);
     func
@@ -598,6 +677,670 @@ pub unsafe fn get_fast_callable_managed_function(
     )
 }
 
+/// Resolve a helper generated into the assembly by dnne-analyzers.
+/// Unlike exports, a missing helper is reported instead of aborting.
+unsafe fn resolve_platform_helper(type_name: &str, method: &[u8]) -> Result<*mut c_void, i32> {
+    let saved_error = sys::get_current_error();
+    let dotnet_type = format!("DNNE.{}, {}\0", type_name, ASSEMBLY_NAME);
+    let result = resolve_managed_function(
+        dotnet_type.as_ptr(),
+        method.as_ptr(),
+        UNMANAGEDCALLERSONLY_METHOD as *const u8,
+    );
+    sys::set_current_error(saved_error);
+    result
+}
+
+// -----------------------------------------------------------------------
+// Runtime metrics
+//
+// Mirrors dnne_get_runtime_metrics() in platform.c.
+// -----------------------------------------------------------------------
+
+/// Number of GC generations reported in `RuntimeMetrics`.
+/// Generations 0, 1 and 2, followed by the large and pinned object heaps.
+pub const GC_GENERATION_COUNT: usize = 5;
+
+/// Snapshot of managed runtime metrics. See `get_runtime_metrics()`.
+/// Values that aren't available on the target framework are reported as 0.
+#[repr(C)]
+#[derive(Clone, Copy, Debug, Default)]
+pub struct RuntimeMetrics {
+    /// Size of the structure in bytes, set by `RuntimeMetrics::new()`.
+    pub size: u32,
+    /// Keeps the following fields at the same offsets on every ABI.
+    pub reserved: u32,
+    pub gc_heap_size_bytes: u64,
+    pub gc_generation_size_bytes: [u64; GC_GENERATION_COUNT],
+    pub gc_total_allocated_bytes: u64,
+    pub gc_collection_count: [u64; 3],
+    pub gc_total_pause_duration_ns: u64,
+    pub jit_compiled_method_count: u64,
+    pub jit_compiled_il_bytes: u64,
+    pub jit_compilation_time_ns: u64,
+    pub thread_pool_thread_count: u64,
+    pub thread_pool_pending_work_item_count: u64,
+    pub thread_pool_completed_work_item_count: u64,
+}
+
+impl RuntimeMetrics {
+    pub fn new() -> Self {
+        RuntimeMetrics {
+            size: core::mem::size_of::<RuntimeMetrics>() as u32,
+            ..Default::default()
+        }
+    }
+}
+
+// The managed implementation writes the fields at fixed offsets, the first after the
+// size and reserved fields, with no padding between them.
+const _: () = assert!(core::mem::size_of::<RuntimeMetrics>() == 8 + 17 * 8);
+
+type GetRuntimeMetricsFn = unsafe extern "C" fn(metrics: *mut RuntimeMetrics) -> i32;
+
+static RUNTIME_METRICS_FPTR: AtomicPtr<c_void> = AtomicPtr::new(core::ptr::null_mut());
+
+/// Get a snapshot of managed runtime metrics.
+/// The runtime isn't loaded by this function, so the metrics are only available
+/// after an export has been called or the runtime has been preloaded.
+pub unsafe fn get_runtime_metrics() -> Result<RuntimeMetrics, i32> {
+    let mut ptr = RUNTIME_METRICS_FPTR.load(Ordering::Acquire);
+    if ptr.is_null() {
+        // Reading metrics shouldn't be the reason the runtime is loaded.
+        if MANAGED_EXPORT_FPTR.load(Ordering::Acquire).is_null() {
+            return Err(-1);
+        }
+
+        ptr = resolve_platform_helper("RuntimeMetrics", b"Get\0")?;
+        RUNTIME_METRICS_FPTR.store(ptr, Ordering::Release);
+    }
+
+    let f: GetRuntimeMetricsFn = core::mem::transmute(ptr);
+    let mut metrics = RuntimeMetrics::new();
+    let rc = f(&mut metrics);
+    if is_failure(rc) {
+        Err(rc)
+    } else {
+        Ok(metrics)
+    }
+}
+
+// -----------------------------------------------------------------------
+// GC notifications
+//
+// Mirrors dnne_register_gc_callback() in platform.c.
+// -----------------------------------------------------------------------
+
+/// Kind of GC notification.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+#[repr(i32)]
+pub enum GcEventType {
+    Start = 1,
+    End = 2,
+    /// A full blocking collection is approaching, sent before it starts.
+    Approach = 3,
+}
+
+impl GcEventType {
+    /// Convert the value of `GcEvent::r#type`, `None` for a kind added by a later version.
+    pub fn from_raw(value: i32) -> Option<GcEventType> {
+        match value {
+            1 => Some(GcEventType::Start),
+            2 => Some(GcEventType::End),
+            3 => Some(GcEventType::Approach),
+            _ => None,
+        }
+    }
+}
+
+/// GC notification. See `register_gc_callback()`.
+#[repr(C)]
+#[derive(Clone, Copy, Debug)]
+pub struct GcEvent {
+    pub size: u32,
+    /// Value of `GcEventType`. Kept as an integer because it is written by managed code,
+    /// use `event_type()` to convert it.
+    pub r#type: i32,
+    /// Generation being collected.
+    pub generation: i32,
+    /// The runtime's reason for the collection.
+    pub reason: i32,
+    /// 0 for blocking, 1 for background and 2 for foreground collections.
+    pub kind: i32,
+    /// Index of the collection, matches the start and end of a collection. For an approach,
+    /// the index of the last collection, the approaching collection has a greater index.
+    pub index: u64,
+    /// Time managed code was paused for the collection. Only set when the collection ends.
+    pub pause_duration_ns: u64,
+}
+
+impl GcEvent {
+    /// Kind of notification, `None` for a kind added by a later version.
+    pub fn event_type(&self) -> Option<GcEventType> {
+        GcEventType::from_raw(self.r#type)
+    }
+}
+
+pub type GcCallback = Option<unsafe extern "C" fn(evt: *const GcEvent, user: *mut c_void)>;
+
+type RegisterGcCallbackFn = unsafe extern "C" fn(cb: GcCallback, user: *mut c_void) -> i32;
+
+static REGISTER_GC_CALLBACK_FPTR: AtomicPtr<c_void> = AtomicPtr::new(core::ptr::null_mut());
+
+/// Register a callback for the start and end of each managed GC, and the approach of a
+/// full blocking GC.
+/// The runtime is loaded if it hasn't been already. Only a single callback is registered,
+/// registering a callback replaces the previous one and `None` unregisters it.
+/// Once registering returns, the previous callback isn't running and won't be called again.
+/// The start and end are post-hoc, they are delivered asynchronously on a runtime thread and
+/// the start of a collection is usually reported after it has completed. The approach is
+/// delivered before the collection starts, only when concurrent GC is disabled.
+pub unsafe fn register_gc_callback(cb: GcCallback, user: *mut c_void) -> Result<(), i32> {
+    let mut ptr = REGISTER_GC_CALLBACK_FPTR.load(Ordering::Acquire);
+    if ptr.is_null() {
+        let rc = prepare_runtime();
+        if is_failure(rc) {
+            return Err(rc);
+        }
+
+        ptr = resolve_platform_helper("GcNotifications", b"Register\0")?;
+        REGISTER_GC_CALLBACK_FPTR.store(ptr, Ordering::Release);
+    }
+
+    let f: RegisterGcCallbackFn = core::mem::transmute(ptr);
+    let rc = f(cb, user);
+    if is_failure(rc) {
+        Err(rc)
+    } else {
+        Ok(())
+    }
+}
+
+// -----------------------------------------------------------------------
+// Thread preparation
+//
+// Mirrors dnne_prepare_current_thread() and dnne_release_current_thread() in platform.c.
+// -----------------------------------------------------------------------
+
+type CurrentThreadFn = unsafe extern "C" fn() -> i32;
+
+static PREPARE_CURRENT_THREAD_FPTR: AtomicPtr<c_void> = AtomicPtr::new(core::ptr::null_mut());
+static RELEASE_CURRENT_THREAD_FPTR: AtomicPtr<c_void> = AtomicPtr::new(core::ptr::null_mut());
+
+/// Prepare the calling thread to call exports.
+/// Call when a thread is created, for example by a thread pool, so the first export
+/// it calls doesn't pay for attaching the thread to the runtime.
+/// The runtime is loaded if it hasn't been already.
+pub unsafe fn prepare_current_thread() -> Result<(), i32> {
+    let mut ptr = PREPARE_CURRENT_THREAD_FPTR.load(Ordering::Acquire);
+    if ptr.is_null() {
+        let rc = prepare_runtime();
+        if is_failure(rc) {
+            return Err(rc);
+        }
+
+        ptr = resolve_platform_helper("CurrentThread", b"Prepare\0")?;
+        let release = resolve_platform_helper("CurrentThread", b"Release\0")?;
+        RELEASE_CURRENT_THREAD_FPTR.store(release, Ordering::Release);
+        PREPARE_CURRENT_THREAD_FPTR.store(ptr, Ordering::Release);
+    }
+
+    let f: CurrentThreadFn = core::mem::transmute(ptr);
+    let rc = f();
+    if is_failure(rc) {
+        Err(rc)
+    } else {
+        Ok(())
+    }
+}
+
+/// Release the state created by `prepare_current_thread()` that can be released early.
+/// Call before a prepared thread exits. The runtime releases the thread's managed
+/// state when the thread exits.
+pub unsafe fn release_current_thread() -> Result<(), i32> {
+    // No thread has been prepared, so there is nothing to release.
+    let ptr = RELEASE_CURRENT_THREAD_FPTR.load(Ordering::Acquire);
+    if ptr.is_null() {
+        return Ok(());
+    }
+
+    let f: CurrentThreadFn = core::mem::transmute(ptr);
+    let rc = f();
+    if is_failure(rc) {
+        Err(rc)
+    } else {
+        Ok(())
+    }
+}
+
+// -----------------------------------------------------------------------
+// Pure export caches
+//
+// Mirrors dnne_pure_cache_lookup(), dnne_pure_cache_store() and
+// dnne_invalidate_pure_caches() in platform.c.
+// -----------------------------------------------------------------------
+
+const PURE_ENTRY_SEQ: usize = 0;
+const PURE_ENTRY_EPOCH: usize = 1;
+const PURE_ENTRY_VALUE: usize = 2;
+const PURE_ENTRY_KEY: usize = 3;
+
+/// Initial value of each word of a pure export cache. Used by the generated exports.
+#[allow(clippy::declare_interior_mutable_const)]
+pub const PURE_CACHE_WORD: AtomicU64 = AtomicU64::new(0);
+
+type RegisterPureCachesFn = unsafe extern "C" fn() -> *mut AtomicU64;
+
+static PURE_CACHE_EPOCH: AtomicPtr<AtomicU64> = AtomicPtr::new(core::ptr::null_mut());
+static PURE_CACHE_UNAVAILABLE: AtomicBool = AtomicBool::new(false);
+
+unsafe fn register_pure_caches() {
+    if !PURE_CACHE_EPOCH.load(Ordering::Acquire).is_null() || PURE_CACHE_UNAVAILABLE.load(Ordering::Relaxed) {
+        return;
+    }
+
+    // The runtime has been loaded by the call that is registering the caches.
+    match resolve_platform_helper("PureCaches", b"Register\0") {
+        Ok(ptr) => {
+            let f: RegisterPureCachesFn = core::mem::transmute(ptr);
+            PURE_CACHE_EPOCH.store(f(), Ordering::Release);
+        }
+        Err(_) => PURE_CACHE_UNAVAILABLE.store(true, Ordering::Relaxed),
+    }
+}
+
+// A result is cached in one of two adjacent entries, so two keys that map to the same entry don't evict each other.
+const PURE_CACHE_WAYS: u64 = 2;
+
+fn pure_cache_entry<'a>(entries: &'a [AtomicU64], key: &[u64], way: u64) -> &'a [AtomicU64] {
+    let mut hash: u64 = 0;
+    for k in key {
+        hash = (hash ^ k).wrapping_mul(0x9e3779b97f4a7c15);
+        hash ^= hash >> 32;
+    }
+
+    // Maps the high bits of the hash to [0, size) without a division.
+    let stride = PURE_ENTRY_KEY + key.len();
+    let size = (entries.len() / stride) as u64;
+    let index = ((((hash >> 32) * size) >> 32) + way) % size;
+    let start = index as usize * stride;
+    &entries[start..start + stride]
+}
+
+/// Look up the result of a pure export. Used by the generated exports.
+/// Returns the result, or the epoch to pass to `pure_cache_store()` with the result.
+pub fn pure_cache_lookup(entries: &[AtomicU64], key: &[u64]) -> Result<u64, u64> {
+    // The caches aren't used until they are registered. A result computed by a call
+    // that started before then may depend on data that was changed and invalidated.
+    let current_epoch = PURE_CACHE_EPOCH.load(Ordering::Acquire);
+    if current_epoch.is_null() {
+        return Err(0);
+    }
+
+    let epoch = unsafe { (*current_epoch).load(Ordering::Acquire) };
+    for way in 0..PURE_CACHE_WAYS {
+        let entry = pure_cache_entry(entries, key, way);
+        let seq = entry[PURE_ENTRY_SEQ].load(Ordering::Acquire);
+        if seq & 1 != 0 {
+            continue;
+        }
+
+        let mut matched = entry[PURE_ENTRY_EPOCH].load(Ordering::Relaxed) == epoch;
+        for (i, k) in key.iter().enumerate() {
+            matched &= entry[PURE_ENTRY_KEY + i].load(Ordering::Relaxed) == *k;
+        }
+
+        let value = entry[PURE_ENTRY_VALUE].load(Ordering::Relaxed);
+        core::sync::atomic::fence(Ordering::Acquire);
+        if matched && entry[PURE_ENTRY_SEQ].load(Ordering::Relaxed) == seq {
+            return Ok(value);
+        }
+    }
+
+    Err(epoch)
+}
+
+/// Cache the result of a pure export. Used by the generated exports.
+pub unsafe fn pure_cache_store(entries: &[AtomicU64], key: &[u64], value: u64, epoch: u64) {
+    if epoch == 0 {
+        register_pure_caches();
+        return;
+    }
+
+    // Prefer an entry that is unused or from an earlier epoch, otherwise the first is replaced.
+    let mut entry = pure_cache_entry(entries, key, 0);
+    let mut way = 1;
+    while way < PURE_CACHE_WAYS && entry[PURE_ENTRY_EPOCH].load(Ordering::Relaxed) == epoch {
+        let other = pure_cache_entry(entries, key, way);
+        if other[PURE_ENTRY_EPOCH].load(Ordering::Relaxed) != epoch {
+            entry = other;
+        }
+        way += 1;
+    }
+
+    // If another thread is writing the entry, the result isn't cached.
+    let seq = entry[PURE_ENTRY_SEQ].load(Ordering::Acquire);
+    if seq & 1 != 0
+        || entry[PURE_ENTRY_SEQ]
+            .compare_exchange(seq, seq + 1, Ordering::Acquire, Ordering::Relaxed)
+            .is_err()
+    {
+        return;
+    }
+
+    // Readers must see the sequence number change before any of the writes below.
+    core::sync::atomic::fence(Ordering::Release);
+
+    entry[PURE_ENTRY_EPOCH].store(epoch, Ordering::Relaxed);
+    entry[PURE_ENTRY_VALUE].store(value, Ordering::Relaxed);
+    for (i, k) in key.iter().enumerate() {
+        entry[PURE_ENTRY_KEY + i].store(*k, Ordering::Relaxed);
+    }
+
+    entry[PURE_ENTRY_SEQ].store(seq + 2, Ordering::Release);
+}
+
+/// Invalidate the results cached by exports marked with `DNNE.PureAttribute`.
+/// Calls that begin afterwards don't return an earlier result.
+pub fn invalidate_pure_caches() {
+    // Nothing has been cached if the caches haven't been registered.
+    let current_epoch = PURE_CACHE_EPOCH.load(Ordering::Acquire);
+    if !current_epoch.is_null() {
+        unsafe { (*current_epoch).fetch_add(1, Ordering::SeqCst) };
+    }
+}
+
+// -----------------------------------------------------------------------
+// Asynchronous export completions
+//
+// Mirrors dnne_completion_init() and dnne_completion_init_event() in platform.c.
+// -----------------------------------------------------------------------
+
+pub type CompletionCallback = unsafe extern "C" fn(completion: *mut Completion, user: *mut c_void);
+
+type CompletionSignalFn = unsafe extern "C" fn(completion: *mut Completion);
+
+/// Completion of an asynchronous export, see `DNNE.AsyncExportAttribute`.
+///
+/// Initialize with `completion_init()` or `completion_init_event()` and pass to the
+/// `{export}_begin` function. It must remain valid until the result is collected with
+/// the `{export}_end` function, which must only be called once the completion has been signaled.
+#[repr(C)]
+pub struct Completion {
+    // Must remain the first field. The managed export signals completion by calling through it.
+    signal: CompletionSignalFn,
+    callback: Option<CompletionCallback>,
+    user: *mut c_void,
+    event: isize,
+    state: *mut c_void,
+}
+
+// The completion may be released as soon as it is signaled, so it isn't accessed afterwards.
+unsafe extern "C" fn signal_completion_callback(completion: *mut Completion) {
+    let c = &*completion;
+    if let Some(cb) = c.callback {
+        cb(completion, c.user);
+    }
+}
+
+unsafe extern "C" fn signal_completion_event(completion: *mut Completion) {
+    sys::signal_event((*completion).event);
+}
+
+/// Initialize a completion that calls `cb` when an asynchronous export completes.
+/// The callback is called on the thread that completes the managed operation, or on the
+/// calling thread before the `{export}_begin` function returns if it completes synchronously.
+pub fn completion_init(cb: CompletionCallback, user: *mut c_void) -> Completion {
+    Completion {
+        signal: signal_completion_callback,
+        callback: Some(cb),
+        user,
+        event: 0,
+        state: core::ptr::null_mut(),
+    }
+}
+
+/// Initialize a completion that signals an event when an asynchronous export completes.
+/// On Windows, `event` is an event HANDLE that is set. Otherwise, `event` is a file descriptor,
+/// typically from eventfd(), that an 8-byte count of 1 is written to.
+pub fn completion_init_event(event: isize) -> Completion {
+    Completion {
+        signal: signal_completion_event,
+        callback: None,
+        user: core::ptr::null_mut(),
+        event,
+        state: core::ptr::null_mut(),
+    }
+}
+
+// -----------------------------------------------------------------------
+// Arena allocator
+//
+// Mirrors the arena in platform.c. Each thread bump allocates from its own
+// chunk and only takes the arena lock to acquire a new one.
+// -----------------------------------------------------------------------
+
+const ARENA_DEFAULT_CHUNK_SIZE: usize = 64 * 1024;
+const ARENA_CHUNK_ALIGN: usize = 16;
+const ARENA_THREAD_CACHE_SIZE: usize = 4;
+
+type ArenaAllocFn = unsafe extern "C" fn(arena: *mut Arena, size: usize, align: usize) -> *mut c_void;
+
+/// Arena used to return variable-sized results from exports.
+///
+/// Create with `arena_create()` and pass to exports as `*mut Arena`.
+#[repr(C)]
+pub struct Arena {
+    // Must remain the first field. The managed DNNE.Arena type
+    // generated by dnne-analyzers allocates by calling through it.
+    alloc: ArenaAllocFn,
+    chunk_size: usize,
+    epoch: AtomicUsize,
+    chunks: Mutex<ArenaChunks>,
+}
+
+#[derive(Default)]
+struct ArenaChunks {
+    used: Vec<(*mut u8, usize)>,
+    free: Vec<*mut u8>,
+}
+
+// Epochs are unique across all arenas. A thread's cached chunk is only used
+// if the epoch matches, so resetting an arena, or destroying it and having
+// its address reused, invalidates the caches of all threads.
+static ARENA_EPOCH: AtomicUsize = AtomicUsize::new(1);
+
+#[derive(Clone, Copy)]
+struct ArenaThreadCache {
+    arena: *const Arena,
+    epoch: usize,
+    next: usize,
+    end: usize,
+}
+
+const EMPTY_ARENA_CACHE: ArenaThreadCache = ArenaThreadCache {
+    arena: core::ptr::null(),
+    epoch: 0,
+    next: 0,
+    end: 0,
+};
+
+thread_local! {
+    static ARENA_CACHES: RefCell<[ArenaThreadCache; ARENA_THREAD_CACHE_SIZE]> =
+        const { RefCell::new([EMPTY_ARENA_CACHE; ARENA_THREAD_CACHE_SIZE]) };
+    static ARENA_CACHE_VICTIM: Cell<usize> = const { Cell::new(0) };
+}
+
+fn arena_bump(cache: &mut ArenaThreadCache, size: usize, align: usize) -> *mut c_void {
+    let curr = match cache.next.checked_add(align - 1) {
+        Some(v) => v & !(align - 1),
+        None => return core::ptr::null_mut(),
+    };
+    if curr > cache.end || size > cache.end - curr {
+        return core::ptr::null_mut();
+    }
+    cache.next = curr + size;
+    curr as *mut c_void
+}
+
+fn arena_acquire_chunk(arena: &Arena, capacity: usize) -> *mut u8 {
+    let mut chunks = arena.chunks.lock().unwrap_or_else(|e| e.into_inner());
+    let reused = if capacity == arena.chunk_size { chunks.free.pop() } else { None };
+    let chunk = match reused {
+        Some(c) => c,
+        None => match Layout::from_size_align(capacity, ARENA_CHUNK_ALIGN) {
+            Ok(layout) => unsafe { alloc(layout) },
+            Err(_) => core::ptr::null_mut(),
+        },
+    };
+    if !chunk.is_null() {
+        chunks.used.push((chunk, capacity));
+    }
+    chunk
+}
+
+unsafe extern "C" fn arena_alloc_impl(arena: *mut Arena, size: usize, align: usize) -> *mut c_void {
+    let arena = &*arena;
+    let align = if align == 0 { core::mem::size_of::<usize>() } else { align };
+    if !align.is_power_of_two() {
+        return core::ptr::null_mut();
+    }
+
+    // Fast path - bump allocate from this thread's chunk.
+    let epoch = arena.epoch.load(Ordering::Acquire);
+    ARENA_CACHES.with_borrow_mut(|caches| {
+        let mut slot = None;
+        for (i, c) in caches.iter_mut().enumerate() {
+            if !core::ptr::eq(c.arena, arena) {
+                continue;
+            }
+
+            // An entry from before the arena was reset is stale and is replaced below.
+            slot = Some(i);
+            if c.epoch == epoch {
+                let mem = arena_bump(c, size, align);
+                if !mem.is_null() {
+                    return mem;
+                }
+            }
+            break;
+        }
+
+        let required = match size.checked_add(align) {
+            Some(r) => r,
+            None => return core::ptr::null_mut(),
+        };
+
+        // Requests that would not fit in a standard chunk get a dedicated one
+        // and leave this thread's current chunk in place.
+        if required > arena.chunk_size {
+            let chunk = arena_acquire_chunk(arena, required);
+            if chunk.is_null() {
+                return core::ptr::null_mut();
+            }
+            let mut tmp = ArenaThreadCache {
+                arena,
+                epoch,
+                next: chunk as usize,
+                end: chunk as usize + required,
+            };
+            return arena_bump(&mut tmp, size, align);
+        }
+
+        let chunk = arena_acquire_chunk(arena, arena.chunk_size);
+        if chunk.is_null() {
+            return core::ptr::null_mut();
+        }
+
+        // Prefer an unused entry before evicting one. Cached arenas may have been
+        // destroyed by another thread so they must never be dereferenced here.
+        if slot.is_none() {
+            slot = caches.iter().position(|c| c.arena.is_null());
+        }
+        let i = slot.unwrap_or_else(|| {
+            ARENA_CACHE_VICTIM.with(|v| {
+                let victim = v.get();
+                v.set(victim.wrapping_add(1));
+                victim % ARENA_THREAD_CACHE_SIZE
+            })
+        });
+
+        caches[i] = ArenaThreadCache {
+            arena,
+            epoch,
+            next: chunk as usize,
+            end: chunk as usize + arena.chunk_size,
+        };
+        arena_bump(&mut caches[i], size, align)
+    })
+}
+
+/// Create an arena for returning variable-sized results from exports.
+/// Memory is handed out from chunks of at least `chunk_size` bytes. A `chunk_size`
+/// of 0 selects the default.
+pub fn arena_create(chunk_size: usize) -> *mut Arena {
+    let arena = Box::new(Arena {
+        alloc: arena_alloc_impl,
+        chunk_size: if chunk_size != 0 { chunk_size } else { ARENA_DEFAULT_CHUNK_SIZE },
+        epoch: AtomicUsize::new(ARENA_EPOCH.fetch_add(1, Ordering::AcqRel)),
+        chunks: Mutex::new(ArenaChunks::default()),
+    });
+    Box::into_raw(arena)
+}
+
+/// Allocate `size` bytes from the arena with the supplied alignment.
+/// The alignment must be a power of two; 0 selects pointer alignment.
+/// Returns null if memory could not be allocated.
+pub unsafe fn arena_alloc(arena: *mut Arena, size: usize, align: usize) -> *mut c_void {
+    arena_alloc_impl(arena, size, align)
+}
+
+/// Release all allocations made from the arena in a single operation.
+/// Must not be called concurrently with any other use of the arena.
+pub unsafe fn arena_reset(arena: *mut Arena) {
+    let arena = &*arena;
+    let mut chunks = arena.chunks.lock().unwrap_or_else(|e| e.into_inner());
+    let ArenaChunks { used, free } = &mut *chunks;
+
+    // Keep standard chunks for reuse and release dedicated ones.
+    for (chunk, capacity) in used.drain(..) {
+        if capacity == arena.chunk_size {
+            free.push(chunk);
+        } else {
+            dealloc(chunk, Layout::from_size_align_unchecked(capacity, ARENA_CHUNK_ALIGN));
+        }
+    }
+
+    arena.epoch.store(ARENA_EPOCH.fetch_add(1, Ordering::AcqRel), Ordering::Release);
+    drop(chunks);
+
+    // Other threads see the new epoch. This thread's entries are released now so
+    // they don't hold a slot until the arena is used again.
+    let arena: *const Arena = arena;
+    let _ = ARENA_CACHES.try_with(|c| {
+        for cache in c.borrow_mut().iter_mut() {
+            if core::ptr::eq(cache.arena, arena) {
+                *cache = EMPTY_ARENA_CACHE;
+            }
+        }
+    });
+}
+
+/// Release the arena and all of its memory.
+/// Must not be called concurrently with any other use of the arena.
+pub unsafe fn arena_destroy(arena: *mut Arena) {
+    if arena.is_null() {
+        return;
+    }
+
+    arena_reset(arena);
+    let arena = Box::from_raw(arena);
+    let chunks = arena.chunks.into_inner().unwrap_or_else(|e| e.into_inner());
+    for chunk in chunks.free {
+        dealloc(chunk, Layout::from_size_align_unchecked(arena.chunk_size, ARENA_CHUNK_ALIGN));
+    }
+}
+
 // -----------------------------------------------------------------------
 // String conversion helpers
 // -----------------------------------------------------------------------
@@ -248,3 +248,67 @@ void* get_fast_callable_managed_function(
 {
     noreturn_failure(failure_load_export, E_NOTIMPL);
 }
+
+// The arena API is only supported on .NET (Core). The managed
+// counterpart relies on unmanaged function pointers.
+DNNE_EXTERN_C DNNE_API dnne_arena* DNNE_CALLTYPE dnne_arena_create(size_t)
+{
+    return nullptr;
+}
+
+DNNE_EXTERN_C DNNE_API void* DNNE_CALLTYPE dnne_arena_alloc(dnne_arena*, size_t, size_t)
+{
+    return nullptr;
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_arena_reset(dnne_arena*)
+{
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_arena_destroy(dnne_arena*)
+{
+}
+
+// perf maps are not supported on Windows.
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_write_perf_map(const char*)
+{
+    return E_NOTIMPL;
+}
+
+// Runtime metrics are only supported on .NET (Core).
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_get_runtime_metrics(struct dnne_runtime_metrics*)
+{
+    return E_NOTIMPL;
+}
+
+// GC notifications are only supported on .NET (Core).
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_register_gc_callback(dnne_gc_callback, void*)
+{
+    return E_NOTIMPL;
+}
+
+// Thread preparation is only supported on .NET (Core).
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_prepare_current_thread(void)
+{
+    return E_NOTIMPL;
+}
+
+DNNE_EXTERN_C DNNE_API int DNNE_CALLTYPE dnne_release_current_thread(void)
+{
+    return E_NOTIMPL;
+}
+
+// Results of pure exports are only cached on .NET (Core).
+DNNE_EXTERN_C int dnne_pure_cache_lookup(uint64_t*, uint32_t, uint32_t, const uint64_t*, uint64_t*, uint64_t* epoch)
+{
+    *epoch = 0;
+    return 0;
+}
+
+DNNE_EXTERN_C void dnne_pure_cache_store(uint64_t*, uint32_t, uint32_t, const uint64_t*, uint64_t, uint64_t)
+{
+}
+
+DNNE_EXTERN_C DNNE_API void DNNE_CALLTYPE dnne_invalidate_pure_caches(void)
+{
+}
@@ -0,0 +1,172 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Measures the per-call cost of DNNE exports.
+//
+// Run against a binary built with lazy binding (the default) and one built
+// with 'DnneEagerBinding' to compare the two stubs. The runtime is preloaded
+// before the exports are resolved, which is when eager binding resolves every
+// export, so the time to load the binary, preload the runtime and make the first
+// call is also reported. RemoteAdd is an ordinary export unless the binary is
+// built with 'DnneOutOfProcess', then it reports the round trip to the server.
+// See the readme for details.
+//
+// Usage: CallBenchmark <export_binary> [calls_per_round]
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <dnne.h>
+
+#ifdef _WIN32
+#include <Windows.h>
+
+static void* load_library(const char* path)
+{
+    HMODULE h = LoadLibraryA(path);
+    return (void*)h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = GetProcAddress((HMODULE)h, name);
+    return f;
+}
+static double now_ns(void)
+{
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart * 1e9 / (double)freq.QuadPart;
+}
+
+#else
+#include <dlfcn.h>
+#include <time.h>
+
+static void* load_library(const char* path)
+{
+    void* h = dlopen(path, RTLD_LAZY | RTLD_LOCAL);
+    return h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = dlsym(h, name);
+    return f;
+}
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+#endif
+
+typedef int (DNNE_CALLTYPE* IntIntInt_t)(int, int);
+typedef void (DNNE_CALLTYPE* preload_runtime_t)(void);
+
+#define ROUNDS 15
+
+static int compare_double(const void* a, const void* b)
+{
+    double l = *(const double*)a;
+    double r = *(const double*)b;
+    return (l > r) - (l < r);
+}
+
+// Report the median time per call over a number of rounds.
+static void measure(const char* name, IntIntInt_t fptr, int calls)
+{
+    double per_call[ROUNDS];
+    volatile int sink = 0;
+    for (int r = 0; r < ROUNDS; ++r)
+    {
+        double start = now_ns();
+        for (int i = 0; i < calls; ++i)
+            sink += fptr(i, 1);
+
+        per_call[r] = (now_ns() - start) / calls;
+    }
+
+    (void)sink;
+    qsort(per_call, ROUNDS, sizeof(double), compare_double);
+    printf("%-20s min %8.2f  median %8.2f  max %8.2f\n", name, per_call[0], per_call[ROUNDS / 2], per_call[ROUNDS - 1]);
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2 || ac > 3)
+    {
+        printf("Usage: %s <export_binary> [calls_per_round]\n", av[0]);
+        return EXIT_FAILURE;
+    }
+
+    int calls = (ac == 3) ? atoi(av[2]) : 1000000;
+    if (calls <= 0)
+    {
+        printf("Calls per round must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    double start = now_ns();
+    void* mod = load_library(av[1]);
+    if (mod == NULL)
+    {
+        printf("Failed to load library\n");
+        return EXIT_FAILURE;
+    }
+
+    double loaded = now_ns();
+    preload_runtime_t preload = (preload_runtime_t)get_export(mod, "preload_runtime");
+    if (preload == NULL)
+    {
+        printf("Failed to get preload_runtime export\n");
+        return EXIT_FAILURE;
+    }
+
+    preload();
+    double preloaded = now_ns();
+
+    IntIntInt_t fast = (IntIntInt_t)get_export(mod, "UnmanagedIntIntInt");
+    IntIntInt_t marshalled = (IntIntInt_t)get_export(mod, "IntIntInt");
+    IntIntInt_t remote = (IntIntInt_t)get_export(mod, "RemoteAdd");
+    if (fast == NULL || marshalled == NULL || remote == NULL)
+    {
+        printf("Failed to get exports\n");
+        return EXIT_FAILURE;
+    }
+
+    double resolved = now_ns();
+    (void)fast(3, 5);
+    double called = now_ns();
+
+    printf("%s (%d calls per round, %d rounds)\n", av[1], calls, ROUNDS);
+    printf("Time in microseconds\n");
+    printf("%-20s %12.1f\n", "Load binary", (loaded - start) / 1e3);
+    printf("%-20s %12.1f\n", "Preload runtime", (preloaded - loaded) / 1e3);
+    printf("%-20s %12.1f\n", "First call", (called - resolved) / 1e3);
+    printf("Time per call in nanoseconds\n");
+    measure("UnmanagedIntIntInt", fast, calls);
+    measure("IntIntInt", marshalled, calls);
+    measure("RemoteAdd", remote, calls);
+    return EXIT_SUCCESS;
+}
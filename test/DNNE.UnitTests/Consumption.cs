@@ -18,11 +18,15 @@
 // SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Linq;
 using System.Reflection;
+using System.Runtime;
 using System.Runtime.CompilerServices;
 using System.Runtime.InteropServices;
+using System.Text.Json;
+using System.Threading;
 using Xunit;
 
 namespace DNNE.UnitTests
@@ -96,6 +100,56 @@ namespace DNNE.UnitTests
             ExportingAssembly.InstanceExports.MyClass_dtor(inst);
         }
 
+        [Fact]
+        public void HandleExports()
+        {
+            var first = ExportingAssembly.HandleExports.Counter_create(10);
+            Assert.NotEqual(0ul, first.Opaque);
+            Assert.Equal(15, ExportingAssembly.HandleExports.Counter_add(first, 5));
+            Assert.Equal(1, ExportingAssembly.HandleExports.Counter_isValid(first));
+
+            // A freed handle isn't resolved, even once its slot is reused.
+            ExportingAssembly.HandleExports.Counter_destroy(first);
+            Assert.Equal(0, ExportingAssembly.HandleExports.Counter_isValid(first));
+
+            var second = ExportingAssembly.HandleExports.Counter_create(20);
+            Assert.NotEqual(first.Opaque, second.Opaque);
+            Assert.Equal(0, ExportingAssembly.HandleExports.Counter_isValid(first));
+            Assert.Equal(21, ExportingAssembly.HandleExports.Counter_add(second, 1));
+            ExportingAssembly.HandleExports.Counter_destroy(second);
+
+            Assert.Equal(0, ExportingAssembly.HandleExports.Counter_isValid(default));
+        }
+
+        [Fact]
+        public void HandleExportsThreadExit()
+        {
+            // The slot freed by a thread that has exited is reused by another thread.
+            ExportingAssembly.HandleExports.Counter_handle freed = default;
+            RunOnNewThread(() =>
+            {
+                freed = ExportingAssembly.HandleExports.Counter_create(1);
+                ExportingAssembly.HandleExports.Counter_destroy(freed);
+            });
+
+            GC.Collect();
+            GC.WaitForPendingFinalizers();
+
+            ExportingAssembly.HandleExports.Counter_handle reused = default;
+            RunOnNewThread(() => reused = ExportingAssembly.HandleExports.Counter_create(2));
+            Assert.Equal((uint)freed.Opaque, (uint)reused.Opaque);
+            Assert.NotEqual(freed.Opaque, reused.Opaque);
+            Assert.Equal(0, ExportingAssembly.HandleExports.Counter_isValid(freed));
+            ExportingAssembly.HandleExports.Counter_destroy(reused);
+
+            static void RunOnNewThread(ThreadStart start)
+            {
+                var thread = new Thread(start);
+                thread.Start();
+                thread.Join();
+            }
+        }
+
         [Fact]
         public void IntExports()
         {
@@ -108,6 +162,7 @@ namespace DNNE.UnitTests
             ExportingAssembly.IntExports.IntVoid(33);
             ExportingAssembly.IntExports.UnmanagedIntVoid(33);
             ExportingAssembly.IntExports.UnmanagedIntVoidCdecl(33);
+            Assert.Equal(3 * 4, ExportingAssembly.IntExports.MarshalAsIntInt(4));
         }
 
         [Fact]
@@ -253,5 +308,491 @@ namespace DNNE.UnitTests
             ExportingAssembly.NestedClassExports.Nested2_VoidVoid();
             ExportingAssembly.NestedClassExports.Nested2_UnmanagedVoidVoid();
         }
+
+        [Fact]
+        public unsafe void ArenaExports()
+        {
+            IntPtr arena = ExportingAssembly.ArenaExports.dnne_arena_create(0);
+            Assert.True(arena != IntPtr.Zero);
+
+            int count;
+            byte** parts = ExportingAssembly.ArenaExports.ArenaSplitString(arena, "DNNE,.Net,Native Exports", &count);
+            Assert.Equal(3, count);
+            Assert.Equal("DNNE", Marshal.PtrToStringUTF8((IntPtr)parts[0]));
+            Assert.Equal(".Net", Marshal.PtrToStringUTF8((IntPtr)parts[1]));
+            Assert.Equal("Native Exports", Marshal.PtrToStringUTF8((IntPtr)parts[2]));
+
+            // Allocations larger than a chunk are satisfied directly.
+            void* large = ExportingAssembly.ArenaExports.dnne_arena_alloc(arena, 1024 * 1024, 64);
+            Assert.True(large != null);
+            Assert.Equal(0, (int)((nuint)large % 64));
+
+            // After a reset, allocation restarts at the beginning of a reused chunk.
+            ExportingAssembly.ArenaExports.dnne_arena_reset(arena);
+            void* first = ExportingAssembly.ArenaExports.dnne_arena_alloc(arena, 16, 16);
+            ExportingAssembly.ArenaExports.dnne_arena_alloc(arena, 16, 16);
+            ExportingAssembly.ArenaExports.dnne_arena_reset(arena);
+            Assert.True(first == ExportingAssembly.ArenaExports.dnne_arena_alloc(arena, 16, 16));
+
+            ExportingAssembly.ArenaExports.dnne_arena_reset(arena);
+
+            parts = ExportingAssembly.ArenaExports.ArenaSplitString(arena, "DNNE", &count);
+            Assert.Equal(1, count);
+            Assert.Equal("DNNE", Marshal.PtrToStringUTF8((IntPtr)parts[0]));
+
+            ExportingAssembly.ArenaExports.dnne_arena_destroy(arena);
+        }
+
+        [Fact]
+        public void PerfMap()
+        {
+            // Ensure at least one export has been resolved.
+            Assert.Equal(9, ExportingAssembly.IntExports.IntInt(3));
+
+            // The entries are added to the runtime's perf map, which is only written when DOTNET_PerfMapEnabled is set.
+            int rc = ExportingAssembly.PerfMap.dnne_write_perf_map(null);
+            if (!RuntimeInformation.IsOSPlatform(OSPlatform.Linux)
+                || Environment.GetEnvironmentVariable("DOTNET_PerfMapEnabled") is not ("1" or "3"))
+            {
+                Assert.Equal(ExportingAssembly.PerfMap.DNNE_E_NOTIMPL, rc);
+                return;
+            }
+
+            Assert.Equal(0, rc);
+            string path = $"/tmp/perf-{Environment.ProcessId}.map";
+            string[] entries = ReadEntries(path);
+
+            // The JIT compiled code of the export is described, not only its entry point.
+            Assert.Contains(entries, l => l.Split(' ')[2] == "IntInt[dnne]" && Convert.ToUInt64(l.Split(' ')[1], 16) > 1);
+
+            // Entries are only added once.
+            Assert.Equal(0, ExportingAssembly.PerfMap.dnne_write_perf_map(null));
+            Assert.Equal(entries.Length, ReadEntries(path).Length);
+
+            static string[] ReadEntries(string path)
+            {
+                // The runtime keeps the file open for writing.
+                using var stream = new FileStream(path, FileMode.Open, FileAccess.Read, FileShare.ReadWrite);
+                using var reader = new StreamReader(stream);
+                return reader.ReadToEnd().Split('\n').Where(l => l.Contains("[dnne] ")).ToArray();
+            }
+        }
+
+        [Fact]
+        public void Tracing()
+        {
+            Assert.Equal(9, ExportingAssembly.IntExports.IntInt(3));
+
+            string path = Path.GetTempFileName();
+            try
+            {
+                // Tracing is only enabled in the DnneEnableTracing test configuration, and isn't supported on Windows.
+                int rc = ExportingAssembly.Tracing.dnne_trace_dump(path);
+                if (rc == ExportingAssembly.Tracing.DNNE_E_NOTIMPL)
+                {
+                    return;
+                }
+
+                Assert.Equal(0, rc);
+                using JsonDocument trace = JsonDocument.Parse(File.ReadAllText(path));
+                JsonElement[] events = trace.RootElement.GetProperty("traceEvents").EnumerateArray()
+                    .Where(e => e.GetProperty("name").GetString() == "IntInt")
+                    .ToArray();
+
+                // Each call is recorded on entry and on return.
+                Assert.Contains(events, e => e.GetProperty("ph").GetString() == "B");
+                Assert.Contains(events, e => e.GetProperty("ph").GetString() == "E");
+                Assert.All(events, e => Assert.Equal("export", e.GetProperty("cat").GetString()));
+            }
+            finally
+            {
+                File.Delete(path);
+            }
+        }
+
+        [Fact]
+        public unsafe void RuntimeMetrics()
+        {
+            // Ensure the runtime has been loaded.
+            Assert.Equal(9, ExportingAssembly.IntExports.IntInt(3));
+
+            // The layout doesn't depend on the alignment of 64-bit integers.
+            Assert.Equal(8, (int)Marshal.OffsetOf<ExportingAssembly.RuntimeMetrics.dnne_runtime_metrics>("gc_heap_size_bytes"));
+            Assert.Equal(144, sizeof(ExportingAssembly.RuntimeMetrics.dnne_runtime_metrics));
+
+            var metrics = new ExportingAssembly.RuntimeMetrics.dnne_runtime_metrics();
+            metrics.size = (uint)sizeof(ExportingAssembly.RuntimeMetrics.dnne_runtime_metrics);
+            Assert.Equal(0, ExportingAssembly.RuntimeMetrics.dnne_get_runtime_metrics(ref metrics));
+            Assert.True(metrics.gc_total_allocated_bytes > 0);
+            Assert.True(metrics.jit_compiled_method_count > 0);
+
+            // Fields beyond the supplied size aren't written.
+            var partial = new ExportingAssembly.RuntimeMetrics.dnne_runtime_metrics();
+            partial.size = 16;
+            partial.gc_heap_size_bytes = ulong.MaxValue;
+            partial.gc_total_allocated_bytes = ulong.MaxValue;
+            Assert.Equal(0, ExportingAssembly.RuntimeMetrics.dnne_get_runtime_metrics(ref partial));
+            Assert.NotEqual(ulong.MaxValue, partial.gc_heap_size_bytes);
+            Assert.Equal(ulong.MaxValue, partial.gc_total_allocated_bytes);
+        }
+
+        [Fact]
+        public unsafe void GenericExports()
+        {
+            float[] af = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17 };
+            double[] ad = Array.ConvertAll(af, v => (double)v);
+            int[] ai = Array.ConvertAll(af, v => (int)v);
+            long[] al = Array.ConvertAll(af, v => (long)v);
+
+            // Sum of squares from 1 to 17
+            const int expected = 1785;
+            fixed (float* pf = af)
+            fixed (double* pd = ad)
+            fixed (int* pi = ai)
+            fixed (long* pl = al)
+            {
+                Assert.Equal(expected, ExportingAssembly.GenericExports.dot_f32(pf, pf, af.Length));
+                Assert.Equal(expected, ExportingAssembly.GenericExports.dot_f64(pd, pd, ad.Length));
+                Assert.Equal(expected, ExportingAssembly.GenericExports.Dot_Int32(pi, pi, ai.Length));
+                Assert.Equal(expected, ExportingAssembly.GenericExports.Dot_Int64(pl, pl, al.Length));
+            }
+
+            long result;
+            ExportingAssembly.GenericExports.WidenAdd(int.MaxValue, int.MaxValue, &result);
+            Assert.Equal(2L * int.MaxValue, result);
+        }
+
+        private static long s_gcStarts;
+        private static long s_gcEnds;
+        private static long s_gcUser;
+        private static long s_gcEvents;
+
+        [UnmanagedCallersOnly]
+        private static unsafe void OnGcEvent(ExportingAssembly.GcNotifications.dnne_gc_event* evt, IntPtr user)
+        {
+            Interlocked.Increment(ref s_gcEvents);
+
+            // Only gen2 collections are forced by the test.
+            if (evt->generation != 2)
+                return;
+
+            Interlocked.Exchange(ref s_gcUser, (long)user);
+            if (evt->type == 1)
+            {
+                Interlocked.Increment(ref s_gcStarts);
+            }
+            else if (evt->type == 2 && evt->pause_duration_ns > 0)
+            {
+                Interlocked.Increment(ref s_gcEnds);
+            }
+        }
+
+        [Fact]
+        public unsafe void GcNotifications()
+        {
+            Assert.Equal(0, ExportingAssembly.GcNotifications.dnne_register_gc_callback(&OnGcEvent, (IntPtr)42));
+            try
+            {
+                // Notifications are delivered asynchronously.
+                var timeout = DateTime.UtcNow + TimeSpan.FromSeconds(30);
+                while (Interlocked.Read(ref s_gcEnds) == 0 && DateTime.UtcNow < timeout)
+                {
+                    GC.Collect(2, GCCollectionMode.Forced, blocking: true);
+                    Thread.Sleep(100);
+                }
+
+                Assert.True(Interlocked.Read(ref s_gcStarts) > 0);
+                Assert.True(Interlocked.Read(ref s_gcEnds) > 0);
+                Assert.Equal(42, Interlocked.Read(ref s_gcUser));
+            }
+            finally
+            {
+                Assert.Equal(0, ExportingAssembly.GcNotifications.dnne_register_gc_callback(null, IntPtr.Zero));
+            }
+
+            // The callback isn't called once unregistering returns.
+            long events = Interlocked.Read(ref s_gcEvents);
+            for (int i = 0; i < 3; ++i)
+            {
+                GC.Collect(2, GCCollectionMode.Forced, blocking: true);
+                Thread.Sleep(100);
+            }
+
+            Assert.Equal(events, Interlocked.Read(ref s_gcEvents));
+        }
+
+        private static long s_gcApproachIndex = -1;
+        private static long s_gcEndAfterApproach = -1;
+
+        [UnmanagedCallersOnly]
+        private static unsafe void OnGcApproachEvent(ExportingAssembly.GcNotifications.dnne_gc_event* evt, IntPtr user)
+        {
+            if (evt->type == ExportingAssembly.GcNotifications.dnne_gc_event_approach)
+            {
+                Interlocked.CompareExchange(ref s_gcApproachIndex, (long)evt->index, -1);
+                return;
+            }
+
+            // The first full collection that ends after the approach was reported.
+            long approach = Interlocked.Read(ref s_gcApproachIndex);
+            if (evt->type == 2 && evt->generation == 2 && approach >= 0 && (long)evt->index > approach)
+            {
+                Interlocked.CompareExchange(ref s_gcEndAfterApproach, (long)evt->index, -1);
+            }
+        }
+
+        [Fact]
+        public unsafe void GcApproachNotifications()
+        {
+            // Background collections aren't announced.
+            Assert.Equal(GCLatencyMode.Batch, GCSettings.LatencyMode);
+
+            Assert.Equal(0, ExportingAssembly.GcNotifications.dnne_register_gc_callback(&OnGcApproachEvent, IntPtr.Zero));
+            try
+            {
+                // Only collections triggered by allocation are announced, so keep objects alive
+                // until they are promoted to generation 2 and a full collection is triggered.
+                var live = new List<byte[]>();
+                var timeout = DateTime.UtcNow + TimeSpan.FromSeconds(30);
+                while (Interlocked.Read(ref s_gcEndAfterApproach) < 0 && DateTime.UtcNow < timeout)
+                {
+                    for (int i = 0; i < 10000; ++i)
+                    {
+                        live.Add(new byte[100]);
+                    }
+
+                    if (live.Count > 500000)
+                    {
+                        live.RemoveRange(0, 250000);
+                    }
+                }
+
+                Assert.True(Interlocked.Read(ref s_gcApproachIndex) >= 0);
+                Assert.True(Interlocked.Read(ref s_gcEndAfterApproach) > Interlocked.Read(ref s_gcApproachIndex));
+            }
+            finally
+            {
+                Assert.Equal(0, ExportingAssembly.GcNotifications.dnne_register_gc_callback(null, IntPtr.Zero));
+            }
+        }
+
+        [Fact]
+        public void PureExports()
+        {
+            // Results are cached once the caches are registered by the first call.
+            Assert.Equal(5.0, ExportingAssembly.PureExports.PureHypot(3, 4));
+            Assert.Equal(5.0, ExportingAssembly.PureExports.PureHypot(3, 4));
+            Assert.Equal(30, ExportingAssembly.PureExports.PureScale(3));
+            Assert.Equal(30, ExportingAssembly.PureExports.PureScale(3));
+
+            int calls = ExportingAssembly.PureExports.PureCallCount();
+            for (int i = 0; i < 100; ++i)
+            {
+                Assert.Equal(30, ExportingAssembly.PureExports.PureScale(3));
+                Assert.Equal(5.0, ExportingAssembly.PureExports.PureHypot(3, 4));
+            }
+
+            Assert.Equal(calls, ExportingAssembly.PureExports.PureCallCount());
+
+            // Invalidated by the managed side.
+            ExportingAssembly.PureExports.PureSetScale(5);
+            Assert.Equal(15, ExportingAssembly.PureExports.PureScale(3));
+            Assert.Equal(calls + 1, ExportingAssembly.PureExports.PureCallCount());
+
+            // Invalidated by the native side.
+            ExportingAssembly.PureExports.dnne_invalidate_pure_caches();
+            Assert.Equal(5.0, ExportingAssembly.PureExports.PureHypot(3, 4));
+            Assert.Equal(calls + 2, ExportingAssembly.PureExports.PureCallCount());
+            Assert.Equal(5.0, ExportingAssembly.PureExports.PureHypot(3, 4));
+            Assert.Equal(calls + 2, ExportingAssembly.PureExports.PureCallCount());
+
+            ExportingAssembly.PureExports.PureSetScale(10);
+        }
+
+        [Fact]
+        public void RemoteExports()
+        {
+            // Without DNNE_OUT_OF_PROCESS a remote export is an ordinary export.
+            Assert.Equal(8, ExportingAssembly.RemoteExports.RemoteAdd(3, 5));
+            Assert.Equal(Environment.ProcessId, ExportingAssembly.RemoteExports.remote_process_id());
+        }
+
+        [Fact]
+        public void PrepareCurrentThread()
+        {
+            // Run on a new thread so its thread-static state hasn't been initialized.
+            Exception failure = null;
+            var thread = new Thread(() =>
+            {
+                try
+                {
+                    Assert.Equal(0, ExportingAssembly.ThreadExports.IsCurrentThreadPrepared());
+                    Assert.Equal(0, ExportingAssembly.ThreadExports.dnne_prepare_current_thread());
+                    Assert.Equal(1, ExportingAssembly.ThreadExports.IsCurrentThreadPrepared());
+                    Assert.Equal(0, ExportingAssembly.ThreadExports.dnne_release_current_thread());
+                    Assert.Equal(0, ExportingAssembly.ThreadExports.IsCurrentThreadPrepared());
+                }
+                catch (Exception e)
+                {
+                    failure = e;
+                }
+            });
+
+            thread.Start();
+            thread.Join();
+            Assert.Null(failure);
+        }
+
+        [Fact]
+        public unsafe void ExportTable()
+        {
+            ulong hash;
+            IntPtr address = ExportingAssembly.ExportTable.dnne_find_export("IntIntInt", &hash);
+            Assert.NotEqual(IntPtr.Zero, address);
+            Assert.Equal(15, ((delegate* unmanaged<int, int, int>)address)(3, 5));
+
+            // FNV-1a of "int32_t(int32_t,int32_t)".
+            Assert.Equal(0x3b01ca1fbb41c96ful, hash);
+
+            Assert.Equal(IntPtr.Zero, ExportingAssembly.ExportTable.dnne_find_export("IntIntIn", null));
+            Assert.Equal(IntPtr.Zero, ExportingAssembly.ExportTable.dnne_find_export("IntIntIntX", null));
+
+            // Every export in the table can be found by name. When exports are bound eagerly, the table
+            // keeps the stub of an export that has since been bound, and the lookup returns the address
+            // the dynamic linker now resolves, which is the managed function.
+            IntPtr mod = NativeLibrary.Load(nameof(ExportingAssembly.ExportingAssemblyNE), typeof(Consumption).Assembly, null);
+            ExportingAssembly.ExportTable.dnne_export* exports;
+            nuint count = ExportingAssembly.ExportTable.dnne_enumerate_exports(&exports);
+            Assert.True(count > 0);
+            for (nuint i = 0; i < count; ++i)
+            {
+                string name = Marshal.PtrToStringAnsi((IntPtr)exports[i].name);
+                IntPtr found = ExportingAssembly.ExportTable.dnne_find_export(name, null);
+                if (found != exports[i].address)
+                {
+                    Assert.Equal(NativeLibrary.GetExport(mod, name), found);
+                }
+            }
+        }
+
+        [Fact]
+        public unsafe void DataExports()
+        {
+            IntPtr mod = NativeLibrary.Load(nameof(ExportingAssembly.ExportingAssemblyNE), typeof(Consumption).Assembly, null);
+
+            byte* squares = (byte*)NativeLibrary.GetExport(mod, "squares_table");
+            Assert.True(new ReadOnlySpan<byte>(squares, 8).SequenceEqual(new byte[] { 0, 1, 4, 9, 16, 25, 36, 49 }));
+
+            byte* greeting = (byte*)NativeLibrary.GetExport(mod, "Greeting");
+            Assert.Equal("Hello, DNNE", System.Text.Encoding.UTF8.GetString(greeting, 11));
+
+            // Constants are only defined in the header.
+            Assert.False(NativeLibrary.TryGetExport(mod, "DATA_VERSION", out _));
+        }
+
+        [Fact]
+        public unsafe void AsyncExports()
+        {
+            using var signaled = new SemaphoreSlim(0);
+            GCHandle handle = GCHandle.Alloc(signaled);
+            try
+            {
+                ExportingAssembly.AsyncExports.dnne_completion completion;
+                ExportingAssembly.AsyncExports.dnne_completion_init(&completion, &OnComplete, GCHandle.ToIntPtr(handle));
+
+                Assert.Equal(0, ExportingAssembly.AsyncExports.DelayedAdd_begin(3, 5, 10, &completion));
+                Assert.True(signaled.Wait(TimeSpan.FromSeconds(30)));
+                int sum;
+                Assert.Equal(0, ExportingAssembly.AsyncExports.DelayedAdd_end(&completion, &sum));
+                Assert.Equal(8, sum);
+
+                // The completion can be reused once the result is collected.
+                Assert.Equal(0, ExportingAssembly.AsyncExports.async_fail_begin(&completion));
+                Assert.True(signaled.Wait(TimeSpan.FromSeconds(30)));
+                Assert.Equal(new InvalidOperationException().HResult, ExportingAssembly.AsyncExports.async_fail_end(&completion));
+
+                // An exception before the task is returned is reported when the result is collected.
+                Assert.Equal(0, ExportingAssembly.AsyncExports.ThrowBeforeStart_begin(1, &completion));
+                Assert.True(signaled.Wait(TimeSpan.FromSeconds(30)));
+                long value;
+                Assert.Equal(new ArgumentOutOfRangeException().HResult, ExportingAssembly.AsyncExports.ThrowBeforeStart_end(&completion, &value));
+
+                // The result can only be collected once.
+                Assert.NotEqual(0, ExportingAssembly.AsyncExports.ThrowBeforeStart_end(&completion, &value));
+
+                // The method isn't called with a completion that can't be signaled.
+                ExportingAssembly.AsyncExports.dnne_completion uninitialized = default;
+                Assert.Equal(new ArgumentException().HResult, ExportingAssembly.AsyncExports.NullTask_begin(&uninitialized));
+                Assert.Equal(0, ExportingAssembly.AsyncExports.async_null_task_calls());
+
+                // A null task is reported without signaling the completion.
+                Assert.Equal(new InvalidOperationException().HResult, ExportingAssembly.AsyncExports.NullTask_begin(&completion));
+                Assert.Equal(1, ExportingAssembly.AsyncExports.async_null_task_calls());
+                Assert.False(signaled.Wait(0));
+                Assert.Equal(IntPtr.Zero, completion.state);
+            }
+            finally
+            {
+                handle.Free();
+            }
+
+            [UnmanagedCallersOnly]
+            static void OnComplete(ExportingAssembly.AsyncExports.dnne_completion* completion, IntPtr user)
+            {
+                ((SemaphoreSlim)GCHandle.FromIntPtr(user).Target).Release();
+            }
+        }
+
+        [Fact]
+        public unsafe void CommandExports()
+        {
+            // A small capacity so the buffer grows while recording.
+            IntPtr buffer = ExportingAssembly.CommandExports.dnne_command_buffer_create(2);
+            Assert.NotEqual(IntPtr.Zero, buffer);
+            try
+            {
+                long start = ExportingAssembly.CommandExports.command_total();
+                long total;
+                double scaled;
+                int stored = 0;
+                for (int i = 1; i <= 100; ++i)
+                {
+                    Assert.Equal(0, ExportingAssembly.CommandExports.Accumulate_record(buffer, i));
+                }
+
+                Assert.Equal(0, ExportingAssembly.CommandExports.command_total_record(buffer, &total));
+                Assert.Equal(0, ExportingAssembly.CommandExports.ScaleBy_record(buffer, 1.5f, -2.0, 3, &scaled));
+                Assert.Equal(0, ExportingAssembly.CommandExports.Store_record(buffer, &stored, 42));
+
+                // Nothing is called until the buffer is submitted.
+                Assert.Equal(start, ExportingAssembly.CommandExports.command_total());
+                Assert.Equal(0, ExportingAssembly.CommandExports.dnne_submit(buffer));
+                Assert.Equal(start + 5050, total);
+                Assert.Equal(-24.0, scaled);
+                Assert.Equal(42, stored);
+
+                // The buffer isn't reset by submitting it.
+                Assert.Equal(0, ExportingAssembly.CommandExports.dnne_submit(buffer));
+                Assert.Equal(start + 10100, total);
+
+                // Calls after an exception aren't made.
+                ExportingAssembly.CommandExports.dnne_command_buffer_reset(buffer);
+                int quotient = 0;
+                stored = 0;
+                Assert.Equal(0, ExportingAssembly.CommandExports.CheckedDivide_record(buffer, 7, 0, &quotient));
+                Assert.Equal(0, ExportingAssembly.CommandExports.Store_record(buffer, &stored, 1));
+                Assert.Equal(new DivideByZeroException().HResult, ExportingAssembly.CommandExports.dnne_submit(buffer));
+                Assert.Equal(0, stored);
+
+                ExportingAssembly.CommandExports.dnne_command_buffer_reset(buffer);
+                Assert.Equal(0, ExportingAssembly.CommandExports.CheckedDivide_record(buffer, 7, 2, &quotient));
+                Assert.Equal(0, ExportingAssembly.CommandExports.dnne_submit(buffer));
+                Assert.Equal(3, quotient);
+            }
+            finally
+            {
+                ExportingAssembly.CommandExports.dnne_command_buffer_destroy(buffer);
+            }
+        }
     }
 }
@@ -59,6 +59,27 @@ namespace DNNE.UnitTests
             public static extern int MyClass_doubleNumber(IntPtr inst);
         }
 
+        public static class HandleExports
+        {
+            // Same layout as the generated Counter_handle.
+            public struct Counter_handle
+            {
+                public ulong Opaque;
+            }
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern Counter_handle Counter_create(int value);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void Counter_destroy(Counter_handle handle);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int Counter_add(Counter_handle handle, int amount);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int Counter_isValid(Counter_handle handle);
+        }
+
         public static class IntExports
         {
             [DllImport(nameof(ExportingAssemblyNE))]
@@ -87,6 +108,9 @@ namespace DNNE.UnitTests
 
             [DllImport(nameof(ExportingAssemblyNE), CallingConvention = CallingConvention.Cdecl)]
             public static extern void UnmanagedIntVoidCdecl(int a);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int MarshalAsIntInt(int a);
         }
 
         public unsafe static class MiscExports
@@ -284,5 +308,230 @@ namespace DNNE.UnitTests
             [DllImport(nameof(ExportingAssemblyNE))]
             public static extern void Nested2_UnmanagedVoidVoid();
         }
+
+        public unsafe static class ArenaExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern IntPtr dnne_arena_create(nuint chunk_size);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void* dnne_arena_alloc(IntPtr arena, nuint size, nuint align);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_arena_reset(IntPtr arena);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_arena_destroy(IntPtr arena);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern byte** ArenaSplitString(IntPtr arena, [MarshalAs(UnmanagedType.LPStr)] string str, int* count);
+        }
+
+        public static class PerfMap
+        {
+            public const int DNNE_E_NOTIMPL = unchecked((int)0x80004001);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_write_perf_map([MarshalAs(UnmanagedType.LPStr)] string path);
+        }
+
+        public static class Tracing
+        {
+            public const int DNNE_E_NOTIMPL = unchecked((int)0x80004001);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_trace_dump([MarshalAs(UnmanagedType.LPStr)] string path);
+        }
+
+        public static class RuntimeMetrics
+        {
+            [StructLayout(LayoutKind.Sequential)]
+            public unsafe struct dnne_runtime_metrics
+            {
+                public uint size;
+                public uint reserved;
+                public ulong gc_heap_size_bytes;
+                public fixed ulong gc_generation_size_bytes[5];
+                public ulong gc_total_allocated_bytes;
+                public fixed ulong gc_collection_count[3];
+                public ulong gc_total_pause_duration_ns;
+                public ulong jit_compiled_method_count;
+                public ulong jit_compiled_il_bytes;
+                public ulong jit_compilation_time_ns;
+                public ulong thread_pool_thread_count;
+                public ulong thread_pool_pending_work_item_count;
+                public ulong thread_pool_completed_work_item_count;
+            }
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_get_runtime_metrics(ref dnne_runtime_metrics metrics);
+        }
+
+        public unsafe static class GcNotifications
+        {
+            public const int dnne_gc_event_approach = 3;
+
+            [StructLayout(LayoutKind.Sequential)]
+            public struct dnne_gc_event
+            {
+                public uint size;
+                public int type;
+                public int generation;
+                public int reason;
+                public int kind;
+                public ulong index;
+                public ulong pause_duration_ns;
+            }
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_register_gc_callback(delegate* unmanaged<dnne_gc_event*, IntPtr, void> cb, IntPtr user);
+        }
+
+        public static class PureExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int PureScale(int value);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern double PureHypot(double x, double y);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void PureSetScale(int scale);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int PureCallCount();
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_invalidate_pure_caches();
+        }
+
+        public static class RemoteExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int RemoteAdd(int a, int b);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int remote_process_id();
+        }
+
+        public static class ThreadExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int IsCurrentThreadPrepared();
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_prepare_current_thread();
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_release_current_thread();
+        }
+
+        public unsafe static class ExportTable
+        {
+            [StructLayout(LayoutKind.Sequential)]
+            public struct dnne_export
+            {
+                public byte* name;
+                public IntPtr address;
+                public ulong signature_hash;
+            }
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern IntPtr dnne_find_export([MarshalAs(UnmanagedType.LPStr)] string name, ulong* signature_hash);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern nuint dnne_enumerate_exports(dnne_export** exports);
+        }
+
+        public unsafe static class GenericExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern float dot_f32(float* a, float* b, int length);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern double dot_f64(double* a, double* b, int length);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int Dot_Int32(int* a, int* b, int length);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern long Dot_Int64(long* a, long* b, int length);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void WidenAdd(int a, int b, long* result);
+        }
+
+        public unsafe static class AsyncExports
+        {
+            [StructLayout(LayoutKind.Sequential)]
+            public struct dnne_completion
+            {
+                public IntPtr signal;
+                public IntPtr callback;
+                public IntPtr user;
+                public IntPtr @event;
+                public IntPtr state;
+            }
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_completion_init(dnne_completion* completion, delegate* unmanaged<dnne_completion*, IntPtr, void> cb, IntPtr user);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int DelayedAdd_begin(int a, int b, int delayMs, dnne_completion* completion);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int DelayedAdd_end(dnne_completion* completion, int* result);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int async_fail_begin(dnne_completion* completion);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int async_fail_end(dnne_completion* completion);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int ThrowBeforeStart_begin(long value, dnne_completion* completion);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int ThrowBeforeStart_end(dnne_completion* completion, long* result);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int NullTask_begin(dnne_completion* completion);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int async_null_task_calls();
+        }
+
+        public unsafe static class CommandExports
+        {
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern IntPtr dnne_command_buffer_create(nuint capacity);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_command_buffer_reset(IntPtr buffer);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern void dnne_command_buffer_destroy(IntPtr buffer);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int dnne_submit(IntPtr buffer);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int Accumulate_record(IntPtr buffer, long value);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int command_total_record(IntPtr buffer, long* result);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int ScaleBy_record(IntPtr buffer, float value, double factor, byte shift, double* result);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int Store_record(IntPtr buffer, int* dest, int value);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern int CheckedDivide_record(IntPtr buffer, int a, int b, int* result);
+
+            [DllImport(nameof(ExportingAssemblyNE))]
+            public static extern long command_total();
+        }
     }
 }
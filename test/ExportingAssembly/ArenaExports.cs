@@ -0,0 +1,51 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System.Runtime.InteropServices;
+
+namespace ExportingAssembly
+{
+    internal unsafe class ArenaExports
+    {
+        /// <summary>
+        /// Split a comma separated string into strings allocated from the supplied arena.
+        /// </summary>
+        /// <param name="arena">Arena to allocate results from</param>
+        /// <param name="str">Comma separated string</param>
+        /// <param name="count">Number of strings returned</param>
+        /// <returns>Array of null-terminated strings</returns>
+        [UnmanagedCallersOnly]
+        public static byte** ArenaSplitString(
+            [DNNE.C99Type("dnne_arena*")][DNNE.RustType("*mut crate::platform::Arena")] DNNE.Arena arena,
+            sbyte* str,
+            int* count)
+        {
+            string[] parts = new string(str).Split(',');
+
+            byte** results = (byte**)arena.Allocate<nint>(parts.Length);
+            for (int i = 0; i < parts.Length; ++i)
+            {
+                results[i] = arena.AllocateUtf8(parts[i]);
+            }
+
+            *count = parts.Length;
+            return results;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+using System.Runtime.InteropServices;
+using System.Threading.Tasks;
+
+namespace ExportingAssembly
+{
+    public class AsyncExports
+    {
+        [DNNE.AsyncExport]
+        public static async Task<int> DelayedAdd(int a, int b, int delayMs)
+        {
+            await Task.Delay(delayMs);
+            return a + b;
+        }
+
+        [DNNE.AsyncExport(EntryPoint = "async_fail")]
+        public static async ValueTask FailAfterYield()
+        {
+            await Task.Yield();
+            throw new InvalidOperationException();
+        }
+
+        [DNNE.AsyncExport]
+        public static Task<long> ThrowBeforeStart(long value)
+        {
+            throw new ArgumentOutOfRangeException(nameof(value));
+        }
+
+        private static int s_nullTaskCalls;
+
+        [DNNE.AsyncExport]
+        public static Task NullTask()
+        {
+            s_nullTaskCalls++;
+            return null;
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "async_null_task_calls")]
+        public static int NullTaskCalls()
+        {
+            return s_nullTaskCalls;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+
+namespace ExportingAssembly
+{
+    public unsafe class CommandExports
+    {
+        private static long s_total;
+
+        [DNNE.CommandExport]
+        public static void Accumulate(long value)
+        {
+            s_total += value;
+        }
+
+        [DNNE.CommandExport(EntryPoint = "command_total")]
+        public static long Total()
+        {
+            return s_total;
+        }
+
+        [DNNE.CommandExport]
+        public static double ScaleBy(float value, double factor, byte shift)
+        {
+            return value * factor * (1 << shift);
+        }
+
+        [DNNE.CommandExport]
+        public static void Store(int* dest, int value)
+        {
+            *dest = value;
+        }
+
+        [DNNE.CommandExport]
+        public static int CheckedDivide(int a, int b)
+        {
+            if (b == 0)
+            {
+                throw new DivideByZeroException();
+            }
+
+            return a / b;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+
+namespace ExportingAssembly
+{
+    public class DataExports
+    {
+        /// <summary>
+        /// Version of the exported data
+        /// </summary>
+        [DNNE.ExportData(EntryPoint = "DATA_VERSION")]
+        public const int DataVersion = 3;
+
+        [DNNE.ExportData]
+        public const double Scale = 0.5;
+
+        [DNNE.ExportData]
+        public const long MinimumOffset = long.MinValue;
+
+        /// <summary>
+        /// Lookup table of the squares of the first eight integers
+        /// </summary>
+        [DNNE.ExportData(EntryPoint = "squares_table")]
+        public static ReadOnlySpan<byte> Squares => new byte[] { 0, 1, 4, 9, 16, 25, 36, 49 };
+
+        [DNNE.ExportData]
+        public static ReadOnlySpan<byte> Greeting => "Hello, DNNE"u8;
+    }
+}
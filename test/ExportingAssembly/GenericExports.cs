@@ -0,0 +1,69 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System.Numerics;
+using System.Runtime.CompilerServices;
+
+namespace ExportingAssembly
+{
+    public unsafe class GenericExports
+    {
+        /// <summary>
+        /// Compute the dot product of two vectors
+        /// </summary>
+        /// <param name="a">First vector</param>
+        /// <param name="b">Second vector</param>
+        /// <param name="length">Length of the vectors</param>
+        /// <returns>The dot product</returns>
+        [DNNE.Instantiate(typeof(float), EntryPoint = "dot_f32")]
+        [DNNE.Instantiate(typeof(double), EntryPoint = "dot_f64")]
+        [DNNE.Instantiate(typeof(int))]
+        [DNNE.Instantiate(typeof(long))]
+        public static T Dot<T>(T* a, T* b, int length) where T : unmanaged, INumber<T>
+        {
+            T result = T.Zero;
+            int i = 0;
+            if (Vector.IsHardwareAccelerated && Vector<T>.IsSupported)
+            {
+                Vector<T> acc = Vector<T>.Zero;
+                for (; i <= length - Vector<T>.Count; i += Vector<T>.Count)
+                {
+                    acc += Unsafe.ReadUnaligned<Vector<T>>(a + i) * Unsafe.ReadUnaligned<Vector<T>>(b + i);
+                }
+
+                result = Vector.Sum(acc);
+            }
+
+            for (; i < length; ++i)
+            {
+                result += a[i] * b[i];
+            }
+
+            return result;
+        }
+
+        [DNNE.Instantiate(typeof(int), typeof(long), EntryPoint = "WidenAdd")]
+        public static void Add<TFrom, TTo>(TFrom a, TFrom b, [DNNE.C99Type("int64_t*")] TTo* result)
+            where TFrom : unmanaged, INumber<TFrom>
+            where TTo : unmanaged, INumber<TTo>
+        {
+            *result = TTo.CreateChecked(a) + TTo.CreateChecked(b);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System.Runtime.InteropServices;
+
+namespace ExportingAssembly
+{
+    /// <summary>
+    /// Type exposed to native code through a generated <see cref="CounterHandle"/>.
+    /// </summary>
+    /// <remarks>
+    /// Compare with <see cref="InstanceExports"/>, which passes a <see cref="GCHandle"/> as an <c>intptr_t</c>.
+    /// The handle is a distinct <c>Counter_handle</c> type in the generated header.
+    /// </remarks>
+    [DNNE.Handle]
+    public class Counter
+    {
+        public int Value { get; set; }
+    }
+
+    public class HandleExports
+    {
+        [UnmanagedCallersOnly(EntryPoint = "Counter_create")]
+        public static CounterHandle CreateCounter(int value)
+        {
+            return CounterHandle.Alloc(new Counter() { Value = value });
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "Counter_destroy")]
+        public static void DestroyCounter(CounterHandle handle)
+        {
+            handle.Free();
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "Counter_add")]
+        public static int CounterAdd(CounterHandle handle, int amount)
+        {
+            return handle.Target.Value += amount;
+        }
+
+        [UnmanagedCallersOnly(EntryPoint = "Counter_isValid")]
+        public static int CounterIsValid(CounterHandle handle)
+        {
+            return handle.TryGetTarget(out _) ? 1 : 0;
+        }
+    }
+}
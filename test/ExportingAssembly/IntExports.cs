@@ -97,5 +97,14 @@ namespace ExportingAssembly
             IntVoid(a);
         }
 #endif // !NETFRAMEWORK
+
+        public delegate int MarshalAsIntIntDelegate([MarshalAs(UnmanagedType.I4)] int a);
+
+        // Custom marshalling keeps the export bound through its delegate type.
+        [DNNE.Export]
+        public static int MarshalAsIntInt([MarshalAs(UnmanagedType.I4)] int a)
+        {
+            return a * 3;
+        }
     }
 }
@@ -0,0 +1,60 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace ExportingAssembly
+{
+    public class PureExports
+    {
+        private static int s_scale = 10;
+        private static int s_calls;
+
+        [DNNE.Pure(CacheSize = 16)]
+        [UnmanagedCallersOnly]
+        public static int PureScale(int value)
+        {
+            Interlocked.Increment(ref s_calls);
+            return value * Volatile.Read(ref s_scale);
+        }
+
+        [DNNE.Pure]
+        [UnmanagedCallersOnly]
+        public static double PureHypot(double x, double y)
+        {
+            Interlocked.Increment(ref s_calls);
+            return Math.Sqrt((x * x) + (y * y));
+        }
+
+        [UnmanagedCallersOnly]
+        public static void PureSetScale(int scale)
+        {
+            Volatile.Write(ref s_scale, scale);
+            DNNE.PureCaches.Invalidate();
+        }
+
+        [UnmanagedCallersOnly]
+        public static int PureCallCount()
+        {
+            return Volatile.Read(ref s_calls);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+﻿// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+using System.Runtime.Intrinsics;
+
+namespace ExportingAssembly
+{
+    public class SimdExports
+    {
+        [DNNE.VectorExport(EntryPoint = "vector_add_ps")]
+        public static Vector128<float> AddSingle(Vector128<float> a, Vector128<float> b)
+        {
+            return a + b;
+        }
+
+        [DNNE.VectorExport(EntryPoint = "vector_add_pd")]
+        public static Vector256<double> AddDouble(Vector256<double> a, Vector256<double> b)
+        {
+            return a + b;
+        }
+
+        /// <summary>
+        /// Interleave vector and scalar arguments to check register assignment.
+        /// </summary>
+        [DNNE.VectorExport(EntryPoint = "vector_mix")]
+        public static Vector128<int> Mix(Vector128<int> a, int scale, Vector128<double> b, float offset, Vector128<int> c)
+        {
+            Vector128<int> converted = Vector128.Create((int)(b.GetElement(0) + offset), (int)(b.GetElement(1) + offset), 0, 0);
+            return (a * scale) + converted + c;
+        }
+
+        [DNNE.VectorExport(EntryPoint = "vector_sum_ps")]
+        public static float Sum(Vector128<float> a)
+        {
+            return Vector128.Sum(a);
+        }
+    }
+}
@@ -0,0 +1,306 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Measures the time and peak memory dnne-gen takes to generate source for a
+// large assembly.
+//
+// A synthetic assembly, and its XML documentation, with the requested number of
+// exports is written to a temporary directory. Each iteration runs dnne-gen in
+// a new process so the peak memory is that of a single generation. See the
+// readme for details.
+//
+// Usage: GeneratorBenchmark [exports] [iterations] [c99|rust]
+
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Reflection;
+using System.Reflection.Metadata;
+using System.Reflection.Metadata.Ecma335;
+using System.Reflection.PortableExecutable;
+using System.Xml;
+
+namespace GeneratorBenchmark
+{
+    class Program
+    {
+        private const string ChildFlag = "--child";
+        private const string AssemblyName = "SyntheticExports";
+        private const int ExportsPerType = 100;
+        private const int MaxIterations = 1000;
+
+        static int Main(string[] args)
+        {
+            if (args.Length > 1 && args[0] == ChildFlag)
+            {
+                return RunChild(args[1..]);
+            }
+
+            if (args.Length > 3 || args.Any(static a => a is "-?" or "-h" or "--help"))
+            {
+                Console.WriteLine("Usage: GeneratorBenchmark [exports] [iterations] [c99|rust]");
+                return 1;
+            }
+
+            int exports = args.Length > 0 ? int.Parse(args[0], CultureInfo.InvariantCulture) : 60000;
+            int iterations = args.Length > 1 ? int.Parse(args[1], CultureInfo.InvariantCulture) : 5;
+            string language = args.Length > 2 ? args[2] : "c99";
+            if (exports <= 0 || iterations <= 0 || iterations > MaxIterations)
+            {
+                Console.WriteLine($"Exports must be positive and iterations must be between 1 and {MaxIterations}");
+                return 1;
+            }
+
+            string workDir = Path.Combine(Path.GetTempPath(), $"dnne-gen-benchmark-{Environment.ProcessId}");
+            Directory.CreateDirectory(workDir);
+            try
+            {
+                string assemblyPath = Path.Combine(workDir, $"{AssemblyName}.dll");
+                string xmlDocPath = Path.Combine(workDir, $"{AssemblyName}.xml");
+                string outputPath = Path.Combine(workDir, language == "rust" ? "exports.rs" : "exports.g.c");
+                WriteAssembly(assemblyPath, xmlDocPath, exports);
+
+                var times = new List<double>();
+                var peaks = new List<double>();
+                var allocations = new List<double>();
+                for (int i = 0; i < iterations; ++i)
+                {
+                    string[] sample = RunIteration(assemblyPath, "-d", xmlDocPath, "-l", language, "-o", outputPath);
+                    if (sample is null)
+                    {
+                        return 1;
+                    }
+
+                    times.Add(double.Parse(sample[0], CultureInfo.InvariantCulture));
+                    peaks.Add(double.Parse(sample[1], CultureInfo.InvariantCulture));
+                    allocations.Add(double.Parse(sample[2], CultureInfo.InvariantCulture));
+                }
+
+                Console.WriteLine($"{exports} exports, {iterations} iterations, {language} output of {new FileInfo(outputPath).Length / 1024} KB");
+                Report("generate (ms)", times);
+                Report("peak RSS (KB)", peaks);
+                Report("allocated (KB)", allocations);
+                return 0;
+            }
+            finally
+            {
+                Directory.Delete(workDir, recursive: true);
+            }
+        }
+
+        // Run dnne-gen once and write the sample to stdout.
+        private static int RunChild(string[] args)
+        {
+            MethodInfo entryPoint = Assembly.Load("dnne-gen").EntryPoint;
+            string outputPath = args[Array.IndexOf(args, "-o") + 1];
+            File.Delete(outputPath);
+
+            // dnne-gen reports errors rather than throwing.
+            TextWriter stdout = Console.Out;
+            var messages = new StringWriter();
+            Console.SetOut(messages);
+
+            var stopwatch = Stopwatch.StartNew();
+            entryPoint.Invoke(null, new object[] { args });
+            stopwatch.Stop();
+
+            Console.SetOut(stdout);
+            if (!File.Exists(outputPath))
+            {
+                Console.Error.Write(messages.ToString());
+                return 1;
+            }
+
+            using Process self = Process.GetCurrentProcess();
+            Console.WriteLine(string.Format(CultureInfo.InvariantCulture, "{0} {1} {2}",
+                stopwatch.Elapsed.TotalMilliseconds,
+                self.PeakWorkingSet64 / 1024,
+                GC.GetTotalAllocatedBytes(precise: true) / 1024));
+            return 0;
+        }
+
+        private static string[] RunIteration(params string[] args)
+        {
+            var startInfo = new ProcessStartInfo(Environment.ProcessPath)
+            {
+                RedirectStandardOutput = true,
+            };
+
+            // Launched through the dotnet host rather than the apphost.
+            if (Path.GetFileNameWithoutExtension(Environment.ProcessPath) == "dotnet")
+            {
+                startInfo.ArgumentList.Add(typeof(Program).Assembly.Location);
+            }
+
+            startInfo.ArgumentList.Add(ChildFlag);
+            foreach (string arg in args)
+            {
+                startInfo.ArgumentList.Add(arg);
+            }
+
+            using Process child = Process.Start(startInfo);
+            string output = child.StandardOutput.ReadToEnd();
+            child.WaitForExit();
+            if (child.ExitCode != 0)
+            {
+                Console.WriteLine($"Generation failed: {child.ExitCode}");
+                return null;
+            }
+
+            return output.Split(' ', StringSplitOptions.RemoveEmptyEntries | StringSplitOptions.TrimEntries);
+        }
+
+        private static void Report(string name, List<double> values)
+        {
+            values.Sort();
+            Console.WriteLine(string.Format(CultureInfo.InvariantCulture, "{0,-16} min {1,12:F1}  median {2,12:F1}  max {3,12:F1}",
+                name, values[0], values[values.Count / 2], values[^1]));
+        }
+
+        // Signatures of the synthetic exports. The first argument is returned.
+        private static readonly PrimitiveTypeCode[][] s_signatures = new[]
+        {
+            new[] { PrimitiveTypeCode.Int32, PrimitiveTypeCode.Int32 },
+            new[] { PrimitiveTypeCode.Int64, PrimitiveTypeCode.Double },
+            new[] { PrimitiveTypeCode.IntPtr, PrimitiveTypeCode.UInt32 },
+            new[] { PrimitiveTypeCode.Double, PrimitiveTypeCode.Single, PrimitiveTypeCode.Int16 },
+        };
+
+        // Write an assembly of static classes with UnmanagedCallersOnlyAttribute methods
+        // and the XML documentation for the methods.
+        private static void WriteAssembly(string assemblyPath, string xmlDocPath, int exports)
+        {
+            var metadata = new MetadataBuilder();
+            var il = new BlobBuilder();
+            var bodies = new MethodBodyStreamEncoder(il);
+
+            metadata.AddModule(0, metadata.GetOrAddString($"{AssemblyName}.dll"), metadata.GetOrAddGuid(Guid.NewGuid()), default, default);
+            metadata.AddAssembly(metadata.GetOrAddString(AssemblyName), new Version(1, 0, 0, 0), default, default, default, AssemblyHashAlgorithm.Sha1);
+
+            AssemblyReferenceHandle systemRuntime = metadata.AddAssemblyReference(
+                metadata.GetOrAddString("System.Runtime"),
+                new Version(8, 0, 0, 0),
+                default,
+                metadata.GetOrAddBlob(new byte[] { 0xb0, 0x3f, 0x5f, 0x7f, 0x11, 0xd5, 0x0a, 0x3a }),
+                default,
+                default);
+            TypeReferenceHandle systemObject = metadata.AddTypeReference(systemRuntime, metadata.GetOrAddString("System"), metadata.GetOrAddString("Object"));
+            TypeReferenceHandle callersOnly = metadata.AddTypeReference(
+                systemRuntime,
+                metadata.GetOrAddString("System.Runtime.InteropServices"),
+                metadata.GetOrAddString("UnmanagedCallersOnlyAttribute"));
+
+            var ctorSignature = new BlobBuilder();
+            new BlobEncoder(ctorSignature).MethodSignature(isInstanceMethod: true).Parameters(0, static r => r.Void(), static p => { });
+            MemberReferenceHandle callersOnlyCtor = metadata.AddMemberReference(callersOnly, metadata.GetOrAddString(".ctor"), metadata.GetOrAddBlob(ctorSignature));
+
+            // Attribute prolog with no arguments.
+            BlobHandle callersOnlyValue = metadata.GetOrAddBlob(new byte[] { 0x01, 0x00, 0x00, 0x00 });
+
+            var methodSignatures = new BlobHandle[s_signatures.Length];
+            var bodyOffsets = new int[s_signatures.Length];
+            for (int i = 0; i < s_signatures.Length; ++i)
+            {
+                PrimitiveTypeCode[] types = s_signatures[i];
+                var signature = new BlobBuilder();
+                new BlobEncoder(signature).MethodSignature().Parameters(
+                    types.Length,
+                    r => r.Type().PrimitiveType(types[0]),
+                    p =>
+                    {
+                        foreach (PrimitiveTypeCode type in types)
+                        {
+                            p.AddParameter().Type().PrimitiveType(type);
+                        }
+                    });
+                methodSignatures[i] = metadata.GetOrAddBlob(signature);
+
+                var code = new InstructionEncoder(new BlobBuilder());
+                code.LoadArgument(0);
+                code.OpCode(ILOpCode.Ret);
+                bodyOffsets[i] = bodies.AddMethodBody(code);
+            }
+
+            using var xmlDoc = XmlWriter.Create(xmlDocPath, new XmlWriterSettings() { Indent = true });
+            xmlDoc.WriteStartElement("doc");
+            xmlDoc.WriteStartElement("assembly");
+            xmlDoc.WriteElementString("name", AssemblyName);
+            xmlDoc.WriteEndElement();
+            xmlDoc.WriteStartElement("members");
+
+            metadata.AddTypeDefinition(default, default, metadata.GetOrAddString("<Module>"), default,
+                MetadataTokens.FieldDefinitionHandle(1), MetadataTokens.MethodDefinitionHandle(1));
+
+            int methodRow = 1;
+            int parameterRow = 1;
+            for (int t = 0; t * ExportsPerType < exports; ++t)
+            {
+                string typeName = $"Exports{t}";
+                metadata.AddTypeDefinition(
+                    TypeAttributes.Public | TypeAttributes.Abstract | TypeAttributes.Sealed | TypeAttributes.BeforeFieldInit,
+                    metadata.GetOrAddString(AssemblyName),
+                    metadata.GetOrAddString(typeName),
+                    systemObject,
+                    MetadataTokens.FieldDefinitionHandle(1),
+                    MetadataTokens.MethodDefinitionHandle(methodRow));
+
+                for (int m = 0; m < ExportsPerType && t * ExportsPerType + m < exports; ++m, ++methodRow)
+                {
+                    int kind = m % s_signatures.Length;
+                    string methodName = $"Export{t}_{m}";
+                    MethodDefinitionHandle method = metadata.AddMethodDefinition(
+                        MethodAttributes.Public | MethodAttributes.Static | MethodAttributes.HideBySig,
+                        MethodImplAttributes.IL,
+                        metadata.GetOrAddString(methodName),
+                        methodSignatures[kind],
+                        bodyOffsets[kind],
+                        MetadataTokens.ParameterHandle(parameterRow));
+
+                    for (int p = 0; p < s_signatures[kind].Length; ++p, ++parameterRow)
+                    {
+                        metadata.AddParameter(ParameterAttributes.None, metadata.GetOrAddString($"arg{p}"), p + 1);
+                    }
+
+                    metadata.AddCustomAttribute(method, callersOnlyCtor, callersOnlyValue);
+
+                    string parameters = string.Join(",", s_signatures[kind].Select(static p => $"System.{p}"));
+                    xmlDoc.WriteStartElement("member");
+                    xmlDoc.WriteAttributeString("name", $"M:{AssemblyName}.{typeName}.{methodName}({parameters})");
+                    xmlDoc.WriteElementString("summary", $"Synthetic export {methodName}.");
+                    xmlDoc.WriteEndElement();
+                }
+            }
+
+            xmlDoc.WriteEndElement();
+            xmlDoc.WriteEndElement();
+
+            var image = new BlobBuilder();
+            new ManagedPEBuilder(
+                new PEHeaderBuilder(imageCharacteristics: Characteristics.Dll | Characteristics.ExecutableImage),
+                new MetadataRootBuilder(metadata),
+                il).Serialize(image);
+
+            using var stream = File.Create(assemblyPath);
+            image.WriteContentTo(stream);
+        }
+    }
+}
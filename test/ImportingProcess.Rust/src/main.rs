@@ -39,6 +39,10 @@ fn main() {
     // Set failure callback.
     platform::set_failure_callback(Some(on_failure));
 
+    // Exported data is read without starting the runtime.
+    assert_eq!(exports::squares_table[7], 49);
+    println!("squares_table[7] = {}", exports::squares_table[7]);
+
     // Preload the .NET runtime.
     unsafe {
         let result = platform::try_preload_runtime();
@@ -57,4 +61,43 @@ fn main() {
         let c = exports::UnmanagedIntIntInt(a, b);
         println!("UnmanagedIntIntInt({}, {}) = {}", a, b, c);
     }
+
+    // Return variable-sized results through an arena.
+    unsafe {
+        let arena = platform::arena_create(0);
+        let mut count: i32 = 0;
+        let parts = exports::ArenaSplitString(arena, b"DNNE,Rust\0".as_ptr() as *mut i8, &mut count);
+        for i in 0..count as usize {
+            let part = std::ffi::CStr::from_ptr(*parts.add(i) as *const core::ffi::c_char);
+            println!("ArenaSplitString[{}] = {}", i, part.to_string_lossy());
+        }
+        platform::arena_destroy(arena);
+    }
+
+    // Pass SIMD vectors by value.
+    unsafe {
+        let a: platform::M128 = core::mem::transmute([1.0f32, 2.0, 3.0, 4.0]);
+        let b: platform::M128 = core::mem::transmute([10.0f32, 20.0, 30.0, 40.0]);
+        let c: [f32; 4] = core::mem::transmute(exports::vector_add_ps(a, b));
+        println!("vector_add_ps() = {:?}", c);
+    }
+
+    // Call a pure export repeatedly, later calls return the cached result.
+    unsafe {
+        let mut sum = 0;
+        for _ in 0..10 {
+            sum += exports::PureScale(3);
+        }
+        platform::invalidate_pure_caches();
+        println!("PureScale(3) x 10 = {}", sum);
+    }
+
+    // Read managed runtime metrics.
+    unsafe {
+        let metrics = platform::get_runtime_metrics().expect("get_runtime_metrics failed");
+        println!(
+            "Allocated: {} bytes, JIT compiled methods: {}",
+            metrics.gc_total_allocated_bytes, metrics.jit_compiled_method_count
+        );
+    }
 }
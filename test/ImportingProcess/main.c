@@ -40,6 +40,12 @@ static void* get_export(void* h, const char* name)
 #else
 #include <dlfcn.h>
 #include <limits.h>
+#include <poll.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
 
 static void* load_library(const char* path)
 {
@@ -62,9 +68,33 @@ struct T { int a; int b; int c; };
 typedef int (DNNE_CALLTYPE* ReturnDataCMember_t)(struct T);
 typedef int (DNNE_CALLTYPE* ReturnRefDataCMember_t)(struct T*);
 
+// Vectors are passed by value, in registers where the calling convention allows.
+typedef dnne_m128 (DNNE_CALLTYPE* vector_add_ps_t)(dnne_m128, dnne_m128);
+typedef dnne_m256d (DNNE_CALLTYPE* vector_add_pd_t)(dnne_m256d, dnne_m256d);
+typedef dnne_m128i (DNNE_CALLTYPE* vector_mix_t)(dnne_m128i, int32_t, dnne_m128d, float, dnne_m128i);
+typedef float (DNNE_CALLTYPE* vector_sum_ps_t)(dnne_m128);
+
+// Element access that works for both the native and portable vector types.
+typedef union { dnne_m128 v; float f[4]; } m128_f32;
+typedef union { dnne_m128d v; double d[2]; } m128_f64;
+typedef union { dnne_m128i v; int32_t i[4]; } m128_i32;
+typedef union { dnne_m256d v; double d[4]; } m256_f64;
+
+// Asynchronous exports are started and then collected once the completion is signaled.
+typedef void (DNNE_CALLTYPE* dnne_completion_init_event_t)(struct dnne_completion*, intptr_t);
+typedef int (DNNE_CALLTYPE* DelayedAdd_begin_t)(int, int, int, struct dnne_completion*);
+typedef int (DNNE_CALLTYPE* DelayedAdd_end_t)(struct dnne_completion*, int*);
+
+// Calls are recorded in a command buffer and made by a single submit.
+typedef dnne_command_buffer* (DNNE_CALLTYPE* dnne_command_buffer_create_t)(size_t);
+typedef void (DNNE_CALLTYPE* dnne_command_buffer_destroy_t)(dnne_command_buffer*);
+typedef int (DNNE_CALLTYPE* dnne_submit_t)(dnne_command_buffer*);
+typedef int (DNNE_CALLTYPE* ScaleBy_record_t)(dnne_command_buffer*, float, double, uint8_t, double*);
+
 typedef void (DNNE_CALLTYPE* set_failure_callback_t)(failure_fn cb);
 typedef void (DNNE_CALLTYPE* preload_runtime_t)(void);
 typedef int (DNNE_CALLTYPE* try_preload_runtime_t)(void);
+typedef void* (DNNE_CALLTYPE* dnne_find_export_t)(const char*, uint64_t*);
 
 static void DNNE_CALLTYPE on_failure(enum failure_type type, int error_code)
 {
@@ -80,6 +110,14 @@ int main(int ac, char** av)
     RETURN_FAIL_IF_FALSE(set_cb, "Failed to get set_failure_callback export\n");
     set_cb(on_failure);
 
+    // Exported data is read without starting the runtime.
+    {
+        const uint8_t* squares = (const uint8_t*)get_export(mod, "squares_table");
+        RETURN_FAIL_IF_FALSE(squares, "Failed to get squares_table export\n");
+        RETURN_FAIL_IF_FALSE(squares[7] == 49, "squares_table has incorrect contents\n");
+        printf("squares_table[7] = %d\n", squares[7]);
+    }
+
     {
         try_preload_runtime_t try_preload = (try_preload_runtime_t)get_export(mod, "try_preload_runtime");
         RETURN_FAIL_IF_FALSE(try_preload, "Failed to get try_preload_runtime export\n");
@@ -105,6 +143,11 @@ int main(int ac, char** av)
         c = fptr(a, b);
         printf("IntIntInt(%d, %d) = %d\n", a, b, c);
 
+        // After a preload, an export bound eagerly is the managed function for both lookups.
+        dnne_find_export_t find_export = (dnne_find_export_t)get_export(mod, "dnne_find_export");
+        RETURN_FAIL_IF_FALSE(find_export, "Failed to get dnne_find_export export\n");
+        RETURN_FAIL_IF_FALSE(find_export("IntIntInt", NULL) == (void*)fptr, "dnne_find_export returned a different address for IntIntInt\n");
+
         fptr = (IntIntInt_t)get_export(mod, "UnmanagedIntIntInt");
         RETURN_FAIL_IF_FALSE(fptr, "Failed to get UnmanagedIntIntInt export\n");
 
@@ -136,5 +179,124 @@ int main(int ac, char** av)
         printf("ReturnRefDataCMember(struct T*{ %d }) = %d\n", expected, c);
     }
 
+    {
+        vector_add_ps_t fptr = (vector_add_ps_t)get_export(mod, "vector_add_ps");
+        RETURN_FAIL_IF_FALSE(fptr, "Failed to get vector_add_ps export\n");
+
+        m128_f32 a = { 0 }, b = { 0 }, r;
+        for (int i = 0; i < 4; ++i)
+        {
+            a.f[i] = (float)i;
+            b.f[i] = (float)(10 * i);
+        }
+
+        r.v = fptr(a.v, b.v);
+        for (int i = 0; i < 4; ++i)
+            RETURN_FAIL_IF_FALSE(r.f[i] == (float)(11 * i), "vector_add_ps returned an incorrect value\n");
+        printf("vector_add_ps() = { %g, %g, %g, %g }\n", r.f[0], r.f[1], r.f[2], r.f[3]);
+    }
+
+    {
+        vector_add_pd_t fptr = (vector_add_pd_t)get_export(mod, "vector_add_pd");
+        RETURN_FAIL_IF_FALSE(fptr, "Failed to get vector_add_pd export\n");
+
+        m256_f64 a = { 0 }, b = { 0 }, r;
+        for (int i = 0; i < 4; ++i)
+        {
+            a.d[i] = 0.5 * i;
+            b.d[i] = 100.0 * i;
+        }
+
+        r.v = fptr(a.v, b.v);
+        for (int i = 0; i < 4; ++i)
+            RETURN_FAIL_IF_FALSE(r.d[i] == 100.5 * i, "vector_add_pd returned an incorrect value\n");
+        printf("vector_add_pd() = { %g, %g, %g, %g }\n", r.d[0], r.d[1], r.d[2], r.d[3]);
+    }
+
+    {
+        vector_mix_t fptr = (vector_mix_t)get_export(mod, "vector_mix");
+        RETURN_FAIL_IF_FALSE(fptr, "Failed to get vector_mix export\n");
+
+        m128_i32 a = { 0 }, c = { 0 }, r;
+        m128_f64 b = { 0 };
+        for (int i = 0; i < 4; ++i)
+        {
+            a.i[i] = i + 1;
+            c.i[i] = 1000 * (i + 1);
+        }
+        b.d[0] = 40.0;
+        b.d[1] = 80.0;
+
+        // Scalars between the vectors must not shift the vector registers.
+        r.v = fptr(a.v, 3, b.v, 2.0f, c.v);
+        RETURN_FAIL_IF_FALSE(r.i[0] == 1045 && r.i[1] == 2088 && r.i[2] == 3009 && r.i[3] == 4012,
+            "vector_mix returned an incorrect value\n");
+        printf("vector_mix() = { %d, %d, %d, %d }\n", r.i[0], r.i[1], r.i[2], r.i[3]);
+    }
+
+    {
+        vector_sum_ps_t fptr = (vector_sum_ps_t)get_export(mod, "vector_sum_ps");
+        RETURN_FAIL_IF_FALSE(fptr, "Failed to get vector_sum_ps export\n");
+
+        m128_f32 a = { 0 };
+        for (int i = 0; i < 4; ++i)
+            a.f[i] = 1.5f * (i + 1);
+
+        float sum = fptr(a.v);
+        RETURN_FAIL_IF_FALSE(sum == 15.0f, "vector_sum_ps returned an incorrect value\n");
+        printf("vector_sum_ps() = %g\n", sum);
+    }
+
+    {
+        dnne_command_buffer_create_t create = (dnne_command_buffer_create_t)get_export(mod, "dnne_command_buffer_create");
+        RETURN_FAIL_IF_FALSE(create, "Failed to get dnne_command_buffer_create export\n");
+        dnne_command_buffer_destroy_t destroy = (dnne_command_buffer_destroy_t)get_export(mod, "dnne_command_buffer_destroy");
+        RETURN_FAIL_IF_FALSE(destroy, "Failed to get dnne_command_buffer_destroy export\n");
+        dnne_submit_t submit = (dnne_submit_t)get_export(mod, "dnne_submit");
+        RETURN_FAIL_IF_FALSE(submit, "Failed to get dnne_submit export\n");
+        ScaleBy_record_t record = (ScaleBy_record_t)get_export(mod, "ScaleBy_record");
+        RETURN_FAIL_IF_FALSE(record, "Failed to get ScaleBy_record export\n");
+
+        dnne_command_buffer* buffer = create(0);
+        RETURN_FAIL_IF_FALSE(buffer, "dnne_command_buffer_create failed\n");
+
+        double results[8];
+        for (int i = 0; i < 8; ++i)
+            RETURN_FAIL_IF_FALSE(record(buffer, (float)i, 0.5, 2, &results[i]) == DNNE_SUCCESS, "ScaleBy_record failed\n");
+
+        RETURN_FAIL_IF_FALSE(submit(buffer) == DNNE_SUCCESS, "dnne_submit failed\n");
+        for (int i = 0; i < 8; ++i)
+            RETURN_FAIL_IF_FALSE(results[i] == 2.0 * i, "ScaleBy returned an incorrect value\n");
+        printf("ScaleBy() x 8 = { %g, ..., %g }\n", results[0], results[7]);
+        destroy(buffer);
+    }
+
+#ifdef __linux__
+    {
+        dnne_completion_init_event_t init_event = (dnne_completion_init_event_t)get_export(mod, "dnne_completion_init_event");
+        RETURN_FAIL_IF_FALSE(init_event, "Failed to get dnne_completion_init_event export\n");
+        DelayedAdd_begin_t begin = (DelayedAdd_begin_t)get_export(mod, "DelayedAdd_begin");
+        RETURN_FAIL_IF_FALSE(begin, "Failed to get DelayedAdd_begin export\n");
+        DelayedAdd_end_t end = (DelayedAdd_end_t)get_export(mod, "DelayedAdd_end");
+        RETURN_FAIL_IF_FALSE(end, "Failed to get DelayedAdd_end export\n");
+
+        int fd = eventfd(0, EFD_CLOEXEC);
+        RETURN_FAIL_IF_FALSE(fd >= 0, "eventfd failed\n");
+
+        // The event can be waited on with poll or epoll alongside other I/O.
+        struct dnne_completion completion;
+        init_event(&completion, fd);
+        RETURN_FAIL_IF_FALSE(begin(3, 5, 10, &completion) == DNNE_SUCCESS, "DelayedAdd_begin failed\n");
+
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        RETURN_FAIL_IF_FALSE(poll(&pfd, 1, 30000) == 1, "DelayedAdd completion wasn't signaled\n");
+
+        int sum = -1;
+        RETURN_FAIL_IF_FALSE(end(&completion, &sum) == DNNE_SUCCESS && sum == 8, "DelayedAdd_end returned an incorrect value\n");
+        printf("DelayedAdd(3, 5) = %d\n", sum);
+        close(fd);
+    }
+#endif
+
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,126 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Calls exports marked with DNNE.RemoteExportAttribute from several processes.
+//
+// Run against a binary built with 'DnneOutOfProcess' (Linux only). Each process
+// starts a copy of this program, which checks the exports run in the same server
+// process, and that an exception thrown by an export is reported to the caller
+// while the server keeps running.
+//
+// Usage: RemoteProcess <export_binary>
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <dlfcn.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <dnne.h>
+
+typedef int (DNNE_CALLTYPE* RemoteAdd_t)(int, int);
+typedef int (DNNE_CALLTYPE* remote_process_id_t)(void);
+typedef int (DNNE_CALLTYPE* RemoteCheckedDivide_t)(int, int);
+typedef void (DNNE_CALLTYPE* set_failure_callback_t)(failure_fn cb);
+
+extern char** environ;
+
+// HRESULT of System.DivideByZeroException.
+#define COR_E_DIVIDEBYZERO ((int)0x80020012)
+
+// Exit code of a process whose exception was reported as expected.
+#define REPORTED_EXIT_CODE 42
+
+#define RETURN_FAIL_IF_FALSE(exp, msg) { if (!(exp)) { printf(msg); return EXIT_FAILURE; } }
+
+static void DNNE_CALLTYPE on_failure(enum failure_type type, int error_code)
+{
+    printf("FAILURE: Type: %d, Error code: %08x\n", type, error_code);
+    fflush(stdout);
+    _exit((type == failure_remote_export && error_code == COR_E_DIVIDEBYZERO) ? REPORTED_EXIT_CODE : EXIT_FAILURE);
+}
+
+// Runs this program with the mode and returns its exit code.
+static int run_process(const char* self, const char* binary, const char* mode, const char* server)
+{
+    char* argv[] = { (char*)self, (char*)binary, (char*)mode, (char*)server, NULL };
+    pid_t pid;
+    if (posix_spawn(&pid, self, NULL, NULL, argv, environ) != 0)
+        return -1;
+
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+        return -1;
+
+    return WEXITSTATUS(status);
+}
+
+int main(int ac, char** av)
+{
+    if (ac != 2 && ac != 4)
+    {
+        printf("Usage: %s <export_binary>\n", av[0]);
+        return EXIT_FAILURE;
+    }
+
+    void* mod = dlopen(av[1], RTLD_LAZY | RTLD_LOCAL);
+    RETURN_FAIL_IF_FALSE(mod, "Failed to load library\n");
+
+    set_failure_callback_t set_cb = (set_failure_callback_t)dlsym(mod, "set_failure_callback");
+    RemoteAdd_t add = (RemoteAdd_t)dlsym(mod, "RemoteAdd");
+    remote_process_id_t process_id = (remote_process_id_t)dlsym(mod, "remote_process_id");
+    RemoteCheckedDivide_t divide = (RemoteCheckedDivide_t)dlsym(mod, "RemoteCheckedDivide");
+    RETURN_FAIL_IF_FALSE(set_cb && add && process_id && divide, "Failed to get exports\n");
+    set_cb(on_failure);
+
+    int server = process_id();
+    RETURN_FAIL_IF_FALSE(server != (int)getpid(), "Export ran in the calling process\n");
+    RETURN_FAIL_IF_FALSE(add(3, 5) == 8, "RemoteAdd returned an incorrect value\n");
+
+    if (ac == 4)
+    {
+        RETURN_FAIL_IF_FALSE(server == atoi(av[3]), "Export ran in another server process\n");
+        if (strcmp(av[2], "throw") == 0)
+        {
+            (void)divide(1, 0);
+            printf("RemoteCheckedDivide didn't report the exception\n");
+            return EXIT_FAILURE;
+        }
+
+        return EXIT_SUCCESS;
+    }
+
+    char server_arg[16];
+    snprintf(server_arg, sizeof(server_arg), "%d", server);
+
+    RETURN_FAIL_IF_FALSE(run_process(av[0], av[1], "call", server_arg) == EXIT_SUCCESS, "Call from another process failed\n");
+    RETURN_FAIL_IF_FALSE(run_process(av[0], av[1], "throw", server_arg) == REPORTED_EXIT_CODE, "Exception wasn't reported to the calling process\n");
+
+    // The server survives the exception.
+    RETURN_FAIL_IF_FALSE(process_id() == server, "Server didn't keep running\n");
+    RETURN_FAIL_IF_FALSE(divide(6, 3) == 2, "RemoteCheckedDivide returned an incorrect value\n");
+
+    printf("Remote exports ran in server process %d\n", server);
+    return EXIT_SUCCESS;
+}
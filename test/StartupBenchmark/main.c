@@ -0,0 +1,236 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Measures the cold-start cost and resident memory of a DNNE export binary.
+//
+// Each iteration runs in a new process so the runtime is always activated from
+// scratch. Compare a framework-dependent build against a self-contained (and
+// optionally trimmed) publish of the same assembly. See the readme for details.
+//
+// Usage: StartupBenchmark <export_binary> [iterations]
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <dnne.h>
+
+#define CHILD_FLAG "--child"
+
+#ifdef _WIN32
+#include <Windows.h>
+#include <psapi.h>
+
+#define popen _popen
+#define pclose _pclose
+
+// The command processor removes the outer quotes.
+#define CHILD_COMMAND_FORMAT "\"\"%s\" " CHILD_FLAG " \"%s\"\""
+
+static void* load_library(const char* path)
+{
+    HMODULE h = LoadLibraryA(path);
+    return (void*)h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = GetProcAddress((HMODULE)h, name);
+    return f;
+}
+static double now_us(void)
+{
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart * 1e6 / (double)freq.QuadPart;
+}
+static long peak_rss_kb(void)
+{
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return -1;
+    return (long)(counters.PeakWorkingSetSize / 1024);
+}
+
+#else
+#include <dlfcn.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#define CHILD_COMMAND_FORMAT "\"%s\" " CHILD_FLAG " \"%s\""
+
+static void* load_library(const char* path)
+{
+    void* h = dlopen(path, RTLD_LAZY | RTLD_LOCAL);
+    return h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = dlsym(h, name);
+    return f;
+}
+static double now_us(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+static long peak_rss_kb(void)
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef __APPLE__
+    return (long)(usage.ru_maxrss / 1024);
+#else
+    return (long)usage.ru_maxrss;
+#endif
+}
+
+#endif
+
+typedef int (DNNE_CALLTYPE* try_preload_runtime_t)(void);
+typedef int (DNNE_CALLTYPE* IntIntInt_t)(int, int);
+
+#define MAX_ITERATIONS 1000
+
+struct sample
+{
+    double load_us;
+    double runtime_us;
+    double first_call_us;
+    long peak_rss_kb;
+};
+
+// Measure a single cold start and write the sample to stdout.
+static int run_child(const char* path)
+{
+    double start = now_us();
+    void* mod = load_library(path);
+    if (mod == NULL)
+    {
+        fprintf(stderr, "Failed to load library\n");
+        return EXIT_FAILURE;
+    }
+
+    try_preload_runtime_t try_preload = (try_preload_runtime_t)get_export(mod, "try_preload_runtime");
+    IntIntInt_t fptr = (IntIntInt_t)get_export(mod, "IntIntInt");
+    if (try_preload == NULL || fptr == NULL)
+    {
+        fprintf(stderr, "Failed to get exports\n");
+        return EXIT_FAILURE;
+    }
+
+    double loaded = now_us();
+    int rc = try_preload();
+    if (rc != DNNE_SUCCESS)
+    {
+        fprintf(stderr, "Failed to load runtime: %08x\n", rc);
+        return EXIT_FAILURE;
+    }
+
+    double runtime = now_us();
+    (void)fptr(3, 5);
+    double called = now_us();
+
+    printf("%f %f %f %ld\n", loaded - start, runtime - loaded, called - runtime, peak_rss_kb());
+    return EXIT_SUCCESS;
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    double l = *(const double*)a;
+    double r = *(const double*)b;
+    return (l > r) - (l < r);
+}
+
+static void report(const char* name, double* values, int count)
+{
+    qsort(values, count, sizeof(double), compare_double);
+    printf("%-16s min %12.1f  median %12.1f  max %12.1f\n", name, values[0], values[count / 2], values[count - 1]);
+}
+
+int main(int ac, char** av)
+{
+    if (ac == 3 && strcmp(av[1], CHILD_FLAG) == 0)
+        return run_child(av[2]);
+
+    if (ac < 2 || ac > 3)
+    {
+        printf("Usage: %s <export_binary> [iterations]\n", av[0]);
+        return EXIT_FAILURE;
+    }
+
+    int iterations = (ac == 3) ? atoi(av[2]) : 10;
+    if (iterations <= 0 || iterations > MAX_ITERATIONS)
+    {
+        printf("Iterations must be between 1 and %d\n", MAX_ITERATIONS);
+        return EXIT_FAILURE;
+    }
+
+    char command[4096];
+    int len = snprintf(command, sizeof(command), CHILD_COMMAND_FORMAT, av[0], av[1]);
+    if (len < 0 || (size_t)len >= sizeof(command))
+    {
+        printf("Command line is too long\n");
+        return EXIT_FAILURE;
+    }
+
+    static double load[MAX_ITERATIONS];
+    static double runtime[MAX_ITERATIONS];
+    static double first_call[MAX_ITERATIONS];
+    static double total[MAX_ITERATIONS];
+    static double rss[MAX_ITERATIONS];
+    for (int i = 0; i < iterations; ++i)
+    {
+        FILE* child = popen(command, "r");
+        if (child == NULL)
+        {
+            printf("Failed to start iteration %d\n", i);
+            return EXIT_FAILURE;
+        }
+
+        struct sample s;
+        int read = fscanf(child, "%lf %lf %lf %ld", &s.load_us, &s.runtime_us, &s.first_call_us, &s.peak_rss_kb);
+        if (pclose(child) != 0 || read != 4)
+        {
+            printf("Iteration %d failed\n", i);
+            return EXIT_FAILURE;
+        }
+
+        load[i] = s.load_us;
+        runtime[i] = s.runtime_us;
+        first_call[i] = s.first_call_us;
+        total[i] = s.load_us + s.runtime_us + s.first_call_us;
+        rss[i] = (double)s.peak_rss_kb;
+    }
+
+    printf("%s (%d iterations)\n", av[1], iterations);
+    printf("Time in microseconds\n");
+    report("Load binary", load, iterations);
+    report("Load runtime", runtime, iterations);
+    report("First call", first_call, iterations);
+    report("Total", total, iterations);
+    printf("Memory in KB\n");
+    report("Peak RSS", rss, iterations);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,265 @@
+// Copyright 2026 Aaron R Robinson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is furnished
+// to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+// INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A
+// PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+// HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+// OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+// Measures the latency of the first export call on fresh threads.
+//
+// Each thread is created, optionally prepared with dnne_prepare_current_thread(),
+// and then calls an export twice. The first call on an unprepared thread attaches
+// the thread to the runtime, which is the spike a native thread pool sees as it
+// grows. See the readme for details.
+//
+// Usage: ThreadAttachBenchmark <export_binary> [threads]
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <dnne.h>
+
+typedef int (DNNE_CALLTYPE* IntIntInt_t)(int, int);
+typedef int (DNNE_CALLTYPE* current_thread_t)(void);
+
+struct thread_times
+{
+    double prepare;
+    double first_call;
+    double second_call;
+};
+
+static void run_thread(struct thread_times* times);
+
+#ifdef _WIN32
+#include <Windows.h>
+
+static void* load_library(const char* path)
+{
+    HMODULE h = LoadLibraryA(path);
+    return (void*)h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = GetProcAddress((HMODULE)h, name);
+    return f;
+}
+static double now_ns(void)
+{
+    LARGE_INTEGER freq;
+    LARGE_INTEGER count;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&count);
+    return (double)count.QuadPart * 1e9 / (double)freq.QuadPart;
+}
+
+static DWORD WINAPI thread_start(void* arg)
+{
+    run_thread((struct thread_times*)arg);
+    return 0;
+}
+static int run_on_new_thread(struct thread_times* times)
+{
+    HANDLE h = CreateThread(NULL, 0, thread_start, times, 0, NULL);
+    if (h == NULL)
+        return -1;
+
+    WaitForSingleObject(h, INFINITE);
+    CloseHandle(h);
+    return 0;
+}
+
+#else
+#include <dlfcn.h>
+#include <pthread.h>
+#include <time.h>
+
+static void* load_library(const char* path)
+{
+    void* h = dlopen(path, RTLD_LAZY | RTLD_LOCAL);
+    return h;
+}
+static void* get_export(void* h, const char* name)
+{
+    void* f = dlsym(h, name);
+    return f;
+}
+static double now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void* thread_start(void* arg)
+{
+    run_thread((struct thread_times*)arg);
+    return NULL;
+}
+static int run_on_new_thread(struct thread_times* times)
+{
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, thread_start, times) != 0)
+        return -1;
+
+    (void)pthread_join(thread, NULL);
+    return 0;
+}
+
+#endif
+
+static IntIntInt_t export_fptr;
+static current_thread_t prepare_fptr;
+static current_thread_t release_fptr;
+
+// Threads run one at a time so each measures the cost of its own attach.
+static void run_thread(struct thread_times* times)
+{
+    volatile int sink = 0;
+    double start = now_ns();
+    if (prepare_fptr != NULL && prepare_fptr() != DNNE_SUCCESS)
+        printf("Failed to prepare thread\n");
+
+    double prepared = now_ns();
+    sink += export_fptr(3, 5);
+    double first = now_ns();
+    sink += export_fptr(3, 5);
+    double second = now_ns();
+
+    if (release_fptr != NULL)
+        (void)release_fptr();
+
+    (void)sink;
+    times->prepare = prepared - start;
+    times->first_call = first - prepared;
+    times->second_call = second - first;
+}
+
+static int compare_double(const void* a, const void* b)
+{
+    double l = *(const double*)a;
+    double r = *(const double*)b;
+    return (l > r) - (l < r);
+}
+
+static void report(const char* name, double* values, int count)
+{
+    qsort(values, count, sizeof(double), compare_double);
+    printf("%-24s min %8.1f  median %8.1f  p99 %8.1f  max %8.1f\n",
+        name, values[0] / 1e3, values[count / 2] / 1e3, values[(count * 99) / 100] / 1e3, values[count - 1] / 1e3);
+}
+
+static void report_times(const char* name, struct thread_times* times, int count, int prepared)
+{
+    double* values = (double*)malloc(sizeof(double) * count);
+    if (values == NULL)
+        return;
+
+    printf("%s\n", name);
+    if (prepared)
+    {
+        for (int i = 0; i < count; ++i)
+            values[i] = times[i].prepare;
+        report("  Prepare", values, count);
+    }
+
+    for (int i = 0; i < count; ++i)
+        values[i] = times[i].first_call;
+    report("  First call", values, count);
+    for (int i = 0; i < count; ++i)
+        values[i] = times[i].second_call;
+    report("  Second call", values, count);
+    free(values);
+}
+
+int main(int ac, char** av)
+{
+    if (ac < 2 || ac > 3)
+    {
+        printf("Usage: %s <export_binary> [threads]\n", av[0]);
+        return EXIT_FAILURE;
+    }
+
+    int threads = (ac == 3) ? atoi(av[2]) : 200;
+    if (threads <= 0)
+    {
+        printf("Threads must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    void* mod = load_library(av[1]);
+    if (mod == NULL)
+    {
+        printf("Failed to load library\n");
+        return EXIT_FAILURE;
+    }
+
+    export_fptr = (IntIntInt_t)get_export(mod, "UnmanagedIntIntInt");
+    current_thread_t prepare = (current_thread_t)get_export(mod, "dnne_prepare_current_thread");
+    current_thread_t release = (current_thread_t)get_export(mod, "dnne_release_current_thread");
+    if (export_fptr == NULL || prepare == NULL || release == NULL)
+    {
+        printf("Failed to get exports\n");
+        return EXIT_FAILURE;
+    }
+
+    // Load the runtime and resolve the export and the helpers up front,
+    // so only the cost of attaching each thread is measured.
+    (void)export_fptr(3, 5);
+    if (prepare() != DNNE_SUCCESS)
+    {
+        printf("Failed to prepare thread\n");
+        return EXIT_FAILURE;
+    }
+
+    struct thread_times* cold = (struct thread_times*)malloc(sizeof(struct thread_times) * threads);
+    struct thread_times* prepared = (struct thread_times*)malloc(sizeof(struct thread_times) * threads);
+    if (cold == NULL || prepared == NULL)
+    {
+        printf("Out of memory\n");
+        return EXIT_FAILURE;
+    }
+
+    // Alternate between cold and prepared threads so both see the same conditions.
+    for (int i = 0; i < threads; ++i)
+    {
+        prepare_fptr = NULL;
+        release_fptr = NULL;
+        if (run_on_new_thread(&cold[i]) != 0)
+        {
+            printf("Failed to create thread\n");
+            return EXIT_FAILURE;
+        }
+
+        prepare_fptr = prepare;
+        release_fptr = release;
+        if (run_on_new_thread(&prepared[i]) != 0)
+        {
+            printf("Failed to create thread\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%s (%d threads each)\n", av[1], threads);
+    printf("Time in microseconds\n");
+    report_times("Cold thread", cold, threads, 0);
+    report_times("Prepared thread", prepared, threads, 1);
+
+    free(prepared);
+    free(cold);
+    return EXIT_SUCCESS;
+}